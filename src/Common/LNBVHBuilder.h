@@ -0,0 +1,281 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <thread>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	namespace LNBVHBuilder
+	{
+		const int BinCount = 16;
+		const int ParallelBuildThreshold = 32768;
+
+		struct Bounds
+		{
+			double Min[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+			double Max[3] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+
+			void Grow(const double* minimum, const double* maximum)
+			{
+				for (int i = 0; i < 3; i++) {
+					Min[i] = std::min(Min[i], minimum[i]);
+					Max[i] = std::max(Max[i], maximum[i]);
+				}
+			}
+
+			void Grow(const double* point)
+			{
+				Grow(point, point);
+			}
+
+			void Grow(const Bounds& other)
+			{
+				Grow(other.Min, other.Max);
+			}
+
+			double HalfArea() const
+			{
+				double dx = Max[0] - Min[0];
+				double dy = Max[1] - Min[1];
+				double dz = Max[2] - Min[2];
+				if (dx < 0 || dy < 0 || dz < 0) {
+					return 0.0;
+				}
+				return dx * dy + dy * dz + dz * dx;
+			}
+		};
+
+		/// <summary>
+		/// Box and centroid of one primitive to be indexed.
+		/// </summary>
+		struct Primitive
+		{
+			Bounds Box;
+			double Centroid[3];
+		};
+
+		/// <summary>
+		/// Float not above value, pushed out slightly further so float boxes stay conservative.
+		/// </summary>
+		inline float RoundDown(double value)
+		{
+			float result = static_cast<float>(value);
+			if (static_cast<double>(result) > value) {
+				result = std::nextafter(result, -std::numeric_limits<float>::infinity());
+			}
+			return result - std::fabs(result) * 1E-6f;
+		}
+
+		/// <summary>
+		/// Float not below value, pushed out slightly further so float boxes stay conservative.
+		/// </summary>
+		inline float RoundUp(double value)
+		{
+			float result = static_cast<float>(value);
+			if (static_cast<double>(result) < value) {
+				result = std::nextafter(result, std::numeric_limits<float>::infinity());
+			}
+			return result + std::fabs(result) * 1E-6f;
+		}
+
+		/// <summary>
+		/// Robust BVH Ray Traversal (Ize 2013): with exact origins and rounded inverse directions,
+		/// scaling the exit parameter by 1 + 2 * gamma(3) keeps the slab test conservative.
+		/// </summary>
+		const double ExitScale = 1.0 + 6.0 * std::numeric_limits<double>::epsilon();
+
+		inline void SetBounds(const Bounds& box, float* minimum, float* maximum)
+		{
+			for (int i = 0; i < 3; i++) {
+				minimum[i] = RoundDown(box.Min[i]);
+				maximum[i] = RoundUp(box.Max[i]);
+			}
+		}
+
+		inline void SetBounds(const Bounds& box, double* minimum, double* maximum)
+		{
+			std::copy(box.Min, box.Min + 3, minimum);
+			std::copy(box.Max, box.Max + 3, maximum);
+		}
+
+		/// <summary>
+		/// Depth down to which subtrees are built on their own threads, enough to occupy every hardware thread.
+		/// </summary>
+		inline int GetParallelDepth()
+		{
+			int depth = 0;
+			while ((1u << depth) < std::max(1u, std::thread::hardware_concurrency())) {
+				depth++;
+			}
+			return depth;
+		}
+
+		/// <summary>
+		/// Binned SAH build of a depth-first hierarchy over primitives. Indices are reordered so that every leaf
+		/// covers indices [Offset, Offset + Count). NodeType needs Min[3] and Max[3] (float boxes are rounded outward),
+		/// Offset and Count. Interior nodes have Count zero, the left child follows them and the right child is Offset nodes further.
+		/// Subtrees of at least ParallelBuildThreshold primitives are built on their own threads down to parallelDepth.
+		/// </summary>
+		template <typename NodeType>
+		class Builder
+		{
+		public:
+
+			Builder(const std::vector<Primitive>& primitives, std::vector<int>& indices, int maxLeafSize, int parallelDepth = 0) :
+				_primitives(primitives), _indices(indices), _maxLeafSize(std::max(1, maxLeafSize)), _parallelDepth(parallelDepth) {}
+
+			void Build(int begin, int end, int depth, std::vector<NodeType>& nodes)
+			{
+				Bounds box;
+				Bounds centroidBox;
+				for (int i = begin; i < end; i++) {
+					const Primitive& primitive = _primitives[_indices[i]];
+					box.Grow(primitive.Box);
+					centroidBox.Grow(primitive.Centroid);
+				}
+
+				NodeType node;
+				SetBounds(box, node.Min, node.Max);
+
+				int count = end - begin;
+				int middle = count <= _maxLeafSize ? -1 : Split(begin, end, box, centroidBox);
+				if (middle < 0) {
+					node.Offset = static_cast<uint32_t>(begin);
+					node.Count = static_cast<uint32_t>(count);
+					nodes.emplace_back(node);
+					return;
+				}
+
+				node.Count = 0;
+				if (count >= ParallelBuildThreshold && depth < _parallelDepth) {
+					std::vector<NodeType> left;
+					std::vector<NodeType> right;
+					std::exception_ptr error;
+					std::thread worker([&]() {
+						try {
+							Build(begin, middle, depth + 1, left);
+						}
+						catch (...) {
+							error = std::current_exception();
+						}
+					});
+					Build(middle, end, depth + 1, right);
+					worker.join();
+					if (error) {
+						std::rethrow_exception(error);
+					}
+
+					node.Offset = static_cast<uint32_t>(1 + left.size());
+					nodes.reserve(nodes.size() + 1 + left.size() + right.size());
+					nodes.emplace_back(node);
+					nodes.insert(nodes.end(), left.begin(), left.end());
+					nodes.insert(nodes.end(), right.begin(), right.end());
+					return;
+				}
+
+				size_t nodeIndex = nodes.size();
+				nodes.emplace_back(node);
+				Build(begin, middle, depth + 1, nodes);
+				nodes[nodeIndex].Offset = static_cast<uint32_t>(nodes.size() - nodeIndex);
+				Build(middle, end, depth + 1, nodes);
+			}
+
+		private:
+
+			/// <summary>
+			/// Return split position, or -1 when a leaf is cheaper.
+			/// </summary>
+			int Split(int begin, int end, const Bounds& box, const Bounds& centroidBox)
+			{
+				int count = end - begin;
+				int bestAxis = -1;
+				int bestBin = 0;
+				double bestCost = std::numeric_limits<double>::max();
+
+				for (int axis = 0; axis < 3; axis++) {
+					double extent = centroidBox.Max[axis] - centroidBox.Min[axis];
+					if (!(extent > 0.0)) {
+						continue;
+					}
+					double scale = BinCount / extent;
+
+					Bounds bins[BinCount];
+					int counts[BinCount] = {};
+					for (int i = begin; i < end; i++) {
+						const Primitive& primitive = _primitives[_indices[i]];
+						int bin = std::min(BinCount - 1, static_cast<int>((primitive.Centroid[axis] - centroidBox.Min[axis]) * scale));
+						counts[bin]++;
+						bins[bin].Grow(primitive.Box);
+					}
+
+					double rightAreas[BinCount];
+					int rightCounts[BinCount];
+					Bounds accumulated;
+					int accumulatedCount = 0;
+					for (int i = BinCount - 1; i > 0; i--) {
+						accumulated.Grow(bins[i]);
+						accumulatedCount += counts[i];
+						rightAreas[i] = accumulated.HalfArea();
+						rightCounts[i] = accumulatedCount;
+					}
+
+					accumulated = Bounds();
+					accumulatedCount = 0;
+					for (int i = 0; i < BinCount - 1; i++) {
+						accumulated.Grow(bins[i]);
+						accumulatedCount += counts[i];
+						if (accumulatedCount == 0 || rightCounts[i + 1] == 0) {
+							continue;
+						}
+						double cost = accumulated.HalfArea() * accumulatedCount + rightAreas[i + 1] * rightCounts[i + 1];
+						if (cost < bestCost) {
+							bestCost = cost;
+							bestAxis = axis;
+							bestBin = i + 1;
+						}
+					}
+				}
+
+				double area = box.HalfArea();
+				double leafCost = static_cast<double>(count);
+				bool isLeafCheaper = bestAxis < 0 || (area > 0.0 && 1.0 + bestCost / area >= leafCost);
+				if (isLeafCheaper && count <= 4 * _maxLeafSize) {
+					return -1;
+				}
+
+				int* first = _indices.data() + begin;
+				int* last = _indices.data() + end;
+				if (bestAxis < 0) {
+					return begin + count / 2;
+				}
+
+				double scale = BinCount / (centroidBox.Max[bestAxis] - centroidBox.Min[bestAxis]);
+				double minimum = centroidBox.Min[bestAxis];
+				int* middle = std::partition(first, last, [&](int index) {
+					int bin = std::min(BinCount - 1, static_cast<int>((_primitives[index].Centroid[bestAxis] - minimum) * scale));
+					return bin < bestBin;
+				});
+				return static_cast<int>(middle - _indices.data());
+			}
+
+			const std::vector<Primitive>& _primitives;
+			std::vector<int>& _indices;
+			int _maxLeafSize;
+			int _parallelDepth;
+		};
+	}
+}
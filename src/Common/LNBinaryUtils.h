@@ -0,0 +1,73 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#pragma once
+
+namespace LNLibEx
+{
+	namespace LNBinaryUtils
+	{
+		/// <summary>
+		/// Native binary files are written little-endian without byte swapping,
+		/// so save and load are refused on big-endian hosts.
+		/// </summary>
+		inline bool IsLittleEndian()
+		{
+			const uint16_t probe = 1;
+			unsigned char first = 0;
+			std::memcpy(&first, &probe, 1);
+			return first == 1;
+		}
+
+		inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		inline uint64_t RotateLeft(uint64_t value, int bits)
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		/// <summary>
+		/// 64-bit checksum over four independent lanes so that
+		/// validating a mapped file runs close to memory bandwidth.
+		/// </summary>
+		inline uint64_t Checksum64(const void* data, size_t size)
+		{
+			const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+			const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+			uint64_t lanes[4] = { prime1, prime2, ~prime1, ~prime2 };
+			size_t offset = 0;
+			for (; offset + 32 <= size; offset += 32) {
+				for (int i = 0; i < 4; i++) {
+					uint64_t word;
+					std::memcpy(&word, bytes + offset + 8 * i, 8);
+					lanes[i] = RotateLeft(lanes[i] + word * prime2, 31) * prime1;
+				}
+			}
+
+			uint64_t hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+			for (; offset < size; offset++) {
+				hash = RotateLeft(hash ^ (bytes[offset] * prime1), 11) * prime2;
+			}
+			hash ^= static_cast<uint64_t>(size);
+			hash ^= hash >> 33;
+			hash *= prime2;
+			hash ^= hash >> 29;
+			return hash;
+		}
+	}
+}
@@ -0,0 +1,131 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <string>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Read-only memory mapping of a whole file.
+	/// The mapped bytes stay valid until Close() or destruction.
+	/// </summary>
+	class LNMappedFile
+	{
+	public:
+
+		LNMappedFile() = default;
+		LNMappedFile(const LNMappedFile&) = delete;
+		LNMappedFile& operator=(const LNMappedFile&) = delete;
+		~LNMappedFile() { Close(); }
+
+		bool Open(const std::string& filePath)
+		{
+			Close();
+#if defined(_WIN32)
+			_file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (_file == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(_file, &fileSize) || fileSize.QuadPart == 0) {
+				Close();
+				return false;
+			}
+			_mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (_mapping == NULL) {
+				Close();
+				return false;
+			}
+			_data = static_cast<const unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+			if (_data == nullptr) {
+				Close();
+				return false;
+			}
+			_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+			_file = open(filePath.c_str(), O_RDONLY);
+			if (_file < 0) {
+				return false;
+			}
+			struct stat status;
+			if (fstat(_file, &status) != 0 || status.st_size == 0) {
+				Close();
+				return false;
+			}
+			void* address = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, _file, 0);
+			if (address == MAP_FAILED) {
+				Close();
+				return false;
+			}
+			_data = static_cast<const unsigned char*>(address);
+			_size = static_cast<size_t>(status.st_size);
+#endif
+			return true;
+		}
+
+		void Close()
+		{
+#if defined(_WIN32)
+			if (_data != nullptr) {
+				UnmapViewOfFile(_data);
+			}
+			if (_mapping != NULL) {
+				CloseHandle(_mapping);
+			}
+			if (_file != INVALID_HANDLE_VALUE) {
+				CloseHandle(_file);
+			}
+			_mapping = NULL;
+			_file = INVALID_HANDLE_VALUE;
+#else
+			if (_data != nullptr) {
+				munmap(const_cast<unsigned char*>(_data), _size);
+			}
+			if (_file >= 0) {
+				close(_file);
+			}
+			_file = -1;
+#endif
+			_data = nullptr;
+			_size = 0;
+		}
+
+		const unsigned char* Data() const { return _data; }
+		size_t Size() const { return _size; }
+
+	private:
+
+#if defined(_WIN32)
+		HANDLE _file = INVALID_HANDLE_VALUE;
+		HANDLE _mapping = NULL;
+#else
+		int _file = -1;
+#endif
+		const unsigned char* _data = nullptr;
+		size_t _size = 0;
+	};
+}
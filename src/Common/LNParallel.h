@@ -0,0 +1,116 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	namespace LNParallel
+	{
+		/// <summary>
+		/// Number of contiguous chunks [begin, end) is split into,
+		/// bounded by hardware threads and at least grain items per chunk.
+		/// </summary>
+		inline int GetChunkCount(int64_t begin, int64_t end, int64_t grain = 1024)
+		{
+			if (end <= begin) {
+				return 0;
+			}
+			int64_t threads = std::max<int64_t>(1, std::thread::hardware_concurrency());
+			int64_t chunks = (end - begin + grain - 1) / std::max<int64_t>(1, grain);
+			return static_cast<int>(std::max<int64_t>(1, std::min(threads, chunks)));
+		}
+
+		/// <summary>
+		/// Call function(chunkIndex, chunkBegin, chunkEnd) for every chunk given by GetChunkCount,
+		/// one thread per chunk. The first exception thrown by any chunk is rethrown to the caller.
+		/// </summary>
+		template <typename Function>
+		void ForEachChunk(int64_t begin, int64_t end, int64_t grain, Function&& function)
+		{
+			int chunks = GetChunkCount(begin, end, grain);
+			if (chunks == 0) {
+				return;
+			}
+			int64_t size = end - begin;
+			auto chunkBegin = [&](int chunk) { return begin + size * chunk / chunks; };
+			if (chunks == 1) {
+				function(0, begin, end);
+				return;
+			}
+
+			std::exception_ptr error;
+			std::mutex errorMutex;
+			auto run = [&](int chunk) {
+				try {
+					function(chunk, chunkBegin(chunk), chunkBegin(chunk + 1));
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(errorMutex);
+					if (!error) {
+						error = std::current_exception();
+					}
+				}
+			};
+
+			std::vector<std::thread> workers;
+			workers.reserve(chunks - 1);
+			for (int chunk = 1; chunk < chunks; chunk++) {
+				workers.emplace_back(run, chunk);
+			}
+			run(0);
+			for (auto& worker : workers) {
+				worker.join();
+			}
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+
+		/// <summary>
+		/// Call function(index) for every index in [begin, end) across threads.
+		/// </summary>
+		template <typename Function>
+		void For(int64_t begin, int64_t end, Function&& function, int64_t grain = 1024)
+		{
+			ForEachChunk(begin, end, grain, [&](int, int64_t chunkBegin, int64_t chunkEnd) {
+				for (int64_t i = chunkBegin; i < chunkEnd; i++) {
+					function(i);
+				}
+			});
+		}
+
+		/// <summary>
+		/// Call function(index) for every index in [begin, end) across threads,
+		/// handing out grain indices at a time from a shared counter so items of uneven cost keep all threads busy.
+		/// </summary>
+		template <typename Function>
+		void ForDynamic(int64_t begin, int64_t end, Function&& function, int64_t grain = 1)
+		{
+			grain = std::max<int64_t>(1, grain);
+			std::atomic<int64_t> next(begin);
+			ForEachChunk(0, GetChunkCount(begin, end, grain), 1, [&](int, int64_t, int64_t) {
+				for (int64_t first = next.fetch_add(grain); first < end; first = next.fetch_add(grain)) {
+					int64_t last = std::min(end, first + grain);
+					for (int64_t i = first; i < last; i++) {
+						function(i);
+					}
+				}
+			});
+		}
+	}
+}
@@ -15,6 +15,7 @@
 
 #include "LNSTEPGenerator.h"
 #include "LNIGESGenerator.h"
+#include "LNSurfaceArchive.h"
 
 #include <windows.h>
 #include <filesystem>
@@ -115,5 +116,28 @@ bool LNLibEx::LNData::ToIGESFile(const std::vector<LNLib::LN_NurbsSurface>& surf
     return generator.Process();
 }
 
+bool LNLibEx::LNData::ToBinaryFile(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const std::string& filePath)
+{
+    return LNSurfaceArchive::Write(surfaces, filePath);
+}
+
+bool LNLibEx::LNData::FromBinaryFile(const std::string& filePath, std::vector<LNLib::LN_NurbsSurface>& surfaces)
+{
+    LNSurfaceArchive archive;
+    if (!archive.Open(filePath)) {
+        return false;
+    }
+
+    int count = archive.GetSurfaceCount();
+    surfaces.resize(count);
+    for (int i = 0; i < count; i++) {
+        if (!archive.GetSurface(i, surfaces[i])) {
+            surfaces.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
 
 
@@ -0,0 +1,249 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNSurfaceArchive.h"
+#include "LNObject.h"
+#include "XYZW.h"
+#include "LNBinaryUtils.h"
+#include "LNMappedFile.h"
+
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    const char ArchiveMagic[4] = { 'L', 'N', 'S', 'A' };
+    const uint32_t ArchiveVersion = 1;
+    const uint64_t ArchiveAlignment = 64;
+
+    struct ArchiveHeader
+    {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t HeaderSize;
+        uint32_t EntrySize;
+        uint64_t SurfaceCount;
+        uint64_t FileSize;
+        uint64_t IndexOffset;
+        uint64_t IndexChecksum;
+    };
+
+    struct ArchiveEntry
+    {
+        int32_t DegreeU;
+        int32_t DegreeV;
+        uint32_t KnotCountU;
+        uint32_t KnotCountV;
+        uint32_t Rows;
+        uint32_t Columns;
+        uint64_t DataOffset;
+        uint64_t DataSize;
+        uint64_t DataChecksum;
+    };
+
+    uint64_t getDataSize(const ArchiveEntry& entry) {
+        return sizeof(double) * (static_cast<uint64_t>(entry.KnotCountU) + entry.KnotCountV +
+                                 4ull * entry.Rows * entry.Columns);
+    }
+
+    bool isWritable(const LNLib::LN_NurbsSurface& surface) {
+        if (surface.DegreeU < 1 || surface.DegreeV < 1 || surface.ControlPoints.empty()) {
+            return false;
+        }
+        size_t rows = surface.ControlPoints.size();
+        size_t columns = surface.ControlPoints[0].size();
+        for (const auto& row : surface.ControlPoints) {
+            if (row.size() != columns) {
+                return false;
+            }
+        }
+        return surface.KnotVectorU.size() == rows + surface.DegreeU + 1 &&
+               surface.KnotVectorV.size() == columns + surface.DegreeV + 1;
+    }
+}
+
+class LNLibEx::LNSurfaceArchive::Impl
+{
+public:
+
+    LNMappedFile File;
+    ArchiveHeader Header = {};
+    const ArchiveEntry* Entries = nullptr;
+};
+
+LNLibEx::LNSurfaceArchive::LNSurfaceArchive():_impl(new Impl()){}
+
+LNLibEx::LNSurfaceArchive::~LNSurfaceArchive()
+{
+    delete _impl;
+}
+
+bool LNLibEx::LNSurfaceArchive::Write(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const std::string& filePath)
+{
+    if (!LNBinaryUtils::IsLittleEndian()) {
+        return false;
+    }
+
+    ArchiveHeader header = {};
+    std::memcpy(header.Magic, ArchiveMagic, sizeof(ArchiveMagic));
+    header.Version = ArchiveVersion;
+    header.HeaderSize = sizeof(ArchiveHeader);
+    header.EntrySize = sizeof(ArchiveEntry);
+    header.SurfaceCount = surfaces.size();
+    header.IndexOffset = LNBinaryUtils::AlignUp(sizeof(ArchiveHeader), ArchiveAlignment);
+
+    std::vector<ArchiveEntry> entries(surfaces.size());
+    uint64_t offset = LNBinaryUtils::AlignUp(header.IndexOffset + sizeof(ArchiveEntry) * entries.size(), ArchiveAlignment);
+    for (size_t i = 0; i < surfaces.size(); i++) {
+        const LNLib::LN_NurbsSurface& surface = surfaces[i];
+        if (!isWritable(surface)) {
+            return false;
+        }
+        ArchiveEntry& entry = entries[i];
+        entry.DegreeU = surface.DegreeU;
+        entry.DegreeV = surface.DegreeV;
+        entry.KnotCountU = static_cast<uint32_t>(surface.KnotVectorU.size());
+        entry.KnotCountV = static_cast<uint32_t>(surface.KnotVectorV.size());
+        entry.Rows = static_cast<uint32_t>(surface.ControlPoints.size());
+        entry.Columns = static_cast<uint32_t>(surface.ControlPoints[0].size());
+        entry.DataOffset = offset;
+        entry.DataSize = getDataSize(entry);
+        offset = LNBinaryUtils::AlignUp(offset + entry.DataSize, ArchiveAlignment);
+    }
+    header.FileSize = offset;
+
+    std::vector<char> buffer(header.FileSize, 0);
+    for (size_t i = 0; i < surfaces.size(); i++) {
+        const LNLib::LN_NurbsSurface& surface = surfaces[i];
+        ArchiveEntry& entry = entries[i];
+
+        double* data = reinterpret_cast<double*>(buffer.data() + entry.DataOffset);
+        data = std::copy(surface.KnotVectorU.begin(), surface.KnotVectorU.end(), data);
+        data = std::copy(surface.KnotVectorV.begin(), surface.KnotVectorV.end(), data);
+        for (const auto& row : surface.ControlPoints) {
+            for (const auto& point : row) {
+                data[0] = point.GetWX();
+                data[1] = point.GetWY();
+                data[2] = point.GetWZ();
+                data[3] = point.GetW();
+                data += 4;
+            }
+        }
+        entry.DataChecksum = LNBinaryUtils::Checksum64(buffer.data() + entry.DataOffset, entry.DataSize);
+    }
+
+    if (!entries.empty()) {
+        std::memcpy(buffer.data() + header.IndexOffset, entries.data(), sizeof(ArchiveEntry) * entries.size());
+    }
+    header.IndexChecksum = LNBinaryUtils::Checksum64(buffer.data() + header.IndexOffset, sizeof(ArchiveEntry) * entries.size());
+    std::memcpy(buffer.data(), &header, sizeof(ArchiveHeader));
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(buffer.data(), buffer.size());
+    return file.good();
+}
+
+bool LNLibEx::LNSurfaceArchive::Open(const std::string& filePath)
+{
+    Close();
+    if (!LNBinaryUtils::IsLittleEndian()) {
+        return false;
+    }
+
+    LNMappedFile& file = _impl->File;
+    if (!file.Open(filePath) || file.Size() < sizeof(ArchiveHeader)) {
+        Close();
+        return false;
+    }
+
+    ArchiveHeader& header = _impl->Header;
+    std::memcpy(&header, file.Data(), sizeof(ArchiveHeader));
+    bool isValid = std::memcmp(header.Magic, ArchiveMagic, sizeof(ArchiveMagic)) == 0 &&
+                   header.Version == ArchiveVersion &&
+                   header.HeaderSize == sizeof(ArchiveHeader) &&
+                   header.EntrySize == sizeof(ArchiveEntry) &&
+                   header.FileSize == file.Size() &&
+                   header.IndexOffset % ArchiveAlignment == 0 &&
+                   header.IndexOffset <= header.FileSize &&
+                   header.SurfaceCount <= (header.FileSize - header.IndexOffset) / sizeof(ArchiveEntry) &&
+                   header.SurfaceCount <= INT32_MAX;
+    if (!isValid ||
+        LNBinaryUtils::Checksum64(file.Data() + header.IndexOffset, sizeof(ArchiveEntry) * header.SurfaceCount) != header.IndexChecksum) {
+        Close();
+        return false;
+    }
+
+    _impl->Entries = reinterpret_cast<const ArchiveEntry*>(file.Data() + header.IndexOffset);
+    for (uint64_t i = 0; i < header.SurfaceCount; i++) {
+        const ArchiveEntry& entry = _impl->Entries[i];
+        if (entry.DataOffset % ArchiveAlignment != 0 ||
+            entry.DataSize != getDataSize(entry) ||
+            entry.DataOffset > header.FileSize ||
+            entry.DataSize > header.FileSize - entry.DataOffset) {
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void LNLibEx::LNSurfaceArchive::Close()
+{
+    _impl->File.Close();
+    _impl->Header = {};
+    _impl->Entries = nullptr;
+}
+
+bool LNLibEx::LNSurfaceArchive::IsOpen() const
+{
+    return _impl->File.Data() != nullptr;
+}
+
+int LNLibEx::LNSurfaceArchive::GetSurfaceCount() const
+{
+    return static_cast<int>(_impl->Header.SurfaceCount);
+}
+
+bool LNLibEx::LNSurfaceArchive::GetSurface(int index, LNLib::LN_NurbsSurface& surface) const
+{
+    if (!IsOpen() || index < 0 || index >= GetSurfaceCount()) {
+        return false;
+    }
+
+    const ArchiveEntry& entry = _impl->Entries[index];
+    const unsigned char* bytes = _impl->File.Data() + entry.DataOffset;
+    if (LNBinaryUtils::Checksum64(bytes, entry.DataSize) != entry.DataChecksum) {
+        return false;
+    }
+
+    const double* data = reinterpret_cast<const double*>(bytes);
+    surface.DegreeU = entry.DegreeU;
+    surface.DegreeV = entry.DegreeV;
+    surface.KnotVectorU.assign(data, data + entry.KnotCountU);
+    data += entry.KnotCountU;
+    surface.KnotVectorV.assign(data, data + entry.KnotCountV);
+    data += entry.KnotCountV;
+
+    surface.ControlPoints.resize(entry.Rows);
+    for (uint32_t i = 0; i < entry.Rows; i++) {
+        std::vector<LNLib::XYZW>& row = surface.ControlPoints[i];
+        row.clear();
+        row.reserve(entry.Columns);
+        for (uint32_t j = 0; j < entry.Columns; j++) {
+            row.emplace_back(data[0], data[1], data[2], data[3]);
+            data += 4;
+        }
+    }
+    return true;
+}
@@ -31,6 +31,17 @@ namespace LNLibEx
 		/// Export NurbsSurfaces to .iges file.
 		/// </summary>
 		static bool ToIGESFile(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const std::string& filePath);
+
+		/// <summary>
+		/// Export NurbsSurfaces to native binary container file.
+		/// Use LNSurfaceArchive to access single surface of the file.
+		/// </summary>
+		static bool ToBinaryFile(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const std::string& filePath);
+
+		/// <summary>
+		/// Import all NurbsSurfaces from native binary container file.
+		/// </summary>
+		static bool FromBinaryFile(const std::string& filePath, std::vector<LNLib::LN_NurbsSurface>& surfaces);
 	};
 
 }
@@ -0,0 +1,61 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNDataDefinitions.h"
+#include "LNObject.h"
+#include <string>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Native binary container of NurbsSurfaces.
+	/// 
+	/// Each surface stores degrees, knot vectors and row-major XYZW control net contiguously,
+	/// and an offset index at the front of file allows reading a single surface
+	/// from the memory-mapped file without touching the others.
+	/// </summary>
+	class LNData_EXPORT LNSurfaceArchive
+	{
+	public:
+
+		LNSurfaceArchive();
+		~LNSurfaceArchive();
+		LNSurfaceArchive(const LNSurfaceArchive&) = delete;
+		LNSurfaceArchive& operator=(const LNSurfaceArchive&) = delete;
+
+		/// <summary>
+		/// Write NurbsSurfaces to native binary container file.
+		/// </summary>
+		static bool Write(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const std::string& filePath);
+
+		/// <summary>
+		/// Memory-map container file and validate its header and index.
+		/// Surface data is validated lazily when accessed.
+		/// </summary>
+		bool Open(const std::string& filePath);
+
+		void Close();
+
+		bool IsOpen() const;
+
+		int GetSurfaceCount() const;
+
+		/// <summary>
+		/// Read the surface at index without deserializing other surfaces.
+		/// </summary>
+		bool GetSurface(int index, LNLib::LN_NurbsSurface& surface) const;
+
+	private:
+
+		class Impl;
+		Impl* _impl;
+	};
+}
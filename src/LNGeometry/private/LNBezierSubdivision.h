@@ -0,0 +1,154 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+
+#include "LNBezierSurfaceCache.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	namespace LNBezierSubdivision
+	{
+		/// <summary>
+		/// Rational Bezier sub-patch: homogeneous net row-major in U over parameter rectangle Domain.
+		/// The patch lies in its box and in the slab of Normal between Offsets (fat plane).
+		/// </summary>
+		struct SubPatch
+		{
+			std::vector<LNLib::XYZW> Points;
+			std::vector<LNLib::XYZ> Projected;
+			double Domain[2][2];
+			double Min[3];
+			double Max[3];
+			LNLib::XYZ Normal;
+			double Offsets[2];
+
+			/// <summary>
+			/// Lengths of the net along U and V, measured between corners.
+			/// </summary>
+			double Lengths[2];
+		};
+
+		/// <summary>
+		/// Range of the projected control points along normal.
+		/// </summary>
+		inline void GetOffsets(const SubPatch& patch, const LNLib::XYZ& normal, double* offsets)
+		{
+			offsets[0] = std::numeric_limits<double>::max();
+			offsets[1] = std::numeric_limits<double>::lowest();
+			for (const LNLib::XYZ& point : patch.Projected) {
+				double offset = normal.DotProduct(point);
+				offsets[0] = std::min(offsets[0], offset);
+				offsets[1] = std::max(offsets[1], offset);
+			}
+		}
+
+		/// <summary>
+		/// Fill bounds, lengths and fat plane from Points, weights must be positive.
+		/// </summary>
+		inline void Initialize(SubPatch& patch, int degreeU, int degreeV)
+		{
+			const int columns = degreeV + 1;
+			std::vector<LNLib::XYZ>& points = patch.Projected;
+			points.resize(patch.Points.size());
+			for (int i = 0; i < 3; i++) {
+				patch.Min[i] = std::numeric_limits<double>::max();
+				patch.Max[i] = std::numeric_limits<double>::lowest();
+			}
+			for (size_t k = 0; k < points.size(); k++) {
+				points[k] = patch.Points[k].ToXYZ(true);
+				for (int i = 0; i < 3; i++) {
+					patch.Min[i] = std::min(patch.Min[i], points[k][i]);
+					patch.Max[i] = std::max(patch.Max[i], points[k][i]);
+				}
+			}
+
+			const LNLib::XYZ& corner00 = points[0];
+			const LNLib::XYZ& corner01 = points[degreeV];
+			const LNLib::XYZ& corner10 = points[degreeU * columns];
+			const LNLib::XYZ& corner11 = points[degreeU * columns + degreeV];
+			patch.Lengths[0] = corner00.Distance(corner10) + corner01.Distance(corner11);
+			patch.Lengths[1] = corner00.Distance(corner01) + corner10.Distance(corner11);
+
+			patch.Normal = (corner11 - corner00).CrossProduct(corner01 - corner10);
+			double length = patch.Normal.Length();
+			patch.Normal = length > 0.0 ? patch.Normal / length : LNLib::XYZ(0, 0, 0);
+			GetOffsets(patch, patch.Normal, patch.Offsets);
+		}
+
+		/// <summary>
+		/// Patch (i, j) of cache.
+		/// </summary>
+		inline void Initialize(SubPatch& patch, const LNBezierSurfaceCache& cache, int i, int j)
+		{
+			const LNLib::XYZW* points = cache.GetPatchControlPoints(i, j);
+			patch.Points.assign(points, points + (cache.GetDegreeU() + 1) * (cache.GetDegreeV() + 1));
+			patch.Domain[0][0] = cache.GetKnotsU()[i];
+			patch.Domain[0][1] = cache.GetKnotsU()[i + 1];
+			patch.Domain[1][0] = cache.GetKnotsV()[j];
+			patch.Domain[1][1] = cache.GetKnotsV()[j + 1];
+			Initialize(patch, cache.GetDegreeU(), cache.GetDegreeV());
+		}
+
+		inline double GetDiagonal(const SubPatch& patch)
+		{
+			return LNLib::XYZ(patch.Max[0] - patch.Min[0], patch.Max[1] - patch.Min[1], patch.Max[2] - patch.Min[2]).Length();
+		}
+
+		/// <summary>
+		/// Fat plane thinner than ratio times the box diagonal.
+		/// </summary>
+		inline bool IsFlat(const SubPatch& patch, double ratio)
+		{
+			return patch.Normal.Length() > 0.0 && patch.Offsets[1] - patch.Offsets[0] <= ratio * GetDiagonal(patch);
+		}
+
+		/// <summary>
+		/// Split at the middle of direction (0 for U, 1 for V) by de Casteljau on the homogeneous net.
+		/// </summary>
+		inline void Split(const SubPatch& patch, int degreeU, int degreeV, int direction, SubPatch& first, SubPatch& second)
+		{
+			const int columns = degreeV + 1;
+			const int degree = direction == 0 ? degreeU : degreeV;
+			const int lineCount = direction == 0 ? columns : degreeU + 1;
+			auto index = [&](int line, int k) {
+				return direction == 0 ? k * columns + line : line * columns + k;
+			};
+
+			first.Points.resize(patch.Points.size());
+			second.Points.resize(patch.Points.size());
+			std::vector<LNLib::XYZW> work(degree + 1);
+			for (int line = 0; line < lineCount; line++) {
+				for (int k = 0; k <= degree; k++) {
+					work[k] = patch.Points[index(line, k)];
+				}
+				for (int r = 0; r <= degree; r++) {
+					first.Points[index(line, r)] = work[0];
+					second.Points[index(line, degree - r)] = work[degree - r];
+					for (int k = 0; k < degree - r; k++) {
+						work[k] = (work[k] + work[k + 1]) * 0.5;
+					}
+				}
+			}
+
+			std::copy(&patch.Domain[0][0], &patch.Domain[0][0] + 4, &first.Domain[0][0]);
+			std::copy(&patch.Domain[0][0], &patch.Domain[0][0] + 4, &second.Domain[0][0]);
+			double middle = 0.5 * (patch.Domain[direction][0] + patch.Domain[direction][1]);
+			first.Domain[direction][1] = middle;
+			second.Domain[direction][0] = middle;
+			Initialize(first, degreeU, degreeV);
+			Initialize(second, degreeU, degreeV);
+		}
+	}
+}
@@ -0,0 +1,282 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNBezierSurfaceCache.h"
+#include "LNObject.h"
+#include "NurbsSurface.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include "UV.h"
+#include "LNPowerBasis.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+namespace
+{
+    LNLib::XYZ project(const double* value) {
+        return LNLib::XYZ(value[0] / value[3], value[1] / value[3], value[2] / value[3]);
+    }
+
+    LNLib::XYZ projectDerivative(const double* derivative, const LNLib::XYZ& point, double weight, double scale) {
+        return (LNLib::XYZ(derivative[0], derivative[1], derivative[2]) - point * derivative[3]) * (scale / weight);
+    }
+}
+
+bool LNLibEx::LNBezierSurfaceCache::Build(const LNLib::LN_NurbsSurface& surface)
+{
+    *this = LNBezierSurfaceCache();
+    std::vector<LNLib::LN_NurbsSurface> patches;
+    try {
+        LNLib::NurbsSurface::Check(surface);
+        patches = LNLib::NurbsSurface::DecomposeToBeziers(surface);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    const int degreeU = surface.DegreeU;
+    const int degreeV = surface.DegreeV;
+    std::vector<double> knotsU = LNPowerBasis::GetDistinctKnots(surface.KnotVectorU, degreeU, static_cast<int>(surface.ControlPoints.size()));
+    std::vector<double> knotsV = LNPowerBasis::GetDistinctKnots(surface.KnotVectorV, degreeV, static_cast<int>(surface.ControlPoints[0].size()));
+    const int countU = static_cast<int>(knotsU.size()) - 1;
+    const int countV = static_cast<int>(knotsV.size()) - 1;
+    if (static_cast<int>(patches.size()) != countU * countV) {
+        return false;
+    }
+
+    // Patches are placed by their own knots, so the order DecomposeToBeziers returns them in does not matter.
+    const size_t stride = static_cast<size_t>(degreeU + 1) * (degreeV + 1);
+    std::vector<LNLib::XYZW> controlPoints(patches.size() * stride);
+    for (const LNLib::LN_NurbsSurface& patch : patches) {
+        if (patch.DegreeU != degreeU || patch.DegreeV != degreeV ||
+            static_cast<int>(patch.ControlPoints.size()) != degreeU + 1 || static_cast<int>(patch.ControlPoints[0].size()) != degreeV + 1) {
+            return false;
+        }
+        double middleU = 0.5 * (patch.KnotVectorU.front() + patch.KnotVectorU.back());
+        double middleV = 0.5 * (patch.KnotVectorV.front() + patch.KnotVectorV.back());
+        int i = LNPowerBasis::FindInterval(knotsU, middleU);
+        int j = LNPowerBasis::FindInterval(knotsV, middleV);
+        LNLib::XYZW* target = controlPoints.data() + (static_cast<size_t>(i) * countV + j) * stride;
+        for (int a = 0; a <= degreeU; a++) {
+            for (int b = 0; b <= degreeV; b++) {
+                target[a * (degreeV + 1) + b] = patch.ControlPoints[a][b];
+            }
+        }
+    }
+
+    std::vector<std::vector<double>> matrixU = LNPowerBasis::GetBezierToPowerMatrix(degreeU);
+    std::vector<std::vector<double>> matrixV = LNPowerBasis::GetBezierToPowerMatrix(degreeV);
+    std::vector<double> coefficients(4 * controlPoints.size(), 0.0);
+    LNParallel::For(0, static_cast<int64_t>(patches.size()), [&](int64_t patch) {
+        const LNLib::XYZW* points = controlPoints.data() + patch * stride;
+        double* target = coefficients.data() + 4 * patch * stride;
+        for (int a = 0; a <= degreeU; a++) {
+            for (int b = 0; b <= degreeV; b++) {
+                double* coefficient = target + 4 * (a * (degreeV + 1) + b);
+                for (int i = 0; i <= a; i++) {
+                    for (int j = 0; j <= b; j++) {
+                        double factor = matrixU[a][i] * matrixV[b][j];
+                        const LNLib::XYZW& point = points[i * (degreeV + 1) + j];
+                        for (int c = 0; c < 4; c++) {
+                            coefficient[c] += factor * point[c];
+                        }
+                    }
+                }
+            }
+        }
+    }, 64);
+
+    _degreeU = degreeU;
+    _degreeV = degreeV;
+    _knotsU = std::move(knotsU);
+    _knotsV = std::move(knotsV);
+    _controlPoints = std::move(controlPoints);
+    _coefficients = std::move(coefficients);
+    return true;
+}
+
+bool LNLibEx::LNBezierSurfaceCache::IsEmpty() const
+{
+    return _coefficients.empty();
+}
+
+int LNLibEx::LNBezierSurfaceCache::GetDegreeU() const
+{
+    return _degreeU;
+}
+
+int LNLibEx::LNBezierSurfaceCache::GetDegreeV() const
+{
+    return _degreeV;
+}
+
+int LNLibEx::LNBezierSurfaceCache::GetPatchCountU() const
+{
+    return _knotsU.empty() ? 0 : static_cast<int>(_knotsU.size()) - 1;
+}
+
+int LNLibEx::LNBezierSurfaceCache::GetPatchCountV() const
+{
+    return _knotsV.empty() ? 0 : static_cast<int>(_knotsV.size()) - 1;
+}
+
+const std::vector<double>& LNLibEx::LNBezierSurfaceCache::GetKnotsU() const
+{
+    return _knotsU;
+}
+
+const std::vector<double>& LNLibEx::LNBezierSurfaceCache::GetKnotsV() const
+{
+    return _knotsV;
+}
+
+const LNLib::XYZW* LNLibEx::LNBezierSurfaceCache::GetPatchControlPoints(int i, int j) const
+{
+    return _controlPoints.data() + (static_cast<size_t>(i) * GetPatchCountV() + j) * (_degreeU + 1) * (_degreeV + 1);
+}
+
+int LNLibEx::LNBezierSurfaceCache::Locate(const LNLib::UV& uv, double& s, double& t) const
+{
+    double u = uv.GetU();
+    double v = uv.GetV();
+    int i = LNPowerBasis::FindInterval(_knotsU, u);
+    int j = LNPowerBasis::FindInterval(_knotsV, v);
+    s = (u - _knotsU[i]) / (_knotsU[i + 1] - _knotsU[i]);
+    t = (v - _knotsV[j]) / (_knotsV[j + 1] - _knotsV[j]);
+    return i * GetPatchCountV() + j;
+}
+
+void LNLibEx::LNBezierSurfaceCache::EvaluatePatch(int patch, double s, double t, int derivative, double values[6][4]) const
+{
+    const int orderV = _degreeV + 1;
+    const double* coefficients = _coefficients.data() + 4 * static_cast<size_t>(patch) * (_degreeU + 1) * orderV;
+    for (int k = 0; k < 6; k++) {
+        std::fill(values[k], values[k] + 4, 0.0);
+    }
+    double* v = values[0];
+    double* ds = values[1];
+    double* dt = values[2];
+    double* dss = values[3];
+    double* dst = values[4];
+    double* dtt = values[5];
+
+    // Horner along t for every power of s, then along s. Derivatives follow from the same recurrences,
+    // second derivative accumulators hold half of the derivative until the end.
+    for (int a = _degreeU; a >= 0; a--) {
+        double row[4] = { 0, 0, 0, 0 };
+        double rowT[4] = { 0, 0, 0, 0 };
+        double rowTT[4] = { 0, 0, 0, 0 };
+        const double* coefficient = coefficients + 4 * static_cast<size_t>(a) * orderV;
+        for (int b = _degreeV; b >= 0; b--) {
+            for (int c = 0; c < 4; c++) {
+                if (derivative >= 2) {
+                    rowTT[c] = rowTT[c] * t + rowT[c];
+                }
+                if (derivative >= 1) {
+                    rowT[c] = rowT[c] * t + row[c];
+                }
+                row[c] = row[c] * t + coefficient[4 * b + c];
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            if (derivative >= 2) {
+                dss[c] = dss[c] * s + ds[c];
+                dst[c] = dst[c] * s + dt[c];
+                dtt[c] = dtt[c] * s + rowTT[c];
+            }
+            if (derivative >= 1) {
+                ds[c] = ds[c] * s + v[c];
+                dt[c] = dt[c] * s + rowT[c];
+            }
+            v[c] = v[c] * s + row[c];
+        }
+    }
+    for (int c = 0; c < 4; c++) {
+        dss[c] *= 2.0;
+        dtt[c] *= 2.0;
+    }
+}
+
+LNLib::XYZ LNLibEx::LNBezierSurfaceCache::GetPoint(const LNLib::UV& uv) const
+{
+    double s = 0.0, t = 0.0;
+    int patch = Locate(uv, s, t);
+    double values[6][4];
+    EvaluatePatch(patch, s, t, 0, values);
+    return project(values[0]);
+}
+
+void LNLibEx::LNBezierSurfaceCache::GetDerivatives(const LNLib::UV& uv, LNLib::XYZ& point, LNLib::XYZ& derivativeU, LNLib::XYZ& derivativeV) const
+{
+    double s = 0.0, t = 0.0;
+    int patch = Locate(uv, s, t);
+    double values[6][4];
+    EvaluatePatch(patch, s, t, 1, values);
+
+    const int countV = GetPatchCountV();
+    const double scaleU = 1.0 / (_knotsU[patch / countV + 1] - _knotsU[patch / countV]);
+    const double scaleV = 1.0 / (_knotsV[patch % countV + 1] - _knotsV[patch % countV]);
+    point = project(values[0]);
+    derivativeU = projectDerivative(values[1], point, values[0][3], scaleU);
+    derivativeV = projectDerivative(values[2], point, values[0][3], scaleV);
+}
+
+void LNLibEx::LNBezierSurfaceCache::GetDerivatives(const LNLib::UV& uv, LNLib::XYZ& point, LNLib::XYZ& derivativeU, LNLib::XYZ& derivativeV,
+                                                   LNLib::XYZ& derivativeUU, LNLib::XYZ& derivativeUV, LNLib::XYZ& derivativeVV) const
+{
+    double s = 0.0, t = 0.0;
+    int patch = Locate(uv, s, t);
+    double values[6][4];
+    EvaluatePatch(patch, s, t, 2, values);
+
+    const int countV = GetPatchCountV();
+    const double scaleU = 1.0 / (_knotsU[patch / countV + 1] - _knotsU[patch / countV]);
+    const double scaleV = 1.0 / (_knotsV[patch % countV + 1] - _knotsV[patch % countV]);
+    const double w = values[0][3];
+    const double wu = values[1][3] * scaleU;
+    const double wv = values[2][3] * scaleV;
+    point = project(values[0]);
+    derivativeU = projectDerivative(values[1], point, w, scaleU);
+    derivativeV = projectDerivative(values[2], point, w, scaleV);
+
+    // Quotient rule of A / w, The NURBS Book Eq.4.20.
+    auto getXYZ = [](const double* value, double scale) { return LNLib::XYZ(value[0], value[1], value[2]) * scale; };
+    derivativeUU = (getXYZ(values[3], scaleU * scaleU) - derivativeU * (2.0 * wu) - point * (values[3][3] * scaleU * scaleU)) / w;
+    derivativeUV = (getXYZ(values[4], scaleU * scaleV) - derivativeU * wv - derivativeV * wu - point * (values[4][3] * scaleU * scaleV)) / w;
+    derivativeVV = (getXYZ(values[5], scaleV * scaleV) - derivativeV * (2.0 * wv) - point * (values[5][3] * scaleV * scaleV)) / w;
+}
+
+LNLib::XYZ LNLibEx::LNBezierSurfaceCache::GetNormal(const LNLib::UV& uv) const
+{
+    LNLib::XYZ point, derivativeU, derivativeV;
+    GetDerivatives(uv, point, derivativeU, derivativeV);
+    LNLib::XYZ normal = derivativeU.CrossProduct(derivativeV);
+    double length = normal.Length();
+    return length > 1E-14 * derivativeU.Length() * derivativeV.Length() && length > 0.0 ? normal / length : LNLib::XYZ(0, 0, 0);
+}
+
+void LNLibEx::LNBezierSurfaceCache::GetPoints(const std::vector<LNLib::UV>& uvs, std::vector<LNLib::XYZ>& points) const
+{
+    points.resize(uvs.size());
+    LNParallel::For(0, static_cast<int64_t>(uvs.size()), [&](int64_t i) {
+        points[i] = GetPoint(uvs[i]);
+    });
+}
+
+void LNLibEx::LNBezierSurfaceCache::GetNormals(const std::vector<LNLib::UV>& uvs, std::vector<LNLib::XYZ>& normals) const
+{
+    normals.resize(uvs.size());
+    LNParallel::For(0, static_cast<int64_t>(uvs.size()), [&](int64_t i) {
+        normals[i] = GetNormal(uvs[i]);
+    });
+}
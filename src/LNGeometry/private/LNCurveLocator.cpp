@@ -0,0 +1,363 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNCurveLocator.h"
+#include "LNObject.h"
+#include "NurbsCurve.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include "LNPowerBasis.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+
+namespace
+{
+    const int MaxIterations = 32;
+    const size_t ChordsPerBlock = 16;
+
+    // 5-point Gauss-Legendre rule on [-1, 1].
+    const double GaussAbscissae[5] = { -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640 };
+    const double GaussWeights[5] = { 0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+
+    int findTableInterval(const std::vector<double>& values, double value) {
+        int index = static_cast<int>(std::upper_bound(values.begin(), values.end(), value) - values.begin()) - 1;
+        return std::max(0, std::min(static_cast<int>(values.size()) - 2, index));
+    }
+}
+
+bool LNLibEx::LNCurveLocator::Build(const LNLib::LN_NurbsCurve& curve, int samplesPerSpan)
+{
+    *this = LNCurveLocator();
+    std::vector<LNLib::LN_NurbsCurve> segments;
+    try {
+        LNLib::NurbsCurve::Check(curve);
+        segments = LNLib::NurbsCurve::DecomposeToBeziers(curve);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    const int degree = curve.Degree;
+    std::vector<double> knots = LNPowerBasis::GetDistinctKnots(curve.KnotVector, degree, static_cast<int>(curve.ControlPoints.size()));
+    if (segments.size() + 1 != knots.size()) {
+        return false;
+    }
+
+    // Segments are placed by their own knots, so the order DecomposeToBeziers returns them in does not matter.
+    std::vector<std::vector<double>> matrix = LNPowerBasis::GetBezierToPowerMatrix(degree);
+    std::vector<double> coefficients(4 * segments.size() * (degree + 1), 0.0);
+    for (const LNLib::LN_NurbsCurve& segment : segments) {
+        if (segment.Degree != degree || static_cast<int>(segment.ControlPoints.size()) != degree + 1) {
+            return false;
+        }
+        double middle = 0.5 * (segment.KnotVector.front() + segment.KnotVector.back());
+        double* target = coefficients.data() + 4 * static_cast<size_t>(LNPowerBasis::FindInterval(knots, middle)) * (degree + 1);
+        for (int a = 0; a <= degree; a++) {
+            for (int i = 0; i <= a; i++) {
+                for (int c = 0; c < 4; c++) {
+                    target[4 * a + c] += matrix[a][i] * segment.ControlPoints[i][c];
+                }
+            }
+        }
+    }
+    _degree = degree;
+    _knots = std::move(knots);
+    _coefficients = std::move(coefficients);
+
+    samplesPerSpan = std::max(1, samplesPerSpan);
+    for (size_t i = 0; i + 1 < _knots.size(); i++) {
+        for (int k = 0; k < samplesPerSpan; k++) {
+            _parameters.emplace_back(_knots[i] + (_knots[i + 1] - _knots[i]) * k / samplesPerSpan);
+        }
+    }
+    _parameters.emplace_back(_knots.back());
+
+    const int64_t count = static_cast<int64_t>(_parameters.size());
+    _lengths.assign(count, 0.0);
+    _points.resize(count);
+    LNParallel::For(0, count, [&](int64_t k) {
+        _points[k] = GetPoint(_parameters[k]);
+        if (k > 0) {
+            _lengths[k] = Integrate(_parameters[k - 1], _parameters[k]);
+        }
+    }, 256);
+    for (int64_t k = 1; k < count; k++) {
+        _lengths[k] += _lengths[k - 1];
+    }
+    for (size_t first = 0; first + 1 < _points.size(); first += ChordsPerBlock) {
+        LNLib::XYZ minimum = _points[first];
+        LNLib::XYZ maximum = _points[first];
+        for (size_t k = first + 1; k <= std::min(_points.size() - 1, first + ChordsPerBlock); k++) {
+            for (int axis = 0; axis < 3; axis++) {
+                minimum[axis] = std::min(minimum[axis], _points[k][axis]);
+                maximum[axis] = std::max(maximum[axis], _points[k][axis]);
+            }
+        }
+        _blockMinimums.emplace_back(minimum);
+        _blockMaximums.emplace_back(maximum);
+    }
+    _isClosed = _points.front().Distance(_points.back()) <= 1E-9 * std::max(1.0, _lengths.back());
+    return true;
+}
+
+bool LNLibEx::LNCurveLocator::IsEmpty() const
+{
+    return _parameters.empty();
+}
+
+double LNLibEx::LNCurveLocator::GetStartParameter() const
+{
+    return _knots.empty() ? 0.0 : _knots.front();
+}
+
+double LNLibEx::LNCurveLocator::GetEndParameter() const
+{
+    return _knots.empty() ? 0.0 : _knots.back();
+}
+
+void LNLibEx::LNCurveLocator::Evaluate(double parameter, int derivative, double values[3][4]) const
+{
+    const int segment = LNPowerBasis::FindInterval(_knots, parameter);
+    const double span = _knots[segment + 1] - _knots[segment];
+    const double s = (parameter - _knots[segment]) / span;
+    const double* coefficients = _coefficients.data() + 4 * static_cast<size_t>(segment) * (_degree + 1);
+    for (int k = 0; k < 3; k++) {
+        std::fill(values[k], values[k] + 4, 0.0);
+    }
+
+    // Horner's scheme, the second derivative accumulator holds half of the derivative until the end.
+    for (int a = _degree; a >= 0; a--) {
+        for (int c = 0; c < 4; c++) {
+            if (derivative >= 2) {
+                values[2][c] = values[2][c] * s + values[1][c];
+            }
+            if (derivative >= 1) {
+                values[1][c] = values[1][c] * s + values[0][c];
+            }
+            values[0][c] = values[0][c] * s + coefficients[4 * a + c];
+        }
+    }
+    for (int c = 0; c < 4; c++) {
+        values[1][c] /= span;
+        values[2][c] *= 2.0 / (span * span);
+    }
+}
+
+void LNLibEx::LNCurveLocator::GetDerivatives(double parameter, LNLib::XYZ& point, LNLib::XYZ& first, LNLib::XYZ& second) const
+{
+    double values[3][4];
+    Evaluate(parameter, 2, values);
+    const double w = values[0][3];
+    point = LNLib::XYZ(values[0][0], values[0][1], values[0][2]) / w;
+    first = (LNLib::XYZ(values[1][0], values[1][1], values[1][2]) - point * values[1][3]) / w;
+    second = (LNLib::XYZ(values[2][0], values[2][1], values[2][2]) - first * (2.0 * values[1][3]) - point * values[2][3]) / w;
+}
+
+LNLib::XYZ LNLibEx::LNCurveLocator::GetPoint(double parameter) const
+{
+    double values[3][4];
+    Evaluate(parameter, 0, values);
+    return LNLib::XYZ(values[0][0], values[0][1], values[0][2]) / values[0][3];
+}
+
+double LNLibEx::LNCurveLocator::GetSpeed(double parameter) const
+{
+    double values[3][4];
+    Evaluate(parameter, 1, values);
+    const double w = values[0][3];
+    LNLib::XYZ point = LNLib::XYZ(values[0][0], values[0][1], values[0][2]) / w;
+    return ((LNLib::XYZ(values[1][0], values[1][1], values[1][2]) - point * values[1][3]) / w).Length();
+}
+
+double LNLibEx::LNCurveLocator::Integrate(double start, double end) const
+{
+    const double middle = 0.5 * (start + end);
+    const double half = 0.5 * (end - start);
+    double sum = 0.0;
+    for (int k = 0; k < 5; k++) {
+        sum += GaussWeights[k] * GetSpeed(middle + half * GaussAbscissae[k]);
+    }
+    return sum * half;
+}
+
+double LNLibEx::LNCurveLocator::GetLength() const
+{
+    return _lengths.empty() ? 0.0 : _lengths.back();
+}
+
+double LNLibEx::LNCurveLocator::GetLength(double parameter) const
+{
+    if (IsEmpty()) {
+        return 0.0;
+    }
+    parameter = std::max(_parameters.front(), std::min(_parameters.back(), parameter));
+    int k = findTableInterval(_parameters, parameter);
+    return _lengths[k] + Integrate(_parameters[k], parameter);
+}
+
+double LNLibEx::LNCurveLocator::GetParameter(double length) const
+{
+    if (IsEmpty()) {
+        return 0.0;
+    }
+    length = std::max(0.0, std::min(GetLength(), length));
+    int k = findTableInterval(_lengths, length);
+    double low = _parameters[k];
+    double high = _parameters[k + 1];
+    double interval = _lengths[k + 1] - _lengths[k];
+    if (interval <= 0.0) {
+        return low;
+    }
+
+    // Newton on the length integral, bisection of the bracketing table interval where a step leaves it.
+    double parameter = low + (high - low) * (length - _lengths[k]) / interval;
+    const double tolerance = 1E-14 * std::max(1.0, GetLength());
+    for (int i = 0; i < MaxIterations; i++) {
+        double difference = _lengths[k] + Integrate(_parameters[k], parameter) - length;
+        if (std::fabs(difference) <= tolerance) {
+            break;
+        }
+        if (difference > 0.0) {
+            high = parameter;
+        }
+        else {
+            low = parameter;
+        }
+        double speed = GetSpeed(parameter);
+        double next = speed > 0.0 ? parameter - difference / speed : low - 1.0;
+        if (!(next > low && next < high)) {
+            next = 0.5 * (low + high);
+        }
+        if (next == parameter) {
+            break;
+        }
+        parameter = next;
+    }
+    return parameter;
+}
+
+void LNLibEx::LNCurveLocator::GetParameters(const std::vector<double>& lengths, std::vector<double>& parameters) const
+{
+    parameters.resize(lengths.size());
+    LNParallel::For(0, static_cast<int64_t>(lengths.size()), [&](int64_t i) {
+        parameters[i] = GetParameter(lengths[i]);
+    }, 256);
+}
+
+std::vector<double> LNLibEx::LNCurveLocator::GetParametersBySpacing(double spacing) const
+{
+    std::vector<double> parameters;
+    if (IsEmpty() || !(spacing > 0.0)) {
+        return parameters;
+    }
+    const int64_t count = static_cast<int64_t>(std::floor(GetLength() / spacing * (1.0 + 1E-12))) + 1;
+    std::vector<double> lengths(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; i++) {
+        lengths[i] = spacing * static_cast<double>(i);
+    }
+    GetParameters(lengths, parameters);
+    return parameters;
+}
+
+double LNLibEx::LNCurveLocator::Project(const LNLib::XYZ& point) const
+{
+    if (IsEmpty()) {
+        return 0.0;
+    }
+
+    // Seed from the closest chord of the sampled polyline, starting in the nearest block and skipping blocks that cannot be closer.
+    double parameter = _parameters.front();
+    double bestDistance = std::numeric_limits<double>::max();
+    auto scanBlock = [&](size_t block) {
+        size_t last = std::min(_points.size() - 1, (block + 1) * ChordsPerBlock);
+        for (size_t k = block * ChordsPerBlock; k < last; k++) {
+            LNLib::XYZ chord = _points[k + 1] - _points[k];
+            double squared = chord.DotProduct(chord);
+            double fraction = squared > 0.0 ? std::max(0.0, std::min(1.0, (point - _points[k]).DotProduct(chord) / squared)) : 0.0;
+            double distance = (_points[k] + chord * fraction).Distance(point);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                parameter = _parameters[k] + (_parameters[k + 1] - _parameters[k]) * fraction;
+            }
+        }
+    };
+    const size_t blockCount = _blockMinimums.size();
+    std::vector<double> blockDistances(blockCount);
+    size_t nearestBlock = 0;
+    for (size_t block = 0; block < blockCount; block++) {
+        double squared = 0.0;
+        for (int axis = 0; axis < 3; axis++) {
+            double outside = std::max({ 0.0, _blockMinimums[block][axis] - point[axis], point[axis] - _blockMaximums[block][axis] });
+            squared += outside * outside;
+        }
+        blockDistances[block] = std::sqrt(squared);
+        if (blockDistances[block] < blockDistances[nearestBlock]) {
+            nearestBlock = block;
+        }
+    }
+    scanBlock(nearestBlock);
+    for (size_t block = 0; block < blockCount; block++) {
+        if (block != nearestBlock && blockDistances[block] < bestDistance) {
+            scanBlock(block);
+        }
+    }
+
+    const double start = _knots.front();
+    const double end = _knots.back();
+    double best = parameter;
+    bestDistance = std::numeric_limits<double>::max();
+    for (int i = 0; i < MaxIterations; i++) {
+        LNLib::XYZ c, first, second;
+        GetDerivatives(parameter, c, first, second);
+        const LNLib::XYZ r = c - point;
+        const double length = r.Length();
+        if (length <= bestDistance) {
+            bestDistance = length;
+            best = parameter;
+        }
+        const double f = r.DotProduct(first);
+        if (length == 0.0 || std::fabs(f) <= 1E-14 * first.Length() * length) {
+            break;
+        }
+        double slope = first.DotProduct(first) + r.DotProduct(second);
+        if (slope <= 0.0) {
+            slope = first.DotProduct(first);
+        }
+        if (slope <= 0.0) {
+            break;
+        }
+        double next = parameter - f / slope;
+        if (_isClosed && (next < start || next > end)) {
+            next = start + std::fmod(next - start, end - start);
+            if (next < start) {
+                next += end - start;
+            }
+        }
+        next = std::max(start, std::min(end, next));
+        bool isConverged = first.Length() * std::fabs(next - parameter) <= 1E-15 * std::max(1.0, c.Length());
+        parameter = next;
+        if (isConverged) {
+            break;
+        }
+    }
+    return GetPoint(parameter).Distance(point) <= bestDistance + 1E-12 * std::max(1.0, bestDistance) ? parameter : best;
+}
+
+void LNLibEx::LNCurveLocator::Project(const std::vector<LNLib::XYZ>& points, std::vector<double>& parameters) const
+{
+    parameters.resize(points.size());
+    LNParallel::For(0, static_cast<int64_t>(points.size()), [&](int64_t i) {
+        parameters[i] = Project(points[i]);
+    }, 256);
+}
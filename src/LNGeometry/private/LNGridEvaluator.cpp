@@ -0,0 +1,239 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNGridEvaluator.h"
+#include "LNObject.h"
+#include "NurbsSurface.h"
+#include "Polynomials.h"
+#include "XYZ.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace
+{
+    // Grid samples per thread chunk, below this threads cost more than they save.
+    const int64_t Grain = 1 << 14;
+
+    bool computeBasis(int degree, const std::vector<double>& knotVector, int controlPointsCount, const std::vector<double>& parameters,
+                      std::vector<int>& firsts, std::vector<double>& basis, std::vector<double>& derivatives) {
+        const int count = static_cast<int>(parameters.size());
+        firsts.resize(count);
+        basis.resize(static_cast<size_t>(count) * (degree + 1));
+        derivatives.resize(basis.size());
+        for (int i = 0; i < count; i++) {
+            double parameter = parameters[i];
+            if (!(parameter >= knotVector[degree] && parameter <= knotVector[controlPointsCount])) {
+                return false;
+            }
+            int span = LNLib::Polynomials::GetKnotSpanIndex(degree, knotVector, parameter);
+            auto values = LNLib::Polynomials::BasisFunctionsDerivatives(span, degree, 1, knotVector, parameter);
+            firsts[i] = span - degree;
+            for (int k = 0; k <= degree; k++) {
+                basis[static_cast<size_t>(i) * (degree + 1) + k] = values[0][k];
+                derivatives[static_cast<size_t>(i) * (degree + 1) + k] = values[1][k];
+            }
+        }
+        return true;
+    }
+}
+
+bool LNLibEx::LNGridEvaluator::Build(const LNLib::LN_NurbsSurface& surface, const std::vector<double>& u, const std::vector<double>& v)
+{
+    *this = LNGridEvaluator();
+    try {
+        LNLib::NurbsSurface::Check(surface);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    const int controlCountU = static_cast<int>(surface.ControlPoints.size());
+    const int controlCountV = static_cast<int>(surface.ControlPoints[0].size());
+    std::vector<int> firstV;
+    std::vector<double> basisV;
+    std::vector<double> derivativeV;
+    if (!computeBasis(surface.DegreeU, surface.KnotVectorU, controlCountU, u, _firstU, _basisU, _derivativeU) ||
+        !computeBasis(surface.DegreeV, surface.KnotVectorV, controlCountV, v, firstV, basisV, derivativeV)) {
+        *this = LNGridEvaluator();
+        return false;
+    }
+
+    _degreeU = surface.DegreeU;
+    _degreeV = surface.DegreeV;
+    _controlCountV = controlCountV;
+    _controlPoints.resize(static_cast<size_t>(4) * controlCountU * controlCountV);
+    for (int i = 0; i < controlCountU; i++) {
+        for (int j = 0; j < controlCountV; j++) {
+            for (int c = 0; c < 4; c++) {
+                _controlPoints[4 * (static_cast<size_t>(i) * controlCountV + j) + c] = surface.ControlPoints[i][j][c];
+            }
+        }
+    }
+
+    // Transpose V tables so that basis k of all samples is contiguous.
+    _countV = static_cast<int>(v.size());
+    _basisV.resize(basisV.size());
+    _derivativeV.resize(derivativeV.size());
+    for (int j = 0; j < _countV; j++) {
+        for (int k = 0; k <= _degreeV; k++) {
+            _basisV[static_cast<size_t>(k) * _countV + j] = basisV[static_cast<size_t>(j) * (_degreeV + 1) + k];
+            _derivativeV[static_cast<size_t>(k) * _countV + j] = derivativeV[static_cast<size_t>(j) * (_degreeV + 1) + k];
+        }
+        if (_runsV.empty() || _runsV.back().First != firstV[j]) {
+            _runsV.push_back({ j, j + 1, firstV[j] });
+        }
+        else {
+            _runsV.back().End = j + 1;
+        }
+    }
+    return true;
+}
+
+bool LNLibEx::LNGridEvaluator::IsEmpty() const
+{
+    return _firstU.empty() || _countV == 0;
+}
+
+int LNLibEx::LNGridEvaluator::GetCountU() const
+{
+    return static_cast<int>(_firstU.size());
+}
+
+int LNLibEx::LNGridEvaluator::GetCountV() const
+{
+    return _countV;
+}
+
+void LNLibEx::LNGridEvaluator::EvaluatePoints(std::vector<LNLib::XYZ>& points) const
+{
+    points.resize(static_cast<size_t>(GetCountU()) * _countV);
+    Evaluate(points.data(), nullptr, nullptr, nullptr);
+}
+
+void LNLibEx::LNGridEvaluator::EvaluateDerivatives(std::vector<LNLib::XYZ>& points, std::vector<LNLib::XYZ>& derivativesU, std::vector<LNLib::XYZ>& derivativesV) const
+{
+    size_t count = static_cast<size_t>(GetCountU()) * _countV;
+    points.resize(count);
+    derivativesU.resize(count);
+    derivativesV.resize(count);
+    Evaluate(points.data(), derivativesU.data(), derivativesV.data(), nullptr);
+}
+
+void LNLibEx::LNGridEvaluator::EvaluateNormals(std::vector<LNLib::XYZ>& normals) const
+{
+    normals.resize(static_cast<size_t>(GetCountU()) * _countV);
+    Evaluate(nullptr, nullptr, nullptr, normals.data());
+}
+
+void LNLibEx::LNGridEvaluator::Evaluate(LNLib::XYZ* points, LNLib::XYZ* derivativesU, LNLib::XYZ* derivativesV, LNLib::XYZ* normals) const
+{
+    if (IsEmpty()) {
+        return;
+    }
+    const bool hasDerivatives = derivativesU || derivativesV || normals;
+    const int countU = GetCountU();
+    const int countV = _countV;
+    const int orderU = _degreeU + 1;
+    const int64_t grain = std::max<int64_t>(1, Grain / countV);
+
+    LNParallel::ForEachChunk(0, countU, grain, [&](int, int64_t begin, int64_t end) {
+        // Row: control net contracted along U. Sums: homogeneous coordinates per V sample, one array per component.
+        std::vector<double> row(4 * static_cast<size_t>(_controlCountV));
+        std::vector<double> rowU(hasDerivatives ? row.size() : 0);
+        std::vector<double> sums((hasDerivatives ? 12 : 4) * static_cast<size_t>(countV));
+        double* a[4];
+        double* au[4];
+        double* av[4];
+        for (int c = 0; c < 4; c++) {
+            a[c] = sums.data() + static_cast<size_t>(c) * countV;
+            au[c] = hasDerivatives ? sums.data() + static_cast<size_t>(4 + c) * countV : nullptr;
+            av[c] = hasDerivatives ? sums.data() + static_cast<size_t>(8 + c) * countV : nullptr;
+        }
+
+        for (int64_t i = begin; i < end; i++) {
+            const double* basisU = _basisU.data() + i * orderU;
+            const double* derivativeU = _derivativeU.data() + i * orderU;
+            std::fill(row.begin(), row.end(), 0.0);
+            std::fill(rowU.begin(), rowU.end(), 0.0);
+            for (int k = 0; k < orderU; k++) {
+                const double* controls = _controlPoints.data() + 4 * static_cast<size_t>(_firstU[i] + k) * _controlCountV;
+                const double n = basisU[k];
+                for (size_t c = 0; c < row.size(); c++) {
+                    row[c] += n * controls[c];
+                }
+                if (hasDerivatives) {
+                    const double d = derivativeU[k];
+                    for (size_t c = 0; c < rowU.size(); c++) {
+                        rowU[c] += d * controls[c];
+                    }
+                }
+            }
+
+            std::fill(sums.begin(), sums.end(), 0.0);
+            for (const Run& run : _runsV) {
+                for (int k = 0; k <= _degreeV; k++) {
+                    const double* basis = _basisV.data() + static_cast<size_t>(k) * countV;
+                    const double* derivative = _derivativeV.data() + static_cast<size_t>(k) * countV;
+                    const double* point = row.data() + 4 * static_cast<size_t>(run.First + k);
+                    for (int c = 0; c < 4; c++) {
+                        const double value = point[c];
+                        double* sum = a[c];
+                        for (int j = run.Begin; j < run.End; j++) {
+                            sum[j] += basis[j] * value;
+                        }
+                    }
+                    if (!hasDerivatives) {
+                        continue;
+                    }
+                    const double* pointU = rowU.data() + 4 * static_cast<size_t>(run.First + k);
+                    for (int c = 0; c < 4; c++) {
+                        const double value = point[c];
+                        const double valueU = pointU[c];
+                        double* sumU = au[c];
+                        double* sumV = av[c];
+                        for (int j = run.Begin; j < run.End; j++) {
+                            sumU[j] += basis[j] * valueU;
+                            sumV[j] += derivative[j] * value;
+                        }
+                    }
+                }
+            }
+
+            // Project from homogeneous space, derivatives by the quotient rule.
+            LNLib::XYZ* pointRow = points ? points + i * countV : nullptr;
+            for (int j = 0; j < countV; j++) {
+                const double w = a[3][j];
+                LNLib::XYZ point(a[0][j] / w, a[1][j] / w, a[2][j] / w);
+                if (pointRow) {
+                    pointRow[j] = point;
+                }
+                if (!hasDerivatives) {
+                    continue;
+                }
+                LNLib::XYZ su = (LNLib::XYZ(au[0][j], au[1][j], au[2][j]) - point * au[3][j]) / w;
+                LNLib::XYZ sv = (LNLib::XYZ(av[0][j], av[1][j], av[2][j]) - point * av[3][j]) / w;
+                const int64_t index = i * countV + j;
+                if (derivativesU) {
+                    derivativesU[index] = su;
+                }
+                if (derivativesV) {
+                    derivativesV[index] = sv;
+                }
+                if (normals) {
+                    LNLib::XYZ normal = su.CrossProduct(sv);
+                    double length = normal.Length();
+                    normals[index] = length > 1E-14 * su.Length() * sv.Length() && length > 0.0 ? normal / length : LNLib::XYZ(0, 0, 0);
+                }
+            }
+        }
+    });
+}
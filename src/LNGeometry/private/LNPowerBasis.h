@@ -0,0 +1,64 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+
+#include <algorithm>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	namespace LNPowerBasis
+	{
+		/// <summary>
+		/// Power basis coefficient a of a degree p Bezier polynomial is the sum of matrix[a][i] * P[i], see The NURBS Book Eq.6.6.
+		/// </summary>
+		inline std::vector<std::vector<double>> GetBezierToPowerMatrix(int degree)
+		{
+			std::vector<std::vector<double>> binomial(degree + 1, std::vector<double>(degree + 1, 0.0));
+			for (int n = 0; n <= degree; n++) {
+				binomial[n][0] = 1.0;
+				for (int k = 1; k <= n; k++) {
+					binomial[n][k] = binomial[n - 1][k - 1] + (k < n ? binomial[n - 1][k] : 0.0);
+				}
+			}
+			std::vector<std::vector<double>> matrix(degree + 1, std::vector<double>(degree + 1, 0.0));
+			for (int a = 0; a <= degree; a++) {
+				for (int i = 0; i <= a; i++) {
+					matrix[a][i] = binomial[degree][a] * binomial[a][i] * ((a - i) % 2 == 0 ? 1.0 : -1.0);
+				}
+			}
+			return matrix;
+		}
+
+		/// <summary>
+		/// Distinct knots of the domain [knotVector[degree], knotVector[controlPointsCount]].
+		/// </summary>
+		inline std::vector<double> GetDistinctKnots(const std::vector<double>& knotVector, int degree, int controlPointsCount)
+		{
+			std::vector<double> knots;
+			for (int i = degree; i <= controlPointsCount; i++) {
+				if (knots.empty() || knotVector[i] > knots.back()) {
+					knots.emplace_back(knotVector[i]);
+				}
+			}
+			return knots;
+		}
+
+		/// <summary>
+		/// Index of the knot interval containing parameter, which is clamped to the knots first.
+		/// </summary>
+		inline int FindInterval(const std::vector<double>& knots, double& parameter)
+		{
+			parameter = std::max(knots.front(), std::min(knots.back(), parameter));
+			int index = static_cast<int>(std::upper_bound(knots.begin(), knots.end(), parameter) - knots.begin()) - 1;
+			return std::max(0, std::min(static_cast<int>(knots.size()) - 2, index));
+		}
+	}
+}
@@ -0,0 +1,526 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNSurfaceBVH.h"
+#include "LNBezierSurfaceCache.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include "NurbsSurface.h"
+#include "LNParallel.h"
+#include "LNBVHBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <tuple>
+
+namespace
+{
+    /// Bound homogeneous control points projected to 3D, false if a weight is not positive.
+    template <typename PrimitiveType>
+    bool boundControlPoints(const LNLib::XYZW* points, int count, PrimitiveType& primitive) {
+        for (int i = 0; i < 3; i++) {
+            primitive.Min[i] = std::numeric_limits<double>::max();
+            primitive.Max[i] = std::numeric_limits<double>::lowest();
+        }
+        for (int k = 0; k < count; k++) {
+            double weight = points[k].W();
+            if (!(weight > 0.0)) {
+                return false;
+            }
+            for (int i = 0; i < 3; i++) {
+                double value = points[k][i] / weight;
+                primitive.Min[i] = std::min(primitive.Min[i], value);
+                primitive.Max[i] = std::max(primitive.Max[i], value);
+            }
+        }
+        return true;
+    }
+
+    void setCorner(const LNLib::XYZW& point, double* corner) {
+        for (int i = 0; i < 3; i++) {
+            corner[i] = point[i] / point.W();
+        }
+    }
+
+    /// One primitive per Bezier patch of cache, false (and no primitives) if a weight is not positive.
+    template <typename PrimitiveType>
+    bool getPatchPrimitives(const LNLibEx::LNBezierSurfaceCache& cache, int surface, std::vector<PrimitiveType>& primitives) {
+        const int degreeU = cache.GetDegreeU();
+        const int degreeV = cache.GetDegreeV();
+        const int rowSize = degreeV + 1;
+        primitives.resize(static_cast<size_t>(cache.GetPatchCountU()) * cache.GetPatchCountV());
+        for (int i = 0; i < cache.GetPatchCountU(); i++) {
+            for (int j = 0; j < cache.GetPatchCountV(); j++) {
+                const LNLib::XYZW* points = cache.GetPatchControlPoints(i, j);
+                PrimitiveType& primitive = primitives[static_cast<size_t>(i) * cache.GetPatchCountV() + j];
+                if (!boundControlPoints(points, (degreeU + 1) * rowSize, primitive)) {
+                    primitives.clear();
+                    return false;
+                }
+                setCorner(points[0], primitive.Corners[0]);
+                setCorner(points[degreeV], primitive.Corners[1]);
+                setCorner(points[degreeU * rowSize], primitive.Corners[2]);
+                setCorner(points[degreeU * rowSize + degreeV], primitive.Corners[3]);
+                primitive.Surface = surface;
+                primitive.PatchU = i;
+                primitive.PatchV = j;
+            }
+        }
+        return true;
+    }
+}
+
+bool LNLibEx::LNSurfaceBVH::Build(const std::vector<LNLib::LN_NurbsSurface>& surfaces, bool usePatchBounds, int maxLeafSize)
+{
+    *this = LNSurfaceBVH();
+
+    const int surfaceCount = static_cast<int>(surfaces.size());
+    std::vector<std::vector<Primitive>> surfacePrimitives(surfaceCount);
+    LNParallel::ForDynamic(0, surfaceCount, [&](int64_t index) {
+        const LNLib::LN_NurbsSurface& surface = surfaces[index];
+        std::vector<Primitive>& primitives = surfacePrimitives[index];
+        if (usePatchBounds) {
+            LNBezierSurfaceCache cache;
+            if (cache.Build(surface)) {
+                getPatchPrimitives(cache, static_cast<int>(index), primitives);
+            }
+            return;
+        }
+
+        try {
+            LNLib::NurbsSurface::Check(surface);
+        }
+        catch (const std::exception&) {
+            return;
+        }
+        const std::vector<std::vector<LNLib::XYZW>>& controlPoints = surface.ControlPoints;
+        LNBVHBuilder::Bounds box;
+        Primitive primitive;
+        for (const std::vector<LNLib::XYZW>& row : controlPoints) {
+            if (row.empty() || !boundControlPoints(row.data(), static_cast<int>(row.size()), primitive)) {
+                return;
+            }
+            box.Grow(primitive.Min, primitive.Max);
+        }
+        std::copy(box.Min, box.Min + 3, primitive.Min);
+        std::copy(box.Max, box.Max + 3, primitive.Max);
+        // Clamped knot vectors interpolate the corner control points.
+        setCorner(controlPoints.front().front(), primitive.Corners[0]);
+        setCorner(controlPoints.front().back(), primitive.Corners[1]);
+        setCorner(controlPoints.back().front(), primitive.Corners[2]);
+        setCorner(controlPoints.back().back(), primitive.Corners[3]);
+        primitive.Surface = static_cast<int>(index);
+        primitive.PatchU = 0;
+        primitive.PatchV = 0;
+        primitives.emplace_back(primitive);
+    });
+    return BuildNodes(surfacePrimitives, maxLeafSize);
+}
+
+bool LNLibEx::LNSurfaceBVH::Build(const std::vector<LNBezierSurfaceCache>& caches, int maxLeafSize)
+{
+    *this = LNSurfaceBVH();
+
+    const int surfaceCount = static_cast<int>(caches.size());
+    std::vector<std::vector<Primitive>> surfacePrimitives(surfaceCount);
+    LNParallel::ForDynamic(0, surfaceCount, [&](int64_t index) {
+        if (!caches[index].IsEmpty()) {
+            getPatchPrimitives(caches[index], static_cast<int>(index), surfacePrimitives[index]);
+        }
+    });
+    return BuildNodes(surfacePrimitives, maxLeafSize);
+}
+
+bool LNLibEx::LNSurfaceBVH::BuildNodes(std::vector<std::vector<Primitive>>& surfacePrimitives, int maxLeafSize)
+{
+    const int surfaceCount = static_cast<int>(surfacePrimitives.size());
+    bool isValid = true;
+    size_t primitiveCount = 0;
+    _surfaceBounds.resize(static_cast<size_t>(6) * surfaceCount);
+    for (int index = 0; index < surfaceCount; index++) {
+        LNBVHBuilder::Bounds box;
+        for (const Primitive& primitive : surfacePrimitives[index]) {
+            box.Grow(primitive.Min, primitive.Max);
+        }
+        std::copy(box.Min, box.Min + 3, _surfaceBounds.begin() + 6 * index);
+        std::copy(box.Max, box.Max + 3, _surfaceBounds.begin() + 6 * index + 3);
+        isValid = isValid && !surfacePrimitives[index].empty();
+        primitiveCount += surfacePrimitives[index].size();
+    }
+    if (primitiveCount == 0) {
+        return isValid;
+    }
+
+    std::vector<Primitive> primitives;
+    primitives.reserve(primitiveCount);
+    for (std::vector<Primitive>& list : surfacePrimitives) {
+        primitives.insert(primitives.end(), list.begin(), list.end());
+        std::vector<Primitive>().swap(list);
+    }
+
+    const int count = static_cast<int>(primitiveCount);
+    std::vector<LNBVHBuilder::Primitive> buildPrimitives(count);
+    std::vector<int> indices(count);
+    for (int i = 0; i < count; i++) {
+        LNBVHBuilder::Primitive& buildPrimitive = buildPrimitives[i];
+        buildPrimitive.Box.Grow(primitives[i].Min, primitives[i].Max);
+        for (int axis = 0; axis < 3; axis++) {
+            buildPrimitive.Centroid[axis] = 0.5 * (primitives[i].Min[axis] + primitives[i].Max[axis]);
+        }
+        indices[i] = i;
+    }
+
+    LNBVHBuilder::Builder<Node> builder(buildPrimitives, indices, maxLeafSize);
+    _nodes.reserve(2 * count / std::max(1, maxLeafSize) + 1);
+    builder.Build(0, count, 0, _nodes);
+
+    _primitives.resize(count);
+    for (int i = 0; i < count; i++) {
+        _primitives[i] = primitives[indices[i]];
+    }
+    return isValid;
+}
+
+bool LNLibEx::LNSurfaceBVH::IsEmpty() const
+{
+    return _nodes.empty();
+}
+
+int LNLibEx::LNSurfaceBVH::GetNodeCount() const
+{
+    return static_cast<int>(_nodes.size());
+}
+
+int LNLibEx::LNSurfaceBVH::GetPatchCount() const
+{
+    return static_cast<int>(_primitives.size());
+}
+
+bool LNLibEx::LNSurfaceBVH::GetBounds(int surface, LNLib::XYZ& minimum, LNLib::XYZ& maximum) const
+{
+    if (surface < 0 || static_cast<size_t>(surface) * 6 >= _surfaceBounds.size()) {
+        return false;
+    }
+    const double* bounds = _surfaceBounds.data() + 6 * static_cast<size_t>(surface);
+    if (bounds[0] > bounds[3]) {
+        return false;
+    }
+    minimum = LNLib::XYZ(bounds[0], bounds[1], bounds[2]);
+    maximum = LNLib::XYZ(bounds[3], bounds[4], bounds[5]);
+    return true;
+}
+
+namespace
+{
+    struct Ray
+    {
+        double Origin[3];
+        double Inverse[3];
+    };
+
+    Ray makeRay(const LNLib::XYZ& origin, const LNLib::XYZ& direction) {
+        Ray ray;
+        for (int i = 0; i < 3; i++) {
+            double component = std::fabs(direction[i]) < 1E-30 ? std::copysign(1E-30, direction[i]) : direction[i];
+            ray.Origin[i] = origin[i];
+            ray.Inverse[i] = 1.0 / component;
+        }
+        return ray;
+    }
+
+    template <typename BoxType>
+    inline bool intersectBox(const BoxType& box, const Ray& ray, double maxT, double& nearT) {
+        double entryT = 0.0;
+        double exitT = maxT;
+        for (int i = 0; i < 3; i++) {
+            double t0 = (box.Min[i] - ray.Origin[i]) * ray.Inverse[i];
+            double t1 = (box.Max[i] - ray.Origin[i]) * ray.Inverse[i];
+            entryT = std::max(entryT, std::min(t0, t1));
+            exitT = std::min(exitT, std::max(t0, t1));
+        }
+        nearT = entryT;
+        return entryT <= exitT;
+    }
+
+    template <typename BoxType>
+    inline double boxSquaredDistance(const BoxType& box, const double* point) {
+        double result = 0.0;
+        for (int i = 0; i < 3; i++) {
+            double d = std::max({ box.Min[i] - point[i], 0.0, point[i] - box.Max[i] });
+            result += d * d;
+        }
+        return result;
+    }
+
+    template <typename NodeType, typename PrimitiveType>
+    void intersectTree(const std::vector<NodeType>& nodes, const std::vector<PrimitiveType>& primitives,
+                       const LNLib::XYZ& origin, const LNLib::XYZ& direction, double maxDistance,
+                       std::vector<int>& stack, std::vector<LNLibEx::LNPatchReference>& patches) {
+        patches.clear();
+        if (nodes.empty()) {
+            return;
+        }
+
+        Ray ray = makeRay(origin, direction);
+        double nearT;
+        stack.clear();
+        stack.emplace_back(0);
+        while (!stack.empty()) {
+            int index = stack.back();
+            stack.pop_back();
+            const NodeType& node = nodes[index];
+            if (!intersectBox(node, ray, maxDistance, nearT)) {
+                continue;
+            }
+            if (node.Count > 0) {
+                for (uint32_t i = node.Offset; i < node.Offset + node.Count; i++) {
+                    const PrimitiveType& primitive = primitives[i];
+                    if (intersectBox(primitive, ray, maxDistance, nearT)) {
+                        LNLibEx::LNPatchReference patch;
+                        patch.Surface = primitive.Surface;
+                        patch.PatchU = primitive.PatchU;
+                        patch.PatchV = primitive.PatchV;
+                        patch.Distance = nearT;
+                        patches.emplace_back(patch);
+                    }
+                }
+                continue;
+            }
+            stack.emplace_back(index + static_cast<int>(node.Offset));
+            stack.emplace_back(index + 1);
+        }
+
+        std::sort(patches.begin(), patches.end(), [](const LNLibEx::LNPatchReference& a, const LNLibEx::LNPatchReference& b) {
+            return a.Distance < b.Distance;
+        });
+    }
+}
+
+void LNLibEx::LNSurfaceBVH::Intersect(const LNLib::XYZ& origin, const LNLib::XYZ& direction, std::vector<LNPatchReference>& patches, double maxDistance) const
+{
+    std::vector<int> stack;
+    stack.reserve(64);
+    intersectTree(_nodes, _primitives, origin, direction, maxDistance, stack, patches);
+}
+
+void LNLibEx::LNSurfaceBVH::Intersect(const std::vector<LNLib::XYZ>& origins, const std::vector<LNLib::XYZ>& directions, std::vector<std::vector<LNPatchReference>>& patches, double maxDistance) const
+{
+    const int64_t count = static_cast<int64_t>(std::min(origins.size(), directions.size()));
+    patches.assign(count, std::vector<LNPatchReference>());
+    LNParallel::ForEachChunk(0, count, 256, [&](int, int64_t begin, int64_t end) {
+        std::vector<int> stack;
+        stack.reserve(64);
+        for (int64_t i = begin; i < end; i++) {
+            intersectTree(_nodes, _primitives, origins[i], directions[i], maxDistance, stack, patches[i]);
+        }
+    });
+}
+
+void LNLibEx::LNSurfaceBVH::GetSurfaces(const LNLib::XYZ& minimum, const LNLib::XYZ& maximum, std::vector<int>& surfaces) const
+{
+    surfaces.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+
+    auto overlaps = [&](const double* boxMin, const double* boxMax) {
+        for (int i = 0; i < 3; i++) {
+            if (boxMin[i] > maximum[i] || boxMax[i] < minimum[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.emplace_back(0);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+        if (!overlaps(node.Min, node.Max)) {
+            continue;
+        }
+        if (node.Count > 0) {
+            for (uint32_t i = node.Offset; i < node.Offset + node.Count; i++) {
+                if (overlaps(_primitives[i].Min, _primitives[i].Max)) {
+                    surfaces.emplace_back(_primitives[i].Surface);
+                }
+            }
+            continue;
+        }
+        stack.emplace_back(index + static_cast<int>(node.Offset));
+        stack.emplace_back(index + 1);
+    }
+
+    std::sort(surfaces.begin(), surfaces.end());
+    surfaces.erase(std::unique(surfaces.begin(), surfaces.end()), surfaces.end());
+}
+
+void LNLibEx::LNSurfaceBVH::GetNearestPatches(const LNLib::XYZ& point, std::vector<LNPatchReference>& patches, double maxDistance) const
+{
+    patches.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+
+    const double query[3] = { point[0], point[1], point[2] };
+    // Upper bound of the closest distance, from patch corners which lie on the surfaces.
+    double boundSquared = maxDistance * maxDistance;
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.emplace_back(0);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+        if (boxSquaredDistance(node, query) > boundSquared) {
+            continue;
+        }
+        if (node.Count > 0) {
+            for (uint32_t i = node.Offset; i < node.Offset + node.Count; i++) {
+                const Primitive& primitive = _primitives[i];
+                double squared = boxSquaredDistance(primitive, query);
+                if (squared > boundSquared) {
+                    continue;
+                }
+                for (const double* corner : primitive.Corners) {
+                    double dx = corner[0] - query[0];
+                    double dy = corner[1] - query[1];
+                    double dz = corner[2] - query[2];
+                    boundSquared = std::min(boundSquared, dx * dx + dy * dy + dz * dz);
+                }
+                LNPatchReference patch;
+                patch.Surface = primitive.Surface;
+                patch.PatchU = primitive.PatchU;
+                patch.PatchV = primitive.PatchV;
+                patch.Distance = squared;
+                patches.emplace_back(patch);
+            }
+            continue;
+        }
+
+        int left = index + 1;
+        int right = index + static_cast<int>(node.Offset);
+        if (boxSquaredDistance(_nodes[left], query) < boxSquaredDistance(_nodes[right], query)) {
+            stack.emplace_back(right);
+            stack.emplace_back(left);
+        }
+        else {
+            stack.emplace_back(left);
+            stack.emplace_back(right);
+        }
+    }
+
+    patches.erase(std::remove_if(patches.begin(), patches.end(), [&](const LNPatchReference& patch) {
+        return patch.Distance > boundSquared;
+    }), patches.end());
+    for (LNPatchReference& patch : patches) {
+        patch.Distance = std::sqrt(patch.Distance);
+    }
+    std::sort(patches.begin(), patches.end(), [](const LNPatchReference& a, const LNPatchReference& b) {
+        return a.Distance < b.Distance;
+    });
+}
+
+namespace
+{
+    typedef std::pair<LNLibEx::LNPatchReference, LNLibEx::LNPatchReference> PatchPair;
+
+    LNLibEx::LNPatchReference getReference(int surface, int patchU, int patchV) {
+        LNLibEx::LNPatchReference reference;
+        reference.Surface = surface;
+        reference.PatchU = patchU;
+        reference.PatchV = patchV;
+        return reference;
+    }
+
+    /// Overlapping patch pairs of surfaces a and b, or of all surface pairs (lower index first) when a is negative.
+    template <typename NodeType, typename PrimitiveType>
+    void collectOverlaps(const std::vector<NodeType>& nodes, const std::vector<PrimitiveType>& primitives, int a, int b, double tolerance, std::vector<PatchPair>& pairs) {
+        pairs.clear();
+        if (nodes.empty()) {
+            return;
+        }
+        const int64_t count = static_cast<int64_t>(primitives.size());
+        std::vector<std::vector<PatchPair>> chunkPairs(LNLibEx::LNParallel::GetChunkCount(0, count, 64));
+        LNLibEx::LNParallel::ForEachChunk(0, count, 64, [&](int chunk, int64_t begin, int64_t end) {
+            std::vector<PatchPair>& result = chunkPairs[chunk];
+            std::vector<int> stack;
+            stack.reserve(64);
+            for (int64_t i = begin; i < end; i++) {
+                const PrimitiveType& primitive = primitives[i];
+                if (a >= 0 && primitive.Surface != a) {
+                    continue;
+                }
+                auto overlaps = [&](const double* boxMin, const double* boxMax) {
+                    for (int k = 0; k < 3; k++) {
+                        if (boxMin[k] > primitive.Max[k] + tolerance || boxMax[k] < primitive.Min[k] - tolerance) {
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+
+                stack.clear();
+                stack.emplace_back(0);
+                while (!stack.empty()) {
+                    int index = stack.back();
+                    stack.pop_back();
+                    const NodeType& node = nodes[index];
+                    if (!overlaps(node.Min, node.Max)) {
+                        continue;
+                    }
+                    if (node.Count == 0) {
+                        stack.emplace_back(index + static_cast<int>(node.Offset));
+                        stack.emplace_back(index + 1);
+                        continue;
+                    }
+                    for (uint32_t j = node.Offset; j < node.Offset + node.Count; j++) {
+                        const PrimitiveType& other = primitives[j];
+                        bool isCandidate = a >= 0 ? other.Surface == b : other.Surface > primitive.Surface;
+                        if (isCandidate && overlaps(other.Min, other.Max)) {
+                            result.emplace_back(getReference(primitive.Surface, primitive.PatchU, primitive.PatchV),
+                                                getReference(other.Surface, other.PatchU, other.PatchV));
+                        }
+                    }
+                }
+            }
+        });
+
+        for (std::vector<PatchPair>& result : chunkPairs) {
+            pairs.insert(pairs.end(), result.begin(), result.end());
+        }
+        auto key = [](const PatchPair& pair) {
+            return std::make_tuple(pair.first.Surface, pair.second.Surface, pair.first.PatchU, pair.first.PatchV, pair.second.PatchU, pair.second.PatchV);
+        };
+        std::sort(pairs.begin(), pairs.end(), [&](const PatchPair& first, const PatchPair& second) {
+            return key(first) < key(second);
+        });
+    }
+}
+
+void LNLibEx::LNSurfaceBVH::GetOverlappingPatches(std::vector<std::pair<LNPatchReference, LNPatchReference>>& pairs, double tolerance) const
+{
+    collectOverlaps(_nodes, _primitives, -1, -1, tolerance, pairs);
+}
+
+void LNLibEx::LNSurfaceBVH::GetOverlappingPatches(int a, int b, std::vector<std::pair<LNPatchReference, LNPatchReference>>& pairs, double tolerance) const
+{
+    if (a < 0 || b < 0 || a == b) {
+        pairs.clear();
+        return;
+    }
+    collectOverlaps(_nodes, _primitives, a, b, tolerance, pairs);
+}
@@ -0,0 +1,652 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNSurfaceIntersector.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include "UV.h"
+#include "LNBezierSubdivision.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+    const int MaxIterations = 20;
+    const int MaxLeavesPerPair = 4096;
+    const int MaxPointsPerCurve = 100000;
+    const double FlatnessRatio = 5E-2;
+
+    typedef std::array<double, 4> PairParameter;
+    typedef LNLibEx::LNBezierSubdivision::SubPatch SubPatch;
+
+    struct PairPoint
+    {
+        LNLib::XYZ A;
+        LNLib::XYZ DerivativeUA;
+        LNLib::XYZ DerivativeVA;
+        LNLib::XYZ B;
+        LNLib::XYZ DerivativeUB;
+        LNLib::XYZ DerivativeVB;
+    };
+
+    struct Domain
+    {
+        // u, v on surface A then u, v on surface B.
+        double Min[4];
+        double Max[4];
+
+        Domain(const LNLibEx::LNBezierSurfaceCache& a, const LNLibEx::LNBezierSurfaceCache& b) {
+            const std::vector<double>* knots[4] = { &a.GetKnotsU(), &a.GetKnotsV(), &b.GetKnotsU(), &b.GetKnotsV() };
+            for (int k = 0; k < 4; k++) {
+                Min[k] = knots[k]->front();
+                Max[k] = knots[k]->back();
+            }
+        }
+
+        double Slack(int k) const {
+            return 1E-12 * (Max[k] - Min[k]);
+        }
+
+        bool IsInside(const double* x) const {
+            for (int k = 0; k < 4; k++) {
+                if (x[k] < Min[k] - Slack(k) || x[k] > Max[k] + Slack(k)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void Clamp(double* x) const {
+            for (int k = 0; k < 4; k++) {
+                x[k] = std::max(Min[k], std::min(Max[k], x[k]));
+            }
+        }
+    };
+
+    void evaluate(const LNLibEx::LNBezierSurfaceCache& a, const LNLibEx::LNBezierSurfaceCache& b, const double* x, PairPoint& point) {
+        a.GetDerivatives(LNLib::UV(x[0], x[1]), point.A, point.DerivativeUA, point.DerivativeVA);
+        b.GetDerivatives(LNLib::UV(x[2], x[3]), point.B, point.DerivativeUB, point.DerivativeVB);
+    }
+
+    /// Solve matrix * result = values in place by Gaussian elimination with partial pivoting.
+    bool solveLinear(double matrix[4][4], double* values, int size) {
+        for (int column = 0; column < size; column++) {
+            int pivot = column;
+            for (int row = column + 1; row < size; row++) {
+                if (std::fabs(matrix[row][column]) > std::fabs(matrix[pivot][column])) {
+                    pivot = row;
+                }
+            }
+            if (!(std::fabs(matrix[pivot][column]) > 1E-300)) {
+                return false;
+            }
+            std::swap(matrix[pivot], matrix[column]);
+            std::swap(values[pivot], values[column]);
+            for (int row = column + 1; row < size; row++) {
+                double factor = matrix[row][column] / matrix[column][column];
+                for (int k = column; k < size; k++) {
+                    matrix[row][k] -= factor * matrix[column][k];
+                }
+                values[row] -= factor * values[column];
+            }
+        }
+        for (int row = size - 1; row >= 0; row--) {
+            for (int k = row + 1; k < size; k++) {
+                values[row] -= matrix[row][k] * values[k];
+            }
+            values[row] /= matrix[row][row];
+        }
+        return true;
+    }
+
+    /// Jacobian rows of A(u, v) - B(s, t).
+    void fillJacobian(const PairPoint& point, double matrix[4][4]) {
+        for (int k = 0; k < 3; k++) {
+            matrix[k][0] = point.DerivativeUA[k];
+            matrix[k][1] = point.DerivativeVA[k];
+            matrix[k][2] = -point.DerivativeUB[k];
+            matrix[k][3] = -point.DerivativeVB[k];
+        }
+    }
+
+    /// Move x onto the intersection by minimum norm Newton steps (3 equations, 4 unknowns).
+    bool refine(const LNLibEx::LNBezierSurfaceCache& a, const LNLibEx::LNBezierSurfaceCache& b, const Domain& domain, double tolerance, double* x) {
+        PairPoint point;
+        for (int iteration = 0; iteration <= MaxIterations; iteration++) {
+            evaluate(a, b, x, point);
+            LNLib::XYZ difference = point.A - point.B;
+            if (difference.Length() < tolerance) {
+                return true;
+            }
+            if (iteration == MaxIterations) {
+                break;
+            }
+
+            double jacobian[4][4];
+            fillJacobian(point, jacobian);
+            double normal[4][4] = {};
+            double values[4] = { difference[0], difference[1], difference[2], 0.0 };
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) {
+                    for (int k = 0; k < 4; k++) {
+                        normal[i][j] += jacobian[i][k] * jacobian[j][k];
+                    }
+                }
+            }
+            if (!solveLinear(normal, values, 3)) {
+                return false;
+            }
+            for (int k = 0; k < 4; k++) {
+                x[k] -= jacobian[0][k] * values[0] + jacobian[1][k] * values[1] + jacobian[2][k] * values[2];
+            }
+            domain.Clamp(x);
+        }
+        return false;
+    }
+
+    /// Unit tangent of the intersection, false where the surfaces touch tangentially.
+    bool getTangent(const PairPoint& point, LNLib::XYZ& tangent) {
+        LNLib::XYZ normalA = point.DerivativeUA.CrossProduct(point.DerivativeVA);
+        LNLib::XYZ normalB = point.DerivativeUB.CrossProduct(point.DerivativeVB);
+        LNLib::XYZ direction = normalA.CrossProduct(normalB);
+        double length = direction.Length();
+        if (!(length > 1E-8 * normalA.Length() * normalB.Length())) {
+            return false;
+        }
+        tangent = direction / length;
+        return true;
+    }
+
+    /// Parameter change (du, dv) whose first order image is closest to delta.
+    void predict(const LNLib::XYZ& derivativeU, const LNLib::XYZ& derivativeV, const LNLib::XYZ& delta, double* result) {
+        double uu = derivativeU.DotProduct(derivativeU);
+        double uv = derivativeU.DotProduct(derivativeV);
+        double vv = derivativeV.DotProduct(derivativeV);
+        double determinant = uu * vv - uv * uv;
+        if (!(std::fabs(determinant) > 1E-300)) {
+            result[0] = 0.0;
+            result[1] = 0.0;
+            return;
+        }
+        double du = derivativeU.DotProduct(delta);
+        double dv = derivativeV.DotProduct(delta);
+        result[0] = (du * vv - dv * uv) / determinant;
+        result[1] = (uu * dv - uv * du) / determinant;
+    }
+
+    double segmentDistance(const LNLib::XYZ& point, const LNLib::XYZ& start, const LNLib::XYZ& end) {
+        LNLib::XYZ segment = end - start;
+        double squared = segment.DotProduct(segment);
+        double t = squared > 0.0 ? std::max(0.0, std::min(1.0, (point - start).DotProduct(segment) / squared)) : 0.0;
+        return point.Distance(start + segment * t);
+    }
+
+    class SeedFinder
+    {
+    private:
+
+        const LNLibEx::LNBezierSurfaceCache& _a;
+        const LNLibEx::LNBezierSurfaceCache& _b;
+        const LNLibEx::LNIntersectionOptions& _options;
+        Domain _domain;
+        int _leafCount = 0;
+
+        bool Overlaps(const SubPatch& a, const SubPatch& b) const {
+            const double tolerance = _options.Tolerance;
+            for (int i = 0; i < 3; i++) {
+                if (a.Min[i] > b.Max[i] + tolerance || b.Min[i] > a.Max[i] + tolerance) {
+                    return false;
+                }
+            }
+
+            // Fat planes separate far more pairs than boxes once the patches are nearly flat.
+            const SubPatch* patches[2] = { &a, &b };
+            for (int k = 0; k < 2; k++) {
+                const SubPatch& patch = *patches[k];
+                const SubPatch& other = *patches[1 - k];
+                double offsets[2];
+                LNLibEx::LNBezierSubdivision::GetOffsets(other, patch.Normal, offsets);
+                if (offsets[0] > patch.Offsets[1] + tolerance || offsets[1] < patch.Offsets[0] - tolerance) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void Search(const SubPatch& a, const SubPatch& b, int depth, std::vector<PairParameter>& seeds) {
+            if (_leafCount >= MaxLeavesPerPair || !Overlaps(a, b)) {
+                return;
+            }
+            bool isFlatA = LNLibEx::LNBezierSubdivision::IsFlat(a, FlatnessRatio);
+            bool isFlatB = LNLibEx::LNBezierSubdivision::IsFlat(b, FlatnessRatio);
+            if ((isFlatA && isFlatB) || depth >= _options.MaxSubdivisionDepth) {
+                _leafCount++;
+                PairParameter x = {
+                    0.5 * (a.Domain[0][0] + a.Domain[0][1]), 0.5 * (a.Domain[1][0] + a.Domain[1][1]),
+                    0.5 * (b.Domain[0][0] + b.Domain[0][1]), 0.5 * (b.Domain[1][0] + b.Domain[1][1])
+                };
+                if (refine(_a, _b, _domain, _options.Tolerance, x.data())) {
+                    seeds.emplace_back(x);
+                }
+                return;
+            }
+
+            bool isSplitA = !isFlatA && (isFlatB || LNLibEx::LNBezierSubdivision::GetDiagonal(a) >= LNLibEx::LNBezierSubdivision::GetDiagonal(b));
+            const SubPatch& patch = isSplitA ? a : b;
+            const LNLibEx::LNBezierSurfaceCache& cache = isSplitA ? _a : _b;
+            int direction = patch.Lengths[0] >= patch.Lengths[1] ? 0 : 1;
+            SubPatch first;
+            SubPatch second;
+            LNLibEx::LNBezierSubdivision::Split(patch, cache.GetDegreeU(), cache.GetDegreeV(), direction, first, second);
+            if (isSplitA) {
+                Search(first, b, depth + 1, seeds);
+                Search(second, b, depth + 1, seeds);
+            }
+            else {
+                Search(a, first, depth + 1, seeds);
+                Search(a, second, depth + 1, seeds);
+            }
+        }
+
+    public:
+
+        SeedFinder(const LNLibEx::LNBezierSurfaceCache& a, const LNLibEx::LNBezierSurfaceCache& b, const LNLibEx::LNIntersectionOptions& options) :
+            _a(a), _b(b), _options(options), _domain(a, b) {}
+
+        void Process(const int* patchA, const int* patchB, std::vector<PairParameter>& seeds) {
+            SubPatch a;
+            SubPatch b;
+            LNLibEx::LNBezierSubdivision::Initialize(a, _a, patchA[0], patchA[1]);
+            LNLibEx::LNBezierSubdivision::Initialize(b, _b, patchB[0], patchB[1]);
+            _leafCount = 0;
+            Search(a, b, 0, seeds);
+        }
+    };
+}
+
+namespace
+{
+    struct Marker
+    {
+        PairParameter Parameter;
+        PairPoint Point;
+        LNLib::XYZ Tangent;
+    };
+
+    enum class MarchEnd
+    {
+        Closed,
+        Boundary,
+        Stopped
+    };
+
+    class CurveTracer
+    {
+    private:
+
+        const LNLibEx::LNBezierSurfaceCache& _a;
+        const LNLibEx::LNBezierSurfaceCache& _b;
+        const LNLibEx::LNIntersectionOptions& _options;
+        Domain _domain;
+        double _maxStep;
+        double _minStep;
+
+        /// Evaluate marker at parameter, false where the tangent is undefined.
+        bool Set(const PairParameter& parameter, Marker& marker) const {
+            marker.Parameter = parameter;
+            evaluate(_a, _b, parameter.data(), marker.Point);
+            return getTangent(marker.Point, marker.Tangent);
+        }
+
+        /// Newton iteration on A - B = 0 plus either the plane through origin normal to normal,
+        /// or parameter fixedIndex held at fixedValue.
+        bool Correct(PairParameter& x, const LNLib::XYZ& origin, const LNLib::XYZ& normal, int fixedIndex, double fixedValue) const {
+            PairPoint point;
+            for (int iteration = 0; iteration <= MaxIterations; iteration++) {
+                _domain.Clamp(x.data());
+                if (fixedIndex >= 0) {
+                    x[fixedIndex] = fixedValue;
+                }
+                evaluate(_a, _b, x.data(), point);
+                LNLib::XYZ difference = point.A - point.B;
+                double planeDistance = fixedIndex < 0 ? normal.DotProduct(point.A - origin) : 0.0;
+                if (difference.Length() < _options.Tolerance && std::fabs(planeDistance) < _options.Tolerance) {
+                    return true;
+                }
+                if (iteration == MaxIterations) {
+                    break;
+                }
+
+                double jacobian[4][4];
+                fillJacobian(point, jacobian);
+                double values[4] = { -difference[0], -difference[1], -difference[2], -planeDistance };
+                if (fixedIndex < 0) {
+                    jacobian[3][0] = normal.DotProduct(point.DerivativeUA);
+                    jacobian[3][1] = normal.DotProduct(point.DerivativeVA);
+                    jacobian[3][2] = 0.0;
+                    jacobian[3][3] = 0.0;
+                }
+                else {
+                    for (int k = 0; k < 4; k++) {
+                        jacobian[3][k] = k == fixedIndex ? 1.0 : 0.0;
+                    }
+                }
+                if (!solveLinear(jacobian, values, 4)) {
+                    return false;
+                }
+                for (int k = 0; k < 4; k++) {
+                    x[k] += values[k];
+                }
+            }
+            return false;
+        }
+
+        /// First parameter reaching a domain bound on the way from from to to, as fraction of the way.
+        bool FindExit(const PairParameter& from, const PairParameter& to, int& index, double& bound, double& fraction) const {
+            index = -1;
+            fraction = 1.0;
+            for (int k = 0; k < 4; k++) {
+                double slack = _domain.Slack(k);
+                double limit;
+                if (to[k] <= _domain.Min[k] + slack && from[k] > _domain.Min[k] + slack) {
+                    limit = _domain.Min[k];
+                }
+                else if (to[k] >= _domain.Max[k] - slack && from[k] < _domain.Max[k] - slack) {
+                    limit = _domain.Max[k];
+                }
+                else {
+                    continue;
+                }
+                double candidate = std::max(0.0, std::min(1.0, (limit - from[k]) / (to[k] - from[k])));
+                if (index < 0 || candidate < fraction) {
+                    index = k;
+                    bound = limit;
+                    fraction = candidate;
+                }
+            }
+            return index >= 0;
+        }
+
+        MarchEnd March(const Marker& seed, bool isForward, std::vector<Marker>& markers) const {
+            markers.clear();
+            Marker current = seed;
+            if (!isForward) {
+                current.Tangent = -current.Tangent;
+            }
+
+            const double closeDistance = 2.0 * _options.ChordalTolerance + 10.0 * _options.Tolerance;
+            double step = 0.25 * _maxStep;
+            while (static_cast<int>(markers.size()) < MaxPointsPerCurve) {
+                const PairPoint& point = current.Point;
+                LNLib::XYZ delta = current.Tangent * step;
+                PairParameter x = current.Parameter;
+                predict(point.DerivativeUA, point.DerivativeVA, delta, x.data());
+                predict(point.DerivativeUB, point.DerivativeVB, delta, x.data() + 2);
+                for (int k = 0; k < 4; k++) {
+                    x[k] += current.Parameter[k];
+                }
+
+                // Evaluation clamps to the domain, so a curve leaving a surface shows as a prediction beyond
+                // the boundary or as a correction that stalls on it. Either way land on that boundary.
+                PairParameter predicted = x;
+                LNLib::XYZ origin = point.A + delta;
+                bool isCorrected = Correct(x, origin, current.Tangent, -1, 0.0);
+                int index;
+                double bound;
+                double fraction;
+                bool isPredictedExit = FindExit(current.Parameter, predicted, index, bound, fraction);
+                if (isPredictedExit || (!isCorrected && FindExit(current.Parameter, x, index, bound, fraction))) {
+                    const PairParameter& target = isPredictedExit ? predicted : x;
+                    PairParameter landing;
+                    for (int k = 0; k < 4; k++) {
+                        landing[k] = current.Parameter[k] + fraction * (target[k] - current.Parameter[k]);
+                    }
+                    Marker last;
+                    if (Correct(landing, origin, current.Tangent, index, bound) && _domain.IsInside(landing.data())) {
+                        double angle = Set(landing, last) ? std::acos(std::min(1.0, std::fabs(last.Tangent.DotProduct(current.Tangent)))) : 0.0;
+                        double distance = last.Point.A.Distance(point.A);
+                        bool isFine = angle <= _options.AngleTolerance && distance * angle / 8.0 <= _options.ChordalTolerance;
+                        if (distance <= 2.0 * step && (isFine || step <= _minStep)) {
+                            if (distance > 10.0 * _options.Tolerance) {
+                                markers.emplace_back(last);
+                            }
+                            else if (!markers.empty()) {
+                                markers.back() = last;
+                            }
+                            return MarchEnd::Boundary;
+                        }
+                    }
+                    if (step <= _minStep) {
+                        return MarchEnd::Boundary;
+                    }
+                    step = std::max(_minStep, 0.5 * step);
+                    continue;
+                }
+                if (!isCorrected) {
+                    if (step <= _minStep) {
+                        return MarchEnd::Stopped;
+                    }
+                    step = std::max(_minStep, 0.5 * step);
+                    continue;
+                }
+
+                Marker next;
+                if (!Set(x, next)) {
+                    return MarchEnd::Stopped;
+                }
+                if (next.Tangent.DotProduct(current.Tangent) < 0.0) {
+                    next.Tangent = -next.Tangent;
+                }
+                double angle = std::acos(std::max(-1.0, std::min(1.0, next.Tangent.DotProduct(current.Tangent))));
+                double chord = next.Point.A.Distance(point.A);
+                if ((angle > _options.AngleTolerance || chord * angle / 8.0 > _options.ChordalTolerance) && step > _minStep) {
+                    step = std::max(_minStep, 0.5 * step);
+                    continue;
+                }
+
+                if (markers.size() >= 2 && (seed.Point.A - point.A).DotProduct(current.Tangent) > 0.0 &&
+                    segmentDistance(seed.Point.A, point.A, next.Point.A) <= closeDistance) {
+                    return MarchEnd::Closed;
+                }
+                markers.emplace_back(next);
+                current = next;
+
+                // Sagitta of an arc is chord * angle / 8.
+                double limit = _maxStep;
+                if (angle > 1E-12) {
+                    limit = std::min(std::sqrt(8.0 * _options.ChordalTolerance * chord / angle), _options.AngleTolerance * chord / angle);
+                }
+                step = std::max(_minStep, std::min({ _maxStep, 2.0 * step, 0.9 * limit }));
+            }
+            return MarchEnd::Stopped;
+        }
+
+        static double Distance(const LNLibEx::LNIntersectionCurve& curve, const LNLib::XYZ& point) {
+            const std::vector<LNLibEx::LNIntersectionPoint>& points = curve.Points;
+            double result = points.front().Point.Distance(point);
+            for (size_t i = 1; i < points.size(); i++) {
+                result = std::min(result, segmentDistance(point, points[i - 1].Point, points[i].Point));
+            }
+            if (curve.IsClosed) {
+                result = std::min(result, segmentDistance(point, points.back().Point, points.front().Point));
+            }
+            return result;
+        }
+
+    public:
+
+        CurveTracer(const LNLibEx::LNBezierSurfaceCache& a, const LNLibEx::LNBezierSurfaceCache& b, const LNLibEx::LNIntersectionOptions& options, double maxStep) :
+            _a(a), _b(b), _options(options), _domain(a, b), _maxStep(maxStep), _minStep(std::max(10.0 * options.Tolerance, 1E-6 * maxStep)) {}
+
+        void Process(const std::vector<PairParameter>& seeds, int surfaceA, int surfaceB, std::vector<LNLibEx::LNIntersectionCurve>& curves) const {
+            const double seedDistance = 2.0 * _options.ChordalTolerance + 10.0 * _options.Tolerance;
+            std::vector<Marker> forward;
+            std::vector<Marker> backward;
+            for (const PairParameter& parameter : seeds) {
+                Marker seed;
+                if (!Set(parameter, seed)) {
+                    continue;
+                }
+                bool isTraced = false;
+                for (const LNLibEx::LNIntersectionCurve& curve : curves) {
+                    if (Distance(curve, seed.Point.A) <= seedDistance) {
+                        isTraced = true;
+                        break;
+                    }
+                }
+                if (isTraced) {
+                    continue;
+                }
+
+                MarchEnd end = March(seed, true, forward);
+                backward.clear();
+                if (end != MarchEnd::Closed) {
+                    March(seed, false, backward);
+                }
+                if (forward.size() + backward.size() == 0) {
+                    continue;
+                }
+
+                LNLibEx::LNIntersectionCurve curve;
+                curve.SurfaceA = surfaceA;
+                curve.SurfaceB = surfaceB;
+                curve.IsClosed = end == MarchEnd::Closed;
+                curve.Points.reserve(forward.size() + backward.size() + 1);
+                auto append = [&](const Marker& marker) {
+                    LNLibEx::LNIntersectionPoint point;
+                    point.Point = marker.Point.A;
+                    point.ParameterA = LNLib::UV(marker.Parameter[0], marker.Parameter[1]);
+                    point.ParameterB = LNLib::UV(marker.Parameter[2], marker.Parameter[3]);
+                    curve.Points.emplace_back(point);
+                };
+                for (auto it = backward.rbegin(); it != backward.rend(); ++it) {
+                    append(*it);
+                }
+                append(seed);
+                for (const Marker& marker : forward) {
+                    append(marker);
+                }
+                curves.emplace_back(std::move(curve));
+            }
+        }
+    };
+}
+
+bool LNLibEx::LNSurfaceIntersector::Build(const std::vector<LNLib::LN_NurbsSurface>& surfaces)
+{
+    *this = LNSurfaceIntersector();
+    _caches.resize(surfaces.size());
+    LNParallel::ForDynamic(0, static_cast<int64_t>(surfaces.size()), [&](int64_t i) {
+        _caches[i].Build(surfaces[i]);
+    });
+
+    // Surfaces the BVH skipped (non-positive weights) are dropped here as well.
+    bool isValid = _bvh.Build(_caches);
+    for (size_t i = 0; i < _caches.size(); i++) {
+        LNLib::XYZ minimum;
+        LNLib::XYZ maximum;
+        if (!_bvh.GetBounds(static_cast<int>(i), minimum, maximum)) {
+            _caches[i] = LNBezierSurfaceCache();
+        }
+    }
+    return isValid;
+}
+
+bool LNLibEx::LNSurfaceIntersector::IsEmpty() const
+{
+    return _bvh.IsEmpty();
+}
+
+const LNLibEx::LNSurfaceBVH& LNLibEx::LNSurfaceIntersector::GetBVH() const
+{
+    return _bvh;
+}
+
+void LNLibEx::LNSurfaceIntersector::Intersect(int a, int b, std::vector<LNIntersectionCurve>& curves, const LNIntersectionOptions& options) const
+{
+    curves.clear();
+    const int surfaceCount = static_cast<int>(_caches.size());
+    if (a < 0 || b < 0 || a >= surfaceCount || b >= surfaceCount || a == b || _caches[a].IsEmpty() || _caches[b].IsEmpty()) {
+        return;
+    }
+
+    std::vector<std::pair<LNPatchReference, LNPatchReference>> overlaps;
+    _bvh.GetOverlappingPatches(a, b, overlaps, options.Tolerance);
+    Intersect(overlaps, curves, options);
+}
+
+void LNLibEx::LNSurfaceIntersector::IntersectAll(std::vector<LNIntersectionCurve>& curves, const LNIntersectionOptions& options) const
+{
+    std::vector<std::pair<LNPatchReference, LNPatchReference>> overlaps;
+    _bvh.GetOverlappingPatches(overlaps, options.Tolerance);
+    Intersect(overlaps, curves, options);
+}
+
+void LNLibEx::LNSurfaceIntersector::Intersect(const std::vector<std::pair<LNPatchReference, LNPatchReference>>& pairs, std::vector<LNIntersectionCurve>& curves, const LNIntersectionOptions& options) const
+{
+    curves.clear();
+    const int64_t pairCount = static_cast<int64_t>(pairs.size());
+    std::vector<std::vector<PairParameter>> seeds(pairCount);
+    LNParallel::ForDynamic(0, pairCount, [&](int64_t i) {
+        const LNPatchReference& first = pairs[i].first;
+        const LNPatchReference& second = pairs[i].second;
+        const int patchA[2] = { first.PatchU, first.PatchV };
+        const int patchB[2] = { second.PatchU, second.PatchV };
+        SeedFinder finder(_caches[first.Surface], _caches[second.Surface], options);
+        finder.Process(patchA, patchB, seeds[i]);
+    });
+
+    // Pairs of the same surfaces are consecutive.
+    std::vector<int64_t> groups;
+    for (int64_t i = 0; i < pairCount; i++) {
+        if (i == 0 || pairs[i].first.Surface != pairs[i - 1].first.Surface || pairs[i].second.Surface != pairs[i - 1].second.Surface) {
+            groups.emplace_back(i);
+        }
+    }
+    groups.emplace_back(pairCount);
+
+    const int64_t groupCount = static_cast<int64_t>(groups.size()) - 1;
+    std::vector<std::vector<LNIntersectionCurve>> groupCurves(std::max<int64_t>(0, groupCount));
+    LNParallel::ForDynamic(0, groupCount, [&](int64_t group) {
+        std::vector<PairParameter> groupSeeds;
+        for (int64_t i = groups[group]; i < groups[group + 1]; i++) {
+            groupSeeds.insert(groupSeeds.end(), seeds[i].begin(), seeds[i].end());
+        }
+        if (groupSeeds.empty()) {
+            return;
+        }
+
+        const int a = pairs[groups[group]].first.Surface;
+        const int b = pairs[groups[group]].second.Surface;
+        double maxStep = options.MaxStep;
+        if (!(maxStep > 0.0)) {
+            LNLib::XYZ minimumA;
+            LNLib::XYZ maximumA;
+            LNLib::XYZ minimumB;
+            LNLib::XYZ maximumB;
+            _bvh.GetBounds(a, minimumA, maximumA);
+            _bvh.GetBounds(b, minimumB, maximumB);
+            maxStep = std::min(minimumA.Distance(maximumA), minimumB.Distance(maximumB)) / 8.0;
+            maxStep = std::max(maxStep, 100.0 * options.Tolerance);
+        }
+        CurveTracer tracer(_caches[a], _caches[b], options, maxStep);
+        tracer.Process(groupSeeds, a, b, groupCurves[group]);
+    });
+
+    for (std::vector<LNIntersectionCurve>& list : groupCurves) {
+        curves.insert(curves.end(), std::make_move_iterator(list.begin()), std::make_move_iterator(list.end()));
+    }
+}
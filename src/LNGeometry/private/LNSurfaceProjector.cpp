@@ -0,0 +1,260 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNSurfaceProjector.h"
+#include "LNGridEvaluator.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "UV.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const int MaxIterations = 32;
+
+    std::vector<double> getSampleParameters(const std::vector<double>& knots, int samplesPerSpan) {
+        std::vector<double> parameters;
+        for (size_t i = 0; i + 1 < knots.size(); i++) {
+            for (int k = 0; k < samplesPerSpan; k++) {
+                parameters.emplace_back(knots[i] + (knots[i + 1] - knots[i]) * k / samplesPerSpan);
+            }
+        }
+        parameters.emplace_back(knots.back());
+        return parameters;
+    }
+
+    double wrapParameter(double parameter, const std::vector<double>& knots, bool isClosed) {
+        const double start = knots.front();
+        const double end = knots.back();
+        if (isClosed && (parameter < start || parameter > end)) {
+            parameter = start + std::fmod(parameter - start, end - start);
+            if (parameter < start) {
+                parameter += end - start;
+            }
+        }
+        return std::max(start, std::min(end, parameter));
+    }
+}
+
+bool LNLibEx::LNSurfaceProjector::Build(const LNLib::LN_NurbsSurface& surface, int samplesPerSpan)
+{
+    *this = LNSurfaceProjector();
+    if (!_cache.Build(surface)) {
+        return false;
+    }
+
+    std::vector<double> u = getSampleParameters(_cache.GetKnotsU(), std::max(1, samplesPerSpan));
+    std::vector<double> v = getSampleParameters(_cache.GetKnotsV(), std::max(1, samplesPerSpan));
+    LNGridEvaluator evaluator;
+    std::vector<LNLib::XYZ> points;
+    if (!evaluator.Build(surface, u, v)) {
+        *this = LNSurfaceProjector();
+        return false;
+    }
+    evaluator.EvaluatePoints(points);
+
+    LNLib::XYZ minimum = points[0];
+    LNLib::XYZ maximum = points[0];
+    _samples.resize(points.size());
+    for (size_t i = 0; i < u.size(); i++) {
+        for (size_t j = 0; j < v.size(); j++) {
+            const LNLib::XYZ& point = points[i * v.size() + j];
+            Sample& sample = _samples[i * v.size() + j];
+            for (int axis = 0; axis < 3; axis++) {
+                sample.Position[axis] = point[axis];
+                minimum[axis] = std::min(minimum[axis], point[axis]);
+                maximum[axis] = std::max(maximum[axis], point[axis]);
+            }
+            sample.U = u[i];
+            sample.V = v[j];
+            sample.Axis = 0;
+        }
+    }
+
+    // A direction is closed when its first and last sample rows coincide.
+    const double tolerance = 1E-9 * std::max(1.0, minimum.Distance(maximum));
+    _isClosedU = true;
+    _isClosedV = true;
+    for (size_t j = 0; j < v.size(); j++) {
+        _isClosedU = _isClosedU && points[j].Distance(points[(u.size() - 1) * v.size() + j]) <= tolerance;
+    }
+    for (size_t i = 0; i < u.size(); i++) {
+        _isClosedV = _isClosedV && points[i * v.size()].Distance(points[i * v.size() + v.size() - 1]) <= tolerance;
+    }
+
+    BuildTree(0, static_cast<int>(_samples.size()));
+    return true;
+}
+
+bool LNLibEx::LNSurfaceProjector::IsEmpty() const
+{
+    return _samples.empty();
+}
+
+const LNLibEx::LNBezierSurfaceCache& LNLibEx::LNSurfaceProjector::GetCache() const
+{
+    return _cache;
+}
+
+void LNLibEx::LNSurfaceProjector::BuildTree(int begin, int end)
+{
+    if (end - begin <= 0) {
+        return;
+    }
+    double minimum[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+    double maximum[3] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+    for (int i = begin; i < end; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            minimum[axis] = std::min(minimum[axis], _samples[i].Position[axis]);
+            maximum[axis] = std::max(maximum[axis], _samples[i].Position[axis]);
+        }
+    }
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (maximum[k] - minimum[k] > maximum[axis] - minimum[axis]) {
+            axis = k;
+        }
+    }
+
+    int middle = (begin + end) / 2;
+    std::nth_element(_samples.begin() + begin, _samples.begin() + middle, _samples.begin() + end, [axis](const Sample& a, const Sample& b) {
+        return a.Position[axis] < b.Position[axis];
+    });
+    _samples[middle].Axis = axis;
+    BuildTree(begin, middle);
+    BuildTree(middle + 1, end);
+}
+
+void LNLibEx::LNSurfaceProjector::FindNearest(int begin, int end, const double* point, int& nearest, double& distance) const
+{
+    if (end - begin <= 0) {
+        return;
+    }
+    int middle = (begin + end) / 2;
+    const Sample& sample = _samples[middle];
+    double squared = 0.0;
+    for (int axis = 0; axis < 3; axis++) {
+        double difference = point[axis] - sample.Position[axis];
+        squared += difference * difference;
+    }
+    if (squared < distance) {
+        distance = squared;
+        nearest = middle;
+    }
+
+    double offset = point[sample.Axis] - sample.Position[sample.Axis];
+    if (offset < 0.0) {
+        FindNearest(begin, middle, point, nearest, distance);
+        if (offset * offset < distance) {
+            FindNearest(middle + 1, end, point, nearest, distance);
+        }
+    }
+    else {
+        FindNearest(middle + 1, end, point, nearest, distance);
+        if (offset * offset < distance) {
+            FindNearest(begin, middle, point, nearest, distance);
+        }
+    }
+}
+
+LNLibEx::LNSurfaceProjection LNLibEx::LNSurfaceProjector::Project(const LNLib::XYZ& point) const
+{
+    LNSurfaceProjection projection;
+    if (IsEmpty()) {
+        return projection;
+    }
+    const double position[3] = { point.GetX(), point.GetY(), point.GetZ() };
+    int nearest = 0;
+    double nearestDistance = std::numeric_limits<double>::max();
+    FindNearest(0, static_cast<int>(_samples.size()), position, nearest, nearestDistance);
+
+    const std::vector<double>& knotsU = _cache.GetKnotsU();
+    const std::vector<double>& knotsV = _cache.GetKnotsV();
+    double u = _samples[nearest].U;
+    double v = _samples[nearest].V;
+    double bestU = u;
+    double bestV = v;
+    double bestDistance = std::sqrt(nearestDistance);
+    for (int i = 0; i < MaxIterations; i++) {
+        LNLib::XYZ s, su, sv, suu, suv, svv;
+        _cache.GetDerivatives(LNLib::UV(u, v), s, su, sv, suu, suv, svv);
+        const LNLib::XYZ r = s - point;
+        const double f = r.DotProduct(su);
+        const double g = r.DotProduct(sv);
+        const double length = r.Length();
+        if (length <= bestDistance) {
+            bestU = u;
+            bestV = v;
+            bestDistance = length;
+        }
+        if (length == 0.0 ||
+            (std::fabs(f) <= 1E-14 * su.Length() * length && std::fabs(g) <= 1E-14 * sv.Length() * length)) {
+            break;
+        }
+
+        // Newton on the gradient of the squared distance, Gauss-Newton where the Hessian is not positive definite.
+        double j00 = su.DotProduct(su) + r.DotProduct(suu);
+        double j01 = su.DotProduct(sv) + r.DotProduct(suv);
+        double j11 = sv.DotProduct(sv) + r.DotProduct(svv);
+        double determinant = j00 * j11 - j01 * j01;
+        if (j00 <= 0.0 || determinant <= 0.0) {
+            j00 = su.DotProduct(su);
+            j01 = su.DotProduct(sv);
+            j11 = sv.DotProduct(sv);
+            determinant = j00 * j11 - j01 * j01;
+        }
+        if (!(determinant > 0.0)) {
+            break;
+        }
+        double stepU = (g * j01 - f * j11) / determinant;
+        double stepV = (f * j01 - g * j00) / determinant;
+
+        // On an open boundary the clamped direction is fixed, minimize along the other one alone.
+        bool isClampedU = !_isClosedU && (u + stepU < knotsU.front() || u + stepU > knotsU.back());
+        bool isClampedV = !_isClosedV && (v + stepV < knotsV.front() || v + stepV > knotsV.back());
+        if (isClampedU && !isClampedV && j11 > 0.0) {
+            stepV = -g / j11;
+        }
+        else if (isClampedV && !isClampedU && j00 > 0.0) {
+            stepU = -f / j00;
+        }
+        double nextU = wrapParameter(u + stepU, knotsU, _isClosedU);
+        double nextV = wrapParameter(v + stepV, knotsV, _isClosedV);
+        bool isConverged = (su * (nextU - u) + sv * (nextV - v)).Length() <= 1E-15 * std::max(1.0, s.Length());
+        u = nextU;
+        v = nextV;
+        if (isConverged) {
+            break;
+        }
+    }
+
+    // Iteration may oscillate across creases or leave the basin of the seed, keep the closest iterate.
+    projection.Parameter = LNLib::UV(u, v);
+    projection.Point = _cache.GetPoint(projection.Parameter);
+    projection.Distance = projection.Point.Distance(point);
+    if (projection.Distance > bestDistance + 1E-12 * std::max(1.0, bestDistance)) {
+        projection.Parameter = LNLib::UV(bestU, bestV);
+        projection.Point = _cache.GetPoint(projection.Parameter);
+        projection.Distance = projection.Point.Distance(point);
+    }
+    return projection;
+}
+
+void LNLibEx::LNSurfaceProjector::Project(const std::vector<LNLib::XYZ>& points, std::vector<LNSurfaceProjection>& projections) const
+{
+    projections.resize(points.size());
+    LNParallel::For(0, static_cast<int64_t>(points.size()), [&](int64_t i) {
+        projections[i] = Project(points[i]);
+    }, 256);
+}
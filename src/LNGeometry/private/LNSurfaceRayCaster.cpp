@@ -0,0 +1,433 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNSurfaceRayCaster.h"
+#include "LNBezierSubdivision.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include "UV.h"
+#include "LNParallel.h"
+#include "LNBVHBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define LNGEOMETRY_RAY_PACKET_SSE
+#endif
+
+namespace
+{
+    const int PacketSize = 4;
+    const int MaxSubdivisionDepth = 12;
+    const int MaxIterations = 16;
+    const double FlatnessRatio = 5E-2;
+
+    typedef LNLibEx::LNBezierSubdivision::SubPatch SubPatch;
+
+    /// Hierarchy of the patch grid, then of the de Casteljau halves of every patch down to flat leaves.
+    template <typename NodeType, typename LeafType>
+    class SubdivisionBuilder
+    {
+    private:
+
+        const LNLibEx::LNBezierSurfaceCache& _cache;
+        std::vector<NodeType>& _nodes;
+        std::vector<LeafType>& _leaves;
+        double _margin;
+
+        void AddLeaf(const SubPatch& patch) {
+            const int degreeU = _cache.GetDegreeU();
+            const int degreeV = _cache.GetDegreeV();
+            const int columns = degreeV + 1;
+            const LNLib::XYZ& corner00 = patch.Projected[0];
+            const LNLib::XYZ& corner01 = patch.Projected[degreeV];
+            const LNLib::XYZ& corner10 = patch.Projected[degreeU * columns];
+            const LNLib::XYZ& corner11 = patch.Projected[degreeU * columns + degreeV];
+
+            LeafType leaf;
+            std::copy(&patch.Domain[0][0], &patch.Domain[0][0] + 4, &leaf.Domain[0][0]);
+            for (int i = 0; i < 3; i++) {
+                leaf.Center[i] = 0.25 * (corner00[i] + corner01[i] + corner10[i] + corner11[i]);
+                leaf.AxisU[i] = 0.25 * (corner10[i] + corner11[i] - corner00[i] - corner01[i]);
+                leaf.AxisV[i] = 0.25 * (corner01[i] + corner11[i] - corner00[i] - corner10[i]);
+                leaf.Normal[i] = patch.Normal[i];
+            }
+            leaf.Offset = 0.5 * (patch.Offsets[0] + patch.Offsets[1]);
+
+            NodeType node;
+            for (int i = 0; i < 3; i++) {
+                node.Min[i] = LNLibEx::LNBVHBuilder::RoundDown(patch.Min[i] - _margin);
+                node.Max[i] = LNLibEx::LNBVHBuilder::RoundUp(patch.Max[i] + _margin);
+            }
+            node.Offset = static_cast<uint32_t>(_leaves.size());
+            node.Count = 1;
+            _leaves.emplace_back(leaf);
+            _nodes.emplace_back(node);
+        }
+
+        /// Interior node at index gets the union of its children.
+        void SetInterior(size_t index) {
+            NodeType& node = _nodes[index];
+            const NodeType& left = _nodes[index + 1];
+            const NodeType& right = _nodes[index + node.Offset];
+            for (int i = 0; i < 3; i++) {
+                node.Min[i] = std::min(left.Min[i], right.Min[i]);
+                node.Max[i] = std::max(left.Max[i], right.Max[i]);
+            }
+            node.Count = 0;
+        }
+
+        void BuildPatch(const SubPatch& patch, int depth) {
+            if (depth >= MaxSubdivisionDepth || LNLibEx::LNBezierSubdivision::IsFlat(patch, FlatnessRatio)) {
+                AddLeaf(patch);
+                return;
+            }
+
+            SubPatch first;
+            SubPatch second;
+            int direction = patch.Lengths[0] >= patch.Lengths[1] ? 0 : 1;
+            LNLibEx::LNBezierSubdivision::Split(patch, _cache.GetDegreeU(), _cache.GetDegreeV(), direction, first, second);
+
+            size_t index = _nodes.size();
+            _nodes.emplace_back();
+            BuildPatch(first, depth + 1);
+            _nodes[index].Offset = static_cast<uint32_t>(_nodes.size() - index);
+            BuildPatch(second, depth + 1);
+            SetInterior(index);
+        }
+
+        void BuildGrid(int beginU, int endU, int beginV, int endV) {
+            if (endU - beginU == 1 && endV - beginV == 1) {
+                SubPatch patch;
+                LNLibEx::LNBezierSubdivision::Initialize(patch, _cache, beginU, beginV);
+                BuildPatch(patch, 0);
+                return;
+            }
+
+            size_t index = _nodes.size();
+            _nodes.emplace_back();
+            if (endU - beginU >= endV - beginV) {
+                int middle = (beginU + endU) / 2;
+                BuildGrid(beginU, middle, beginV, endV);
+                _nodes[index].Offset = static_cast<uint32_t>(_nodes.size() - index);
+                BuildGrid(middle, endU, beginV, endV);
+            }
+            else {
+                int middle = (beginV + endV) / 2;
+                BuildGrid(beginU, endU, beginV, middle);
+                _nodes[index].Offset = static_cast<uint32_t>(_nodes.size() - index);
+                BuildGrid(beginU, endU, middle, endV);
+            }
+            SetInterior(index);
+        }
+
+    public:
+
+        SubdivisionBuilder(const LNLibEx::LNBezierSurfaceCache& cache, std::vector<NodeType>& nodes, std::vector<LeafType>& leaves, double margin) :
+            _cache(cache), _nodes(nodes), _leaves(leaves), _margin(margin) {}
+
+        void Process() {
+            BuildGrid(0, _cache.GetPatchCountU(), 0, _cache.GetPatchCountV());
+        }
+    };
+}
+
+bool LNLibEx::LNSurfaceRayCaster::Build(const LNLib::LN_NurbsSurface& surface)
+{
+    *this = LNSurfaceRayCaster();
+    if (!_cache.Build(surface)) {
+        return false;
+    }
+
+    // Sub-patches bound the surface only with positive weights (convex hull property).
+    LNLib::XYZ minimum(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    LNLib::XYZ maximum = -minimum;
+    for (const std::vector<LNLib::XYZW>& row : surface.ControlPoints) {
+        for (const LNLib::XYZW& point : row) {
+            if (!(point.W() > 0.0)) {
+                *this = LNSurfaceRayCaster();
+                return false;
+            }
+            LNLib::XYZ position = point.ToXYZ(true);
+            for (int i = 0; i < 3; i++) {
+                minimum[i] = std::min(minimum[i], position[i]);
+                maximum[i] = std::max(maximum[i], position[i]);
+            }
+        }
+    }
+
+    // Boxes are grown by the hit tolerance, so rays along a boundary of the surface still reach its leaves.
+    _tolerance = 1E-10 * (1.0 + (maximum - minimum).Length());
+    SubdivisionBuilder<Node, Leaf> builder(_cache, _nodes, _leaves, _tolerance);
+    builder.Process();
+    return true;
+}
+
+bool LNLibEx::LNSurfaceRayCaster::IsEmpty() const
+{
+    return _nodes.empty();
+}
+
+int LNLibEx::LNSurfaceRayCaster::GetNodeCount() const
+{
+    return static_cast<int>(_nodes.size());
+}
+
+int LNLibEx::LNSurfaceRayCaster::GetLeafCount() const
+{
+    return static_cast<int>(_leaves.size());
+}
+
+const LNLibEx::LNBezierSurfaceCache& LNLibEx::LNSurfaceRayCaster::GetCache() const
+{
+    return _cache;
+}
+
+namespace
+{
+    /// Rays in structure of arrays layout, lanes outside Mask are ignored.
+    /// Traversal runs in double precision on the exact origins, float boxes are widened to double without rounding.
+    struct RayPacket
+    {
+        double Origin[3][PacketSize];
+        double Inverse[3][PacketSize];
+        double MaxT[PacketSize];
+        int Mask;
+        const LNLib::XYZ* Origins;
+        const LNLib::XYZ* Directions;
+    };
+
+    void makePacket(const LNLib::XYZ* origins, const LNLib::XYZ* directions, int count, double maxDistance, RayPacket& packet) {
+        packet.Mask = 0;
+        packet.Origins = origins;
+        packet.Directions = directions;
+        for (int lane = 0; lane < PacketSize; lane++) {
+            bool isActive = lane < count;
+            for (int i = 0; i < 3; i++) {
+                double component = isActive ? directions[lane][i] : 1.0;
+                component = std::fabs(component) < 1E-30 ? std::copysign(1E-30, component) : component;
+                packet.Origin[i][lane] = isActive ? origins[lane][i] : 0.0;
+                packet.Inverse[i][lane] = 1.0 / component;
+            }
+            packet.MaxT[lane] = isActive ? maxDistance : -1.0;
+            packet.Mask |= isActive ? (1 << lane) : 0;
+        }
+    }
+
+    /// Lanes of packet whose ray hits node within [0, MaxT], entry parameters go to entry.
+    template <typename NodeType>
+    inline int intersectBox(const NodeType& node, const RayPacket& packet, double* entry) {
+#if defined(LNGEOMETRY_RAY_PACKET_SSE)
+        int mask = 0;
+        for (int lane = 0; lane < PacketSize; lane += 2) {
+            __m128d tNear = _mm_setzero_pd();
+            __m128d tFar = _mm_loadu_pd(packet.MaxT + lane);
+            for (int i = 0; i < 3; i++) {
+                __m128d origin = _mm_loadu_pd(packet.Origin[i] + lane);
+                __m128d inverse = _mm_loadu_pd(packet.Inverse[i] + lane);
+                __m128d t0 = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(node.Min[i]), origin), inverse);
+                __m128d t1 = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(node.Max[i]), origin), inverse);
+                tNear = _mm_max_pd(tNear, _mm_min_pd(t0, t1));
+                tFar = _mm_min_pd(tFar, _mm_max_pd(t0, t1));
+            }
+            _mm_storeu_pd(entry + lane, tNear);
+            mask |= _mm_movemask_pd(_mm_cmple_pd(tNear, _mm_mul_pd(tFar, _mm_set1_pd(LNLibEx::LNBVHBuilder::ExitScale)))) << lane;
+        }
+        return mask & packet.Mask;
+#else
+        int mask = 0;
+        for (int lane = 0; lane < PacketSize; lane++) {
+            double entryT = 0.0;
+            double exitT = packet.MaxT[lane];
+            for (int i = 0; i < 3; i++) {
+                double t0 = (node.Min[i] - packet.Origin[i][lane]) * packet.Inverse[i][lane];
+                double t1 = (node.Max[i] - packet.Origin[i][lane]) * packet.Inverse[i][lane];
+                entryT = std::max(entryT, std::min(t0, t1));
+                exitT = std::min(exitT, std::max(t0, t1));
+            }
+            entry[lane] = entryT;
+            mask |= entryT <= exitT * LNLibEx::LNBVHBuilder::ExitScale ? (1 << lane) : 0;
+        }
+        return mask & packet.Mask;
+#endif
+    }
+
+    double getNearest(int mask, const double* entry) {
+        double result = std::numeric_limits<double>::max();
+        for (int lane = 0; lane < PacketSize; lane++) {
+            if (mask & (1 << lane)) {
+                result = std::min(result, entry[lane]);
+            }
+        }
+        return result;
+    }
+
+    /// Newton iteration on S(u, v) - (origin + t * direction) = 0, started where the ray meets the leaf plane.
+    /// (u, v) stays in the leaf, so every root is found from its own leaf and the closest one wins regardless of visiting order.
+    template <typename LeafType>
+    bool intersectLeaf(const LeafType& leaf, const LNLibEx::LNBezierSurfaceCache& cache, double tolerance,
+                       const LNLib::XYZ& origin, const LNLib::XYZ& direction, double maxDistance, LNLibEx::LNSurfaceHit& hit) {
+        const LNLib::XYZ normal(leaf.Normal[0], leaf.Normal[1], leaf.Normal[2]);
+        const LNLib::XYZ center(leaf.Center[0], leaf.Center[1], leaf.Center[2]);
+        const LNLib::XYZ axisU(leaf.AxisU[0], leaf.AxisU[1], leaf.AxisU[2]);
+        const LNLib::XYZ axisV(leaf.AxisV[0], leaf.AxisV[1], leaf.AxisV[2]);
+
+        double denominator = normal.DotProduct(direction);
+        double t = std::fabs(denominator) > 1E-12 * direction.Length() ?
+            (leaf.Offset - normal.DotProduct(origin)) / denominator :
+            (center - origin).DotProduct(direction) / direction.DotProduct(direction);
+
+        LNLib::XYZ offset = origin + direction * t - center;
+        double uu = axisU.DotProduct(axisU);
+        double uv = axisU.DotProduct(axisV);
+        double vv = axisV.DotProduct(axisV);
+        double determinant = uu * vv - uv * uv;
+        double a = 0.0;
+        double b = 0.0;
+        if (std::fabs(determinant) > 1E-300) {
+            double pu = axisU.DotProduct(offset);
+            double pv = axisV.DotProduct(offset);
+            a = std::max(-1.0, std::min(1.0, (pu * vv - pv * uv) / determinant));
+            b = std::max(-1.0, std::min(1.0, (uu * pv - uv * pu) / determinant));
+        }
+
+        double u = 0.5 * (leaf.Domain[0][0] + leaf.Domain[0][1]) + 0.5 * a * (leaf.Domain[0][1] - leaf.Domain[0][0]);
+        double v = 0.5 * (leaf.Domain[1][0] + leaf.Domain[1][1]) + 0.5 * b * (leaf.Domain[1][1] - leaf.Domain[1][0]);
+
+        LNLib::XYZ point;
+        LNLib::XYZ derivativeU;
+        LNLib::XYZ derivativeV;
+        const LNLib::XYZ negative = -direction;
+        for (int iteration = 0; ; iteration++) {
+            cache.GetDerivatives(LNLib::UV(u, v), point, derivativeU, derivativeV);
+            LNLib::XYZ residual = origin + direction * t - point;
+            if (residual.Length() <= tolerance) {
+                break;
+            }
+            if (iteration == MaxIterations) {
+                return false;
+            }
+
+            // Cramer's rule on derivativeU * du + derivativeV * dv + negative * dt = residual.
+            LNLib::XYZ cross = derivativeV.CrossProduct(negative);
+            double volume = derivativeU.DotProduct(cross);
+            if (!(std::fabs(volume) > 1E-300)) {
+                return false;
+            }
+            u += residual.DotProduct(cross) / volume;
+            v += derivativeU.DotProduct(residual.CrossProduct(negative)) / volume;
+            t += derivativeU.DotProduct(derivativeV.CrossProduct(residual)) / volume;
+            u = std::max(leaf.Domain[0][0], std::min(leaf.Domain[0][1], u));
+            v = std::max(leaf.Domain[1][0], std::min(leaf.Domain[1][1], v));
+        }
+
+        if (t < 0.0 || t > maxDistance) {
+            return false;
+        }
+        hit.IsHit = true;
+        hit.Distance = t;
+        hit.Parameter = LNLib::UV(u, v);
+        hit.Point = point;
+        return true;
+    }
+
+    template <typename NodeType, typename LeafType>
+    void intersectPacket(const std::vector<NodeType>& nodes, const std::vector<LeafType>& leaves, const LNLibEx::LNBezierSurfaceCache& cache,
+                         double tolerance, RayPacket& packet, std::vector<int>& stack, LNLibEx::LNSurfaceHit* hits) {
+        for (int lane = 0; lane < PacketSize; lane++) {
+            if (packet.Mask & (1 << lane)) {
+                hits[lane] = LNLibEx::LNSurfaceHit();
+            }
+        }
+        if (nodes.empty()) {
+            return;
+        }
+
+        double entry[PacketSize];
+        stack.clear();
+        stack.emplace_back(0);
+        while (!stack.empty()) {
+            int index = stack.back();
+            stack.pop_back();
+            const NodeType& node = nodes[index];
+            int mask = intersectBox(node, packet, entry);
+            if (mask == 0) {
+                continue;
+            }
+            if (node.Count > 0) {
+                const LeafType& leaf = leaves[node.Offset];
+                for (int lane = 0; lane < PacketSize; lane++) {
+                    if ((mask & (1 << lane)) &&
+                        intersectLeaf(leaf, cache, tolerance, packet.Origins[lane], packet.Directions[lane], packet.MaxT[lane], hits[lane])) {
+                        packet.MaxT[lane] = hits[lane].Distance;
+                    }
+                }
+                continue;
+            }
+
+            int left = index + 1;
+            int right = index + static_cast<int>(node.Offset);
+            double leftEntry[PacketSize];
+            double rightEntry[PacketSize];
+            int leftMask = intersectBox(nodes[left], packet, leftEntry) & mask;
+            int rightMask = intersectBox(nodes[right], packet, rightEntry) & mask;
+            if (leftMask && rightMask) {
+                if (getNearest(leftMask, leftEntry) < getNearest(rightMask, rightEntry)) {
+                    stack.emplace_back(right);
+                    stack.emplace_back(left);
+                }
+                else {
+                    stack.emplace_back(left);
+                    stack.emplace_back(right);
+                }
+            }
+            else if (leftMask) {
+                stack.emplace_back(left);
+            }
+            else if (rightMask) {
+                stack.emplace_back(right);
+            }
+        }
+    }
+}
+
+bool LNLibEx::LNSurfaceRayCaster::Intersect(const LNLib::XYZ& origin, const LNLib::XYZ& direction, LNSurfaceHit& hit, double maxDistance) const
+{
+    RayPacket packet;
+    makePacket(&origin, &direction, 1, maxDistance, packet);
+    std::vector<int> stack;
+    stack.reserve(64);
+    LNSurfaceHit hits[PacketSize];
+    intersectPacket(_nodes, _leaves, _cache, _tolerance, packet, stack, hits);
+    hit = hits[0];
+    return hit.IsHit;
+}
+
+void LNLibEx::LNSurfaceRayCaster::Intersect(const std::vector<LNLib::XYZ>& origins, const std::vector<LNLib::XYZ>& directions, std::vector<LNSurfaceHit>& hits, double maxDistance) const
+{
+    const int64_t count = static_cast<int64_t>(std::min(origins.size(), directions.size()));
+    hits.assign(count, LNSurfaceHit());
+    LNParallel::ForEachChunk(0, count, 256, [&](int, int64_t begin, int64_t end) {
+        std::vector<int> stack;
+        stack.reserve(64);
+        RayPacket packet;
+        LNSurfaceHit packetHits[PacketSize];
+        for (int64_t first = begin; first < end; first += PacketSize) {
+            int size = static_cast<int>(std::min<int64_t>(PacketSize, end - first));
+            makePacket(&origins[first], &directions[first], size, maxDistance, packet);
+            intersectPacket(_nodes, _leaves, _cache, _tolerance, packet, stack, packetHits);
+            std::copy(packetHits, packetHits + size, hits.begin() + first);
+        }
+    });
+}
@@ -0,0 +1,109 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNGeometryDefinitions.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include "UV.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Bezier decomposition of a NURBS surface kept for repeated evaluation.
+	/// 
+	/// The surface is split once by LNLib::NurbsSurface::DecomposeToBeziers. Each patch is stored as homogeneous
+	/// power basis coefficients in one contiguous array. A query finds its patch by binary search over the distinct knots,
+	/// then evaluates a polynomial in local parameters with Horner's scheme, without any basis function recursion.
+	/// All queries are const and can run concurrently.
+	/// </summary>
+	class LNGeometry_EXPORT LNBezierSurfaceCache
+	{
+	public:
+
+		/// <summary>
+		/// Return false if surface is invalid. The cache does not refer to surface afterwards.
+		/// </summary>
+		bool Build(const LNLib::LN_NurbsSurface& surface);
+
+		bool IsEmpty() const;
+
+		int GetDegreeU() const;
+
+		int GetDegreeV() const;
+
+		/// <summary>
+		/// Patches per direction, patch (i, j) covers [GetKnotsU()[i], GetKnotsU()[i + 1]] x [GetKnotsV()[j], GetKnotsV()[j + 1]].
+		/// </summary>
+		int GetPatchCountU() const;
+
+		int GetPatchCountV() const;
+
+		const std::vector<double>& GetKnotsU() const;
+
+		const std::vector<double>& GetKnotsV() const;
+
+		/// <summary>
+		/// Homogeneous Bezier control points of patch (i, j), row-major in U, (DegreeU + 1) x (DegreeV + 1).
+		/// </summary>
+		const LNLib::XYZW* GetPatchControlPoints(int i, int j) const;
+
+		/// <summary>
+		/// Parameters outside the domain are clamped to it.
+		/// </summary>
+		LNLib::XYZ GetPoint(const LNLib::UV& uv) const;
+
+		void GetDerivatives(const LNLib::UV& uv, LNLib::XYZ& point, LNLib::XYZ& derivativeU, LNLib::XYZ& derivativeV) const;
+
+		/// <summary>
+		/// Point with first and second partial derivatives.
+		/// </summary>
+		void GetDerivatives(const LNLib::UV& uv, LNLib::XYZ& point, LNLib::XYZ& derivativeU, LNLib::XYZ& derivativeV,
+			LNLib::XYZ& derivativeUU, LNLib::XYZ& derivativeUV, LNLib::XYZ& derivativeVV) const;
+
+		/// <summary>
+		/// Unit normal Su x Sv, zero where the surface is degenerate.
+		/// </summary>
+		LNLib::XYZ GetNormal(const LNLib::UV& uv) const;
+
+		/// <summary>
+		/// Batched point evaluation in parallel.
+		/// </summary>
+		void GetPoints(const std::vector<LNLib::UV>& uvs, std::vector<LNLib::XYZ>& points) const;
+
+		/// <summary>
+		/// Batched unit normals in parallel.
+		/// </summary>
+		void GetNormals(const std::vector<LNLib::UV>& uvs, std::vector<LNLib::XYZ>& normals) const;
+
+	private:
+
+		/// <summary>
+		/// Patch index and local parameters in [0, 1] of uv.
+		/// </summary>
+		int Locate(const LNLib::UV& uv, double& s, double& t) const;
+
+		/// <summary>
+		/// Homogeneous value and derivatives by local parameters up to order derivative: value, S, T, SS, ST, TT.
+		/// </summary>
+		void EvaluatePatch(int patch, double s, double t, int derivative, double values[6][4]) const;
+
+		int _degreeU = 0;
+		int _degreeV = 0;
+		std::vector<double> _knotsU;
+		std::vector<double> _knotsV;
+
+		// Per patch (DegreeU + 1) x (DegreeV + 1) coefficients of 4 doubles, coefficient (a, b) multiplies s^a t^b.
+		std::vector<double> _coefficients;
+		std::vector<LNLib::XYZW> _controlPoints;
+	};
+}
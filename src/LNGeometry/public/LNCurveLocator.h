@@ -0,0 +1,112 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNGeometryDefinitions.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Arc length parameterization and closest point projection for many queries on one NURBS curve.
+	/// 
+	/// Build splits the curve once by LNLib::NurbsCurve::DecomposeToBeziers into power basis segments,
+	/// and integrates arc length over samplesPerSpan intervals per span with 5-point Gauss-Legendre into a cumulative table.
+	/// Length queries binary search the table and polish by Newton iteration on the integral.
+	/// Point queries seed from the closest chord of the sampled polyline, pruned by bounds of chord blocks, and polish by Newton iteration on the distance.
+	/// </summary>
+	class LNGeometry_EXPORT LNCurveLocator
+	{
+	public:
+
+		/// <summary>
+		/// Return false if curve is invalid.
+		/// </summary>
+		bool Build(const LNLib::LN_NurbsCurve& curve, int samplesPerSpan = 8);
+
+		bool IsEmpty() const;
+
+		double GetStartParameter() const;
+
+		double GetEndParameter() const;
+
+		/// <summary>
+		/// Length of the whole curve.
+		/// </summary>
+		double GetLength() const;
+
+		/// <summary>
+		/// Length from curve start to parameter.
+		/// </summary>
+		double GetLength(double parameter) const;
+
+		/// <summary>
+		/// Parameter at length from curve start, like LNLib::NurbsCurve::GetParamOnCurve(curve, givenLength).
+		/// Lengths outside [0, GetLength()] are clamped.
+		/// </summary>
+		double GetParameter(double length) const;
+
+		/// <summary>
+		/// Batched length queries in parallel.
+		/// </summary>
+		void GetParameters(const std::vector<double>& lengths, std::vector<double>& parameters) const;
+
+		/// <summary>
+		/// Parameters at lengths 0, spacing, 2 * spacing ... up to the curve length.
+		/// </summary>
+		std::vector<double> GetParametersBySpacing(double spacing) const;
+
+		LNLib::XYZ GetPoint(double parameter) const;
+
+		/// <summary>
+		/// Parameter of the closest point, like LNLib::NurbsCurve::GetParamOnCurve(curve, givenPoint).
+		/// </summary>
+		double Project(const LNLib::XYZ& point) const;
+
+		/// <summary>
+		/// Batched point queries in parallel.
+		/// </summary>
+		void Project(const std::vector<LNLib::XYZ>& points, std::vector<double>& parameters) const;
+
+	private:
+
+		/// <summary>
+		/// Homogeneous point and derivatives by parameter up to order derivative, 4 doubles each.
+		/// </summary>
+		void Evaluate(double parameter, int derivative, double values[3][4]) const;
+
+		void GetDerivatives(double parameter, LNLib::XYZ& point, LNLib::XYZ& first, LNLib::XYZ& second) const;
+
+		double GetSpeed(double parameter) const;
+
+		/// <summary>
+		/// Length between two parameters of one table interval.
+		/// </summary>
+		double Integrate(double start, double end) const;
+
+		int _degree = 0;
+		bool _isClosed = false;
+
+		// Distinct knots and per segment (Degree + 1) power basis coefficients of 4 doubles in the local parameter.
+		std::vector<double> _knots;
+		std::vector<double> _coefficients;
+
+		// Cumulative table: Lengths[k] is the length from curve start to Parameters[k], Points[k] the curve point there.
+		std::vector<double> _parameters;
+		std::vector<double> _lengths;
+		std::vector<LNLib::XYZ> _points;
+
+		// Bounds of consecutive chords, to skip most of the polyline when seeding point queries.
+		std::vector<LNLib::XYZ> _blockMinimums;
+		std::vector<LNLib::XYZ> _blockMaximums;
+	};
+}
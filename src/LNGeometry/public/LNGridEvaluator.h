@@ -0,0 +1,90 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNGeometryDefinitions.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Evaluate a NURBS surface on the tensor grid of parameters u x v.
+	/// 
+	/// Knot spans and basis functions (with first derivatives) are computed once per U and per V parameter.
+	/// Each grid row first contracts the control net along U, then consecutive V parameters in the same span
+	/// share the contracted row, so the innermost loop runs over contiguous samples and is vectorized by the compiler.
+	/// Rows are evaluated in parallel.
+	/// </summary>
+	class LNGeometry_EXPORT LNGridEvaluator
+	{
+	public:
+
+		/// <summary>
+		/// Return false if surface is invalid or a parameter lies outside its domain.
+		/// The evaluator copies the control net, surface does not need to outlive it.
+		/// </summary>
+		bool Build(const LNLib::LN_NurbsSurface& surface, const std::vector<double>& u, const std::vector<double>& v);
+
+		bool IsEmpty() const;
+
+		int GetCountU() const;
+
+		int GetCountV() const;
+
+		/// <summary>
+		/// points[i * GetCountV() + j] = S(u[i], v[j]).
+		/// </summary>
+		void EvaluatePoints(std::vector<LNLib::XYZ>& points) const;
+
+		/// <summary>
+		/// Points and first partial derivatives, laid out like EvaluatePoints.
+		/// </summary>
+		void EvaluateDerivatives(std::vector<LNLib::XYZ>& points, std::vector<LNLib::XYZ>& derivativesU, std::vector<LNLib::XYZ>& derivativesV) const;
+
+		/// <summary>
+		/// Unit normals Su x Sv, laid out like EvaluatePoints. Zero where the surface is degenerate.
+		/// </summary>
+		void EvaluateNormals(std::vector<LNLib::XYZ>& normals) const;
+
+	private:
+
+		/// <summary>
+		/// Consecutive parameters sharing one knot span, First of the control points that span touches.
+		/// </summary>
+		struct Run
+		{
+			int Begin;
+			int End;
+			int First;
+		};
+
+		void Evaluate(LNLib::XYZ* points, LNLib::XYZ* derivativesU, LNLib::XYZ* derivativesV, LNLib::XYZ* normals) const;
+
+		int _degreeU = 0;
+		int _degreeV = 0;
+		int _controlCountV = 0;
+
+		// Homogeneous control points, 4 doubles each, row-major in U.
+		std::vector<double> _controlPoints;
+
+		// Per U parameter: first control row and degreeU + 1 basis values and derivatives.
+		std::vector<int> _firstU;
+		std::vector<double> _basisU;
+		std::vector<double> _derivativeU;
+
+		// Per V basis index k: values for all V parameters, so runs of samples are contiguous.
+		std::vector<Run> _runsV;
+		std::vector<double> _basisV;
+		std::vector<double> _derivativeV;
+		int _countV = 0;
+	};
+}
@@ -0,0 +1,131 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNGeometryDefinitions.h"
+#include "LNBezierSurfaceCache.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "Constants.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Bezier patch (PatchU, PatchV) of surface Surface found by a query.
+	/// </summary>
+	struct LNGeometry_EXPORT LNPatchReference
+	{
+		int Surface = -1;
+		int PatchU = 0;
+		int PatchV = 0;
+
+		/// <summary>
+		/// Ray queries: parameter where the ray enters the patch box. Nearest queries: distance to the patch box.
+		/// </summary>
+		double Distance = 0.0;
+	};
+
+	/// <summary>
+	/// Bounding volume hierarchy over a set of NURBS surfaces, to cull candidates before exact queries.
+	/// 
+	/// Primitives are the Bezier patches of every surface, bounded by their control points (convex hull property),
+	/// which is much tighter than the control net of the whole surface. Without patch bounds, every surface is one
+	/// primitive bounded by its control net. Built with binned SAH like LNMeshBVH, boxes are kept in double precision.
+	/// </summary>
+	class LNGeometry_EXPORT LNSurfaceBVH
+	{
+	public:
+
+		/// <summary>
+		/// Invalid surfaces are skipped and never reported, return false if any was skipped.
+		/// </summary>
+		bool Build(const std::vector<LNLib::LN_NurbsSurface>& surfaces, bool usePatchBounds = true, int maxLeafSize = 4);
+
+		/// <summary>
+		/// Patch bounds from decompositions already built, one per surface. Empty caches are skipped like invalid surfaces.
+		/// </summary>
+		bool Build(const std::vector<LNBezierSurfaceCache>& caches, int maxLeafSize = 4);
+
+		bool IsEmpty() const;
+
+		int GetNodeCount() const;
+
+		int GetPatchCount() const;
+
+		/// <summary>
+		/// Bounds of surface, return false if it was skipped.
+		/// </summary>
+		bool GetBounds(int surface, LNLib::XYZ& minimum, LNLib::XYZ& maximum) const;
+
+		/// <summary>
+		/// Patches whose box is hit by ray origin + t * direction for t in [0, maxDistance], sorted by entry parameter.
+		/// </summary>
+		void Intersect(const LNLib::XYZ& origin, const LNLib::XYZ& direction, std::vector<LNPatchReference>& patches, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+		/// <summary>
+		/// Batched ray queries in parallel.
+		/// </summary>
+		void Intersect(const std::vector<LNLib::XYZ>& origins, const std::vector<LNLib::XYZ>& directions, std::vector<std::vector<LNPatchReference>>& patches, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+		/// <summary>
+		/// Surfaces with a patch box overlapping box [minimum, maximum], sorted and unique.
+		/// </summary>
+		void GetSurfaces(const LNLib::XYZ& minimum, const LNLib::XYZ& maximum, std::vector<int>& surfaces) const;
+
+		/// <summary>
+		/// Pairs of patches of different surfaces whose boxes, grown by tolerance, overlap.
+		/// The first patch of a pair belongs to the surface with the lower index, pairs are sorted by surfaces then patches.
+		/// </summary>
+		void GetOverlappingPatches(std::vector<std::pair<LNPatchReference, LNPatchReference>>& pairs, double tolerance = 0.0) const;
+
+		/// <summary>
+		/// Pairs of patches of surfaces a and b whose boxes, grown by tolerance, overlap.
+		/// The first patch of a pair belongs to a, pairs are sorted by patches.
+		/// </summary>
+		void GetOverlappingPatches(int a, int b, std::vector<std::pair<LNPatchReference, LNPatchReference>>& pairs, double tolerance = 0.0) const;
+
+		/// <summary>
+		/// Patches that may contain the closest surface point to point, sorted by box distance.
+		/// Patch corners lie on the surface, so every patch whose box is farther than the nearest corner is culled.
+		/// </summary>
+		void GetNearestPatches(const LNLib::XYZ& point, std::vector<LNPatchReference>& patches, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+	private:
+
+		struct Node
+		{
+			double Min[3];
+			double Max[3];
+			// Interior: offset from this node to the right child. Leaf: first primitive.
+			uint32_t Offset;
+			// Zero for interior node.
+			uint32_t Count;
+		};
+
+		struct Primitive
+		{
+			double Min[3];
+			double Max[3];
+			double Corners[4][3];
+			int Surface;
+			int PatchU;
+			int PatchV;
+		};
+
+		bool BuildNodes(std::vector<std::vector<Primitive>>& surfacePrimitives, int maxLeafSize);
+
+		std::vector<Node> _nodes;
+		std::vector<Primitive> _primitives;
+		std::vector<double> _surfaceBounds;
+	};
+}
@@ -0,0 +1,116 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNGeometryDefinitions.h"
+#include "LNBezierSurfaceCache.h"
+#include "LNSurfaceBVH.h"
+#include "LNObject.h"
+#include "Constants.h"
+#include "XYZ.h"
+#include "UV.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	struct LNGeometry_EXPORT LNIntersectionOptions
+	{
+		/// <summary>
+		/// Points of both surfaces closer than Tolerance are the same point.
+		/// </summary>
+		double Tolerance = 1E-6;
+
+		/// <summary>
+		/// Max distance between a polyline segment and the intersection curve.
+		/// </summary>
+		double ChordalTolerance = 1E-3;
+
+		/// <summary>
+		/// Max turn of the curve tangent along one segment, in radians.
+		/// </summary>
+		double AngleTolerance = LNLib::Constants::Pi / 18.0;
+
+		/// <summary>
+		/// Max segment length, zero takes an eighth of the smaller surface's bounding box diagonal.
+		/// </summary>
+		double MaxStep = 0.0;
+
+		/// <summary>
+		/// Max number of Bezier subdivisions of a patch pair while searching seed points.
+		/// </summary>
+		int MaxSubdivisionDepth = 16;
+	};
+
+	struct LNGeometry_EXPORT LNIntersectionPoint
+	{
+		LNLib::XYZ Point;
+		LNLib::UV ParameterA;
+		LNLib::UV ParameterB;
+	};
+
+	struct LNGeometry_EXPORT LNIntersectionCurve
+	{
+		int SurfaceA = -1;
+		int SurfaceB = -1;
+
+		/// <summary>
+		/// Closed curves do not repeat their first point at the end.
+		/// </summary>
+		bool IsClosed = false;
+		std::vector<LNIntersectionPoint> Points;
+	};
+
+	/// <summary>
+	/// Intersection curves between NURBS surfaces of a set, as polylines with parameters on both surfaces.
+	/// 
+	/// Candidate patch pairs come from LNSurfaceBVH. Each pair is subdivided (de Casteljau on the homogeneous Bezier nets)
+	/// while the control point boxes of both halves still overlap, until both are flat, and Newton iteration from the
+	/// remaining boxes gives seed points. Curves are marched from the seeds with a tangent predictor and a Newton corrector
+	/// on the plane normal to the tangent, with step length adapted to ChordalTolerance and AngleTolerance, until they
+	/// close, leave either surface (the last point is placed on the boundary) or become tangential. Seeds lying on a
+	/// traced curve are dropped. Patch pairs are searched in parallel, then surface pairs are traced in parallel.
+	/// </summary>
+	/// <remarks>
+	/// Tangential contact and coincident regions are not traced. Closed surfaces end curves at their seams.
+	/// </remarks>
+	class LNGeometry_EXPORT LNSurfaceIntersector
+	{
+	public:
+
+		/// <summary>
+		/// Invalid surfaces are skipped and never intersected, return false if any was skipped.
+		/// </summary>
+		bool Build(const std::vector<LNLib::LN_NurbsSurface>& surfaces);
+
+		bool IsEmpty() const;
+
+		const LNSurfaceBVH& GetBVH() const;
+
+		/// <summary>
+		/// Intersection curves between surfaces a and b, SurfaceA of every curve is a.
+		/// </summary>
+		void Intersect(int a, int b, std::vector<LNIntersectionCurve>& curves, const LNIntersectionOptions& options = LNIntersectionOptions()) const;
+
+		/// <summary>
+		/// Intersection curves between all pairs of surfaces, SurfaceA < SurfaceB, sorted by surface pair.
+		/// </summary>
+		void IntersectAll(std::vector<LNIntersectionCurve>& curves, const LNIntersectionOptions& options = LNIntersectionOptions()) const;
+
+	private:
+
+		/// <summary>
+		/// Trace overlapping patch pairs, pairs of the same surfaces must be consecutive.
+		/// </summary>
+		void Intersect(const std::vector<std::pair<LNPatchReference, LNPatchReference>>& pairs, std::vector<LNIntersectionCurve>& curves, const LNIntersectionOptions& options) const;
+
+		std::vector<LNBezierSurfaceCache> _caches;
+		LNSurfaceBVH _bvh;
+	};
+}
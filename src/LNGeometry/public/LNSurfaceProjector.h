@@ -0,0 +1,78 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNGeometryDefinitions.h"
+#include "LNBezierSurfaceCache.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "UV.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	struct LNGeometry_EXPORT LNSurfaceProjection
+	{
+		LNLib::UV Parameter;
+		LNLib::XYZ Point;
+		double Distance = 0.0;
+	};
+
+	/// <summary>
+	/// Closest point projection of many points onto one NURBS surface.
+	/// 
+	/// Build samples the surface on a grid refined per knot span and puts the samples in a k-d tree.
+	/// Each query seeds Newton iteration (The NURBS Book 6.1) from the parameter of its nearest sample
+	/// and evaluates through LNBezierSurfaceCache. Parameters wrap across the seam of closed directions
+	/// and are clamped at open boundaries. Where iteration does not settle, like across C0 creases,
+	/// the closest iterate is returned.
+	/// </summary>
+	class LNGeometry_EXPORT LNSurfaceProjector
+	{
+	public:
+
+		/// <summary>
+		/// Return false if surface is invalid. More samples per span give safer seeds on strongly curved surfaces.
+		/// </summary>
+		bool Build(const LNLib::LN_NurbsSurface& surface, int samplesPerSpan = 8);
+
+		bool IsEmpty() const;
+
+		const LNBezierSurfaceCache& GetCache() const;
+
+		LNSurfaceProjection Project(const LNLib::XYZ& point) const;
+
+		/// <summary>
+		/// Batched projection in parallel, projections[i] belongs to points[i].
+		/// </summary>
+		void Project(const std::vector<LNLib::XYZ>& points, std::vector<LNSurfaceProjection>& projections) const;
+
+	private:
+
+		/// <summary>
+		/// Implicit k-d tree node: the median of range [begin, end) sits at (begin + end) / 2.
+		/// </summary>
+		struct Sample
+		{
+			double Position[3];
+			double U;
+			double V;
+			int Axis;
+		};
+
+		void BuildTree(int begin, int end);
+		void FindNearest(int begin, int end, const double* point, int& nearest, double& distance) const;
+
+		LNBezierSurfaceCache _cache;
+		std::vector<Sample> _samples;
+		bool _isClosedU = false;
+		bool _isClosedV = false;
+	};
+}
@@ -0,0 +1,105 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNGeometryDefinitions.h"
+#include "LNBezierSurfaceCache.h"
+#include "LNObject.h"
+#include "Constants.h"
+#include "XYZ.h"
+#include "UV.h"
+#include <cstdint>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	struct LNGeometry_EXPORT LNSurfaceHit
+	{
+		bool IsHit = false;
+
+		/// <summary>
+		/// Ray parameter t of the hit, the point is origin + t * direction.
+		/// </summary>
+		double Distance = 0.0;
+		LNLib::UV Parameter;
+		LNLib::XYZ Point;
+	};
+
+	/// <summary>
+	/// Ray casting against the exact geometry of one NURBS surface.
+	/// 
+	/// Build subdivides every Bezier patch of LNBezierSurfaceCache (de Casteljau on the homogeneous net) until the
+	/// sub-patches are nearly flat, and keeps the subdivision as a bounding volume hierarchy. Rays descend it in packets
+	/// of four, every node is tested against the whole packet with SSE2 in double precision, and each leaf hit seeds
+	/// Newton iteration on S(u, v) = origin + t * direction from the intersection with the leaf plane. The closest hit wins.
+	/// </summary>
+	/// <remarks>
+	/// Rays grazing the surface at a silhouette may be missed where Newton iteration does not converge.
+	/// </remarks>
+	class LNGeometry_EXPORT LNSurfaceRayCaster
+	{
+	public:
+
+		/// <summary>
+		/// Return false if surface is invalid.
+		/// </summary>
+		bool Build(const LNLib::LN_NurbsSurface& surface);
+
+		bool IsEmpty() const;
+
+		int GetNodeCount() const;
+
+		int GetLeafCount() const;
+
+		const LNBezierSurfaceCache& GetCache() const;
+
+		/// <summary>
+		/// Closest hit of ray origin + t * direction for t in [0, maxDistance].
+		/// </summary>
+		bool Intersect(const LNLib::XYZ& origin, const LNLib::XYZ& direction, LNSurfaceHit& hit, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+		/// <summary>
+		/// Batched ray casting in parallel, consecutive rays are traced together as packets,
+		/// so coherent rays (like rows of a view) share node tests.
+		/// </summary>
+		void Intersect(const std::vector<LNLib::XYZ>& origins, const std::vector<LNLib::XYZ>& directions, std::vector<LNSurfaceHit>& hits, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+	private:
+
+		struct Node
+		{
+			float Min[3];
+			// Interior: offset from this node to the right child. Leaf: leaf index.
+			uint32_t Offset;
+			float Max[3];
+			// Zero for interior node.
+			uint32_t Count;
+		};
+
+		/// <summary>
+		/// Nearly flat sub-patch over parameter rectangle Domain, approximated by the parallelogram
+		/// Center + a * AxisU + b * AxisV with a, b in [-1, 1], lying in plane Normal . X = Offset.
+		/// </summary>
+		struct Leaf
+		{
+			double Domain[2][2];
+			double Center[3];
+			double AxisU[3];
+			double AxisV[3];
+			double Normal[3];
+			double Offset;
+		};
+
+		LNBezierSurfaceCache _cache;
+		std::vector<Node> _nodes;
+		std::vector<Leaf> _leaves;
+		double _tolerance = 0.0;
+	};
+}
@@ -0,0 +1,112 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMassAccumulator.h"
+#include "LNMassProperties.h"
+#include "XYZ.h"
+
+#include <cmath>
+
+namespace
+{
+    enum Integral
+    {
+        Area = 0,
+        Volume,
+        X, Y, Z,
+        XX, YY, ZZ,
+        XY, YZ, ZX
+    };
+}
+
+LNLibEx::LNMassAccumulator::LNMassAccumulator(const LNLib::XYZ& origin):
+                                                _origin(origin){}
+
+void LNLibEx::LNMassAccumulator::Add(int integral, double value)
+{
+    // Neumaier summation keeps the low order bits lost by each addition.
+    double sum = _sums[integral] + value;
+    if (std::fabs(_sums[integral]) >= std::fabs(value)) {
+        _compensations[integral] += (_sums[integral] - sum) + value;
+    }
+    else {
+        _compensations[integral] += (value - sum) + _sums[integral];
+    }
+    _sums[integral] = sum;
+}
+
+void LNLibEx::LNMassAccumulator::AddTriangle(const LNLib::XYZ& a, const LNLib::XYZ& b, const LNLib::XYZ& c)
+{
+    const LNLib::XYZ p = a - _origin;
+    const LNLib::XYZ q = b - _origin;
+    const LNLib::XYZ r = c - _origin;
+    const LNLib::XYZ normal = (q - p).CrossProduct(r - p);
+    const double det = p.DotProduct(q.CrossProduct(r));
+
+    Add(Area, 0.5 * normal.Length());
+    Add(Volume, det / 6.0);
+
+    // Tetrahedron (0, p, q, r) moments, see Tonon, Explicit exact formulas for the 3-D tetrahedron inertia tensor.
+    double square[3];
+    double product[3];
+    for (int i = 0; i < 3; i++) {
+        Add(X + i, det * (p[i] + q[i] + r[i]) / 24.0);
+        square[i] = p[i] * p[i] + q[i] * q[i] + r[i] * r[i] + p[i] * q[i] + q[i] * r[i] + r[i] * p[i];
+        int j = (i + 1) % 3;
+        product[i] = 2.0 * (p[i] * p[j] + q[i] * q[j] + r[i] * r[j]) +
+            p[i] * q[j] + p[j] * q[i] + p[i] * r[j] + p[j] * r[i] + q[i] * r[j] + q[j] * r[i];
+    }
+    for (int i = 0; i < 3; i++) {
+        Add(XX + i, det * square[i] / 60.0);
+        Add(XY + i, det * product[i] / 120.0);
+    }
+}
+
+void LNLibEx::LNMassAccumulator::Merge(const LNMassAccumulator& other)
+{
+    for (int i = 0; i < IntegralCount; i++) {
+        Add(i, other._sums[i]);
+        Add(i, other._compensations[i]);
+    }
+}
+
+void LNLibEx::LNMassAccumulator::GetProperties(LNMassProperties& properties) const
+{
+    double values[IntegralCount];
+    for (int i = 0; i < IntegralCount; i++) {
+        values[i] = _sums[i] + _compensations[i];
+    }
+
+    properties = LNMassProperties();
+    properties.Area = values[Area];
+    properties.Volume = values[Volume];
+    properties.Centroid = _origin;
+    if (values[Volume] == 0.0) {
+        return;
+    }
+
+    const double volume = values[Volume];
+    const double center[3] = { values[X] / volume, values[Y] / volume, values[Z] / volume };
+    properties.Centroid = _origin + LNLib::XYZ(center[0], center[1], center[2]);
+
+    // Second moments about the centroid by the parallel axis theorem.
+    double second[3][3];
+    for (int i = 0; i < 3; i++) {
+        int j = (i + 1) % 3;
+        second[i][i] = values[XX + i] - volume * center[i] * center[i];
+        second[i][j] = second[j][i] = values[XY + i] - volume * center[i] * center[j];
+    }
+    const double trace = second[0][0] + second[1][1] + second[2][2];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            properties.Inertia[3 * i + j] = (i == j ? trace : 0.0) - second[i][j];
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNMassProperties.h"
+#include "XYZ.h"
+#include "LNParallel.h"
+#include <cstdint>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Compensated sums of area, volume, first and second moments over triangles.
+	/// 
+	/// Every triangle spans a tetrahedron with origin, whose signed integrals add up to those of the enclosed solid.
+	/// Coordinates are taken relative to origin, pick a point on the mesh to keep the sums small.
+	/// </summary>
+	class LNMassAccumulator
+	{
+	private:
+
+		static const int IntegralCount = 11;
+
+		LNLib::XYZ _origin;
+		double _sums[IntegralCount] = {};
+		double _compensations[IntegralCount] = {};
+
+	private:
+
+		void Add(int integral, double value);
+
+	public:
+
+		explicit LNMassAccumulator(const LNLib::XYZ& origin = LNLib::XYZ(0, 0, 0));
+
+		void AddTriangle(const LNLib::XYZ& a, const LNLib::XYZ& b, const LNLib::XYZ& c);
+		void Merge(const LNMassAccumulator& other);
+		void GetProperties(LNMassProperties& properties) const;
+
+		/// <summary>
+		/// Call function(i, accumulator) for every i in [0, count) across threads, each chunk adds to its own accumulator.
+		/// Partial sums are merged in chunk order, so the result does not depend on thread timing.
+		/// </summary>
+		template <typename Function>
+		void AddParallel(int64_t count, Function&& function)
+		{
+			const int64_t grain = 4096;
+			std::vector<LNMassAccumulator> partials(LNParallel::GetChunkCount(0, count, grain), LNMassAccumulator(_origin));
+			LNParallel::ForEachChunk(0, count, grain, [&](int chunk, int64_t begin, int64_t end) {
+				for (int64_t i = begin; i < end; i++) {
+					function(i, partials[chunk]);
+				}
+			});
+			for (const auto& partial : partials) {
+				Merge(partial);
+			}
+		}
+	};
+}
@@ -9,98 +9,193 @@
  */
 
 #include "LNMesh.h"
+#include "LNFloatMesh.h"
 #include "LNObject.h"
 #include "XYZ.h"
 #include "UV.h"
+#include "LNBinaryUtils.h"
+#include "LNMappedFile.h"
+#include "LNNormalGenerator.h"
+#include "LNMeshSimplifier.h"
+#include "LNVertexCacheOptimizer.h"
+#include "LNSpatialSorter.h"
+#include "LNMeshCodec.h"
+#include "LNMeshRepairer.h"
+#include "LNMeshComponents.h"
+#include "LNMeshReorder.h"
+#include "LNMassAccumulator.h"
 
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 
-#pragma region OBJ
-bool LNLibEx::LNMesh::FromOBJFile(const std::string& filePath, LNLib::LN_Mesh& mesh)
+#pragma region Readers
+namespace
 {
-    std::vector<LNLib::XYZ> temp_vertices;
-    std::vector<LNLib::UV> temp_uvs;
-    std::vector<LNLib::XYZ> temp_normals;
+    // Both mesh types are filled through these overloads, so each reader is written once.
+    size_t getVertexCount(const LNLib::LN_Mesh& mesh) {
+        return mesh.Vertices.size();
+    }
 
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        return false;
+    size_t getVertexCount(const LNLibEx::LNFloatMesh& mesh) {
+        return mesh.Vertices.size() / 3;
+    }
+
+    size_t getNormalCount(const LNLib::LN_Mesh& mesh) {
+        return mesh.Normals.size();
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
+    size_t getNormalCount(const LNLibEx::LNFloatMesh& mesh) {
+        return mesh.Normals.size() / 3;
+    }
 
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
+    size_t getUVCount(const LNLib::LN_Mesh& mesh) {
+        return mesh.UVs.size();
+    }
 
-        if (prefix == "v") { 
-            LNLib::XYZ vertex;
-            iss >> vertex.X() >> vertex.Y() >> vertex.Z();
-            temp_vertices.push_back(vertex);
-        }
-        else if (prefix == "vt") {
-            LNLib::UV uv;
-            iss >> uv.U() >> uv.V();
-            temp_uvs.push_back(uv);
-        }
-        else if (prefix == "vn") {
-            LNLib::XYZ normal;
-            iss >> normal.X() >> normal.Y() >> normal.Z();
-            temp_normals.push_back(normal);
+    size_t getUVCount(const LNLibEx::LNFloatMesh& mesh) {
+        return mesh.UVs.size() / 2;
+    }
+
+    void addVertex(LNLib::LN_Mesh& mesh, double x, double y, double z) {
+        mesh.Vertices.emplace_back(x, y, z);
+    }
+
+    void addVertex(LNLibEx::LNFloatMesh& mesh, double x, double y, double z) {
+        mesh.Vertices.insert(mesh.Vertices.end(), { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) });
+    }
+
+    void addUV(LNLib::LN_Mesh& mesh, double u, double v) {
+        mesh.UVs.emplace_back(u, v);
+    }
+
+    void addUV(LNLibEx::LNFloatMesh& mesh, double u, double v) {
+        mesh.UVs.insert(mesh.UVs.end(), { static_cast<float>(u), static_cast<float>(v) });
+    }
+
+    void addNormal(LNLib::LN_Mesh& mesh, double x, double y, double z) {
+        mesh.Normals.emplace_back(x, y, z);
+    }
+
+    void addNormal(LNLibEx::LNFloatMesh& mesh, double x, double y, double z) {
+        mesh.Normals.insert(mesh.Normals.end(), { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) });
+    }
+
+    void addFace(LNLib::LN_Mesh& mesh, const std::vector<int>& face) {
+        mesh.Faces.push_back(face);
+    }
+
+    void addFace(LNLibEx::LNFloatMesh& mesh, const std::vector<int>& face) {
+        if (mesh.FaceOffsets.empty()) {
+            mesh.FaceOffsets.push_back(static_cast<int>(mesh.FaceIndices.size()));
         }
-        else if (prefix == "f") {
-            std::vector<int> faceVertices;
-            std::vector<int> faceUVs;
-            std::vector<int> faceNormals;
+        mesh.FaceIndices.insert(mesh.FaceIndices.end(), face.begin(), face.end());
+        mesh.FaceOffsets.push_back(static_cast<int>(mesh.FaceIndices.size()));
+    }
+}
+#pragma endregion
 
-            std::string faceData;
-            while (iss >> faceData) {
-                std::replace(faceData.begin(), faceData.end(), '/', ' ');
-                std::istringstream faceDataStream(faceData);
+#pragma region OBJ
+namespace
+{
+    template <typename Mesh>
+    bool readOBJ(std::ifstream& file, Mesh& mesh) {
+        // Attributes are appended straight into mesh, without an intermediate double buffer.
+        mesh.Vertices.clear();
+        mesh.UVs.clear();
+        mesh.Normals.clear();
 
-                int vIdx = -1, uvIdx = -1, nIdx = -1;
-                faceDataStream >> vIdx;
-                if (faceDataStream.peek() != ' ' && !faceDataStream.eof()) {
-                    faceDataStream >> uvIdx;
-                }
-                if (faceDataStream.peek() != ' ' && !faceDataStream.eof()) {
-                    faceDataStream >> nIdx;
-                }
-                if (vIdx > 0) {
-                    faceVertices.push_back(vIdx - 1);
-                }
-                if (uvIdx > 0 && !temp_uvs.empty()) {
-                    faceUVs.push_back(uvIdx - 1);
-                }
-                if (nIdx > 0 && !temp_normals.empty()) {
-                    faceNormals.push_back(nIdx - 1);
-                }
-            }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+
+            std::istringstream iss(line);
+            std::string prefix;
+            iss >> prefix;
 
-            if (!faceVertices.empty()) {
-                mesh.Faces.push_back(faceVertices);
+            if (prefix == "v") { 
+                double x = 0, y = 0, z = 0;
+                iss >> x >> y >> z;
+                addVertex(mesh, x, y, z);
             }
-            if (!faceUVs.empty()) {
-                for (int idx : faceUVs) {
-                    mesh.UVIndices.push_back(idx);
-                }
+            else if (prefix == "vt") {
+                double u = 0, v = 0;
+                iss >> u >> v;
+                addUV(mesh, u, v);
             }
-            if (!faceNormals.empty()) {
-                for (int idx : faceNormals) {
-                    mesh.NormalIndices.push_back(idx);
+            else if (prefix == "vn") {
+                double x = 0, y = 0, z = 0;
+                iss >> x >> y >> z;
+                addNormal(mesh, x, y, z);
+            }
+            else if (prefix == "f") {
+                std::vector<int> faceVertices;
+                std::vector<int> faceUVs;
+                std::vector<int> faceNormals;
+
+                std::string faceData;
+                while (iss >> faceData) {
+                    std::replace(faceData.begin(), faceData.end(), '/', ' ');
+                    std::istringstream faceDataStream(faceData);
+
+                    int vIdx = -1, uvIdx = -1, nIdx = -1;
+                    faceDataStream >> vIdx;
+                    if (faceDataStream.peek() != ' ' && !faceDataStream.eof()) {
+                        faceDataStream >> uvIdx;
+                    }
+                    if (faceDataStream.peek() != ' ' && !faceDataStream.eof()) {
+                        faceDataStream >> nIdx;
+                    }
+                    if (vIdx > 0) {
+                        faceVertices.push_back(vIdx - 1);
+                    }
+                    if (uvIdx > 0 && getUVCount(mesh) > 0) {
+                        faceUVs.push_back(uvIdx - 1);
+                    }
+                    if (nIdx > 0 && getNormalCount(mesh) > 0) {
+                        faceNormals.push_back(nIdx - 1);
+                    }
+                }
+
+                if (!faceVertices.empty()) {
+                    addFace(mesh, faceVertices);
+                }
+                if (!faceUVs.empty()) {
+                    for (int idx : faceUVs) {
+                        mesh.UVIndices.push_back(idx);
+                    }
+                }
+                if (!faceNormals.empty()) {
+                    for (int idx : faceNormals) {
+                        mesh.NormalIndices.push_back(idx);
+                    }
                 }
             }
         }
+        return true;
+    }
+}
+
+bool LNLibEx::LNMesh::FromOBJFile(const std::string& filePath, LNLib::LN_Mesh& mesh)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+    return readOBJ(file, mesh);
+}
+
+bool LNLibEx::LNMesh::FromOBJFile(const std::string& filePath, LNFloatMesh& mesh)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return false;
     }
-    mesh.Vertices = std::move(temp_vertices);
-    mesh.UVs = std::move(temp_uvs);
-    mesh.Normals = std::move(temp_normals);
+    return readOBJ(file, mesh);
 }
 #pragma endregion
 
@@ -132,40 +227,38 @@ namespace
         return fileSize == (84 + facetCount * 50);
     }
 
-    bool readBinarySTL(std::ifstream& file, LNLib::LN_Mesh& mesh) {
+    template <typename Mesh>
+    bool readBinarySTL(std::ifstream& file, Mesh& mesh) {
 
         file.seekg(80, std::ios::beg);
         uint32_t facetCount;
         file.read(reinterpret_cast<char*>(&facetCount), 4);
 
+        char facet[50];
+        float values[12];
         for (uint32_t i = 0; i < facetCount; ++i) {
-            LNLib::XYZ normal;
-            file.read(reinterpret_cast<char*>(&normal.X()), 4);
-            file.read(reinterpret_cast<char*>(&normal.Y()), 4);
-            file.read(reinterpret_cast<char*>(&normal.Z()), 4);
-            mesh.Normals.push_back(normal);
+            if (!file.read(facet, sizeof(facet))) {
+                return false;
+            }
+            std::memcpy(values, facet, sizeof(values));
+            addNormal(mesh, values[0], values[1], values[2]);
 
             std::vector<int> faceIndices;
             for (int j = 0; j < 3; ++j) {
-                LNLib::XYZ vertex;
-                file.read(reinterpret_cast<char*>(&vertex.X()), 4);
-                file.read(reinterpret_cast<char*>(&vertex.Y()), 4);
-                file.read(reinterpret_cast<char*>(&vertex.Z()), 4);
-
-                mesh.Vertices.push_back(vertex);
-                faceIndices.push_back(mesh.Vertices.size() - 1);
-                mesh.NormalIndices.push_back(mesh.Normals.size() - 1);
+                addVertex(mesh, values[3 + 3 * j], values[4 + 3 * j], values[5 + 3 * j]);
+                faceIndices.push_back(static_cast<int>(getVertexCount(mesh) - 1));
+                mesh.NormalIndices.push_back(static_cast<int>(getNormalCount(mesh) - 1));
             }
-            mesh.Faces.push_back(faceIndices);
-            file.seekg(2, std::ios::cur);
+            addFace(mesh, faceIndices);
         }
         return true;
     }
 
-    bool readASCIISTL(std::ifstream& file, LNLib::LN_Mesh& mesh) {
+    template <typename Mesh>
+    bool readASCIISTL(std::ifstream& file, Mesh& mesh) {
         std::string line;
         std::vector<int> currentFaceIndices;
-        LNLib::XYZ currentNormal;
+        double currentNormal[3] = { 0, 0, 0 };
         bool hasNormal = false;
         int vertexIndex = 0;
 
@@ -178,25 +271,25 @@ namespace
             iss >> keyword;
 
             if (startsWith(keyword, "facet") && iss >> keyword && startsWith(keyword, "normal")) {
-                iss >> currentNormal.X() >> currentNormal.Y() >> currentNormal.Z();
+                iss >> currentNormal[0] >> currentNormal[1] >> currentNormal[2];
                 hasNormal = true;
                 currentFaceIndices.clear();
             }
             else if (startsWith(keyword, "vertex")) {
-                LNLib::XYZ vertex;
-                iss >> vertex.X() >> vertex.Y() >> vertex.Z();
-                mesh.Vertices.push_back(vertex);
+                double x = 0, y = 0, z = 0;
+                iss >> x >> y >> z;
+                addVertex(mesh, x, y, z);
                 currentFaceIndices.push_back(vertexIndex++);
             }
             else if (startsWith(keyword, "endfacet") || 
                         (startsWith(keyword, "end") && iss >> keyword && startsWith(keyword, "facet"))){
                 if (currentFaceIndices.size() >= 3) {
-                    mesh.Faces.push_back(currentFaceIndices);
+                    addFace(mesh, currentFaceIndices);
 
                     if (hasNormal) {
-                        mesh.Normals.push_back(currentNormal);
+                        addNormal(mesh, currentNormal[0], currentNormal[1], currentNormal[2]);
                         for (size_t i = 0; i < currentFaceIndices.size(); ++i) {
-                            mesh.NormalIndices.push_back(mesh.Normals.size() - 1);
+                            mesh.NormalIndices.push_back(static_cast<int>(getNormalCount(mesh) - 1));
                         }
                     }
                 }
@@ -205,26 +298,502 @@ namespace
         }
         return true;
     }
+
+    template <typename Mesh>
+    bool readSTL(const std::string& filePath, Mesh& mesh) {
+        std::ifstream file(filePath, std::ios::binary);
+
+        if (!file.is_open()) {
+            return false;
+        }
+        bool binary = isBinarySTL(file);
+
+        if (binary) {
+            return readBinarySTL(file, mesh);
+        }
+        else {
+            file.seekg(0, std::ios::beg);
+            file.close();
+            file.open(filePath);
+            return readASCIISTL(file, mesh);
+        }
+    }
 }
+
 bool LNLibEx::LNMesh::FromSTLFile(const std::string& filePath, LNLib::LN_Mesh& mesh)
 {
-    std::ifstream file(filePath, std::ios::binary);
+    return readSTL(filePath, mesh);
+}
+
+bool LNLibEx::LNMesh::FromSTLFile(const std::string& filePath, LNFloatMesh& mesh)
+{
+    return readSTL(filePath, mesh);
+}
+#pragma endregion
+
+#pragma region Float
+void LNLibEx::LNMesh::ToMesh(const LNFloatMesh& source, LNLib::LN_Mesh& mesh)
+{
+    mesh = LNLib::LN_Mesh();
+    mesh.Vertices.reserve(source.Vertices.size() / 3);
+    for (size_t i = 0; i + 2 < source.Vertices.size(); i += 3) {
+        mesh.Vertices.emplace_back(source.Vertices[i], source.Vertices[i + 1], source.Vertices[i + 2]);
+    }
+    if (!source.FaceOffsets.empty()) {
+        mesh.Faces.reserve(source.FaceOffsets.size() - 1);
+        for (size_t i = 0; i + 1 < source.FaceOffsets.size(); i++) {
+            mesh.Faces.emplace_back(source.FaceIndices.begin() + source.FaceOffsets[i], source.FaceIndices.begin() + source.FaceOffsets[i + 1]);
+        }
+    }
+    mesh.UVs.reserve(source.UVs.size() / 2);
+    for (size_t i = 0; i + 1 < source.UVs.size(); i += 2) {
+        mesh.UVs.emplace_back(source.UVs[i], source.UVs[i + 1]);
+    }
+    mesh.UVIndices = source.UVIndices;
+    mesh.Normals.reserve(source.Normals.size() / 3);
+    for (size_t i = 0; i + 2 < source.Normals.size(); i += 3) {
+        mesh.Normals.emplace_back(source.Normals[i], source.Normals[i + 1], source.Normals[i + 2]);
+    }
+    mesh.NormalIndices = source.NormalIndices;
+}
+
+void LNLibEx::LNMesh::ToFloatMesh(const LNLib::LN_Mesh& source, LNFloatMesh& mesh)
+{
+    mesh = LNFloatMesh();
+    mesh.Vertices.reserve(3 * source.Vertices.size());
+    for (const auto& vertex : source.Vertices) {
+        addVertex(mesh, vertex.GetX(), vertex.GetY(), vertex.GetZ());
+    }
+    for (const auto& face : source.Faces) {
+        addFace(mesh, face);
+    }
+    mesh.UVs.reserve(2 * source.UVs.size());
+    for (const auto& uv : source.UVs) {
+        mesh.UVs.insert(mesh.UVs.end(), { static_cast<float>(uv.GetU()), static_cast<float>(uv.GetV()) });
+    }
+    mesh.UVIndices = source.UVIndices;
+    mesh.Normals.reserve(3 * source.Normals.size());
+    for (const auto& normal : source.Normals) {
+        addNormal(mesh, normal.GetX(), normal.GetY(), normal.GetZ());
+    }
+    mesh.NormalIndices = source.NormalIndices;
+}
+#pragma endregion
+
+
+#pragma region Binary
+namespace
+{
+    const char BinaryMagic[4] = { 'L', 'N', 'M', 'B' };
+    const uint32_t BinaryVersion = 1;
+    const uint64_t BinaryAlignment = 64;
+
+    enum BinarySection
+    {
+        VerticesSection = 0,
+        FaceOffsetsSection,
+        FaceIndicesSection,
+        UVsSection,
+        UVIndicesSection,
+        NormalsSection,
+        NormalIndicesSection,
+        BinarySectionCount
+    };
+
+    struct BinarySectionEntry
+    {
+        uint64_t Offset;
+        uint64_t Count;
+    };
+
+    struct BinaryHeader
+    {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t HeaderSize;
+        uint32_t SectionCount;
+        uint64_t FileSize;
+        uint64_t Checksum;
+        BinarySectionEntry Sections[BinarySectionCount];
+    };
+
+    const uint64_t BinaryElementSize[BinarySectionCount] = {
+        3 * sizeof(double),
+        sizeof(uint32_t),
+        sizeof(int32_t),
+        2 * sizeof(double),
+        sizeof(int32_t),
+        3 * sizeof(double),
+        sizeof(int32_t),
+    };
+
+    void writeXYZs(const std::vector<LNLib::XYZ>& source, char* target) {
+        double* values = reinterpret_cast<double*>(target);
+        for (size_t i = 0; i < source.size(); i++) {
+            values[3 * i] = source[i].GetX();
+            values[3 * i + 1] = source[i].GetY();
+            values[3 * i + 2] = source[i].GetZ();
+        }
+    }
+
+    void readXYZs(const unsigned char* source, uint64_t count, std::vector<LNLib::XYZ>& target) {
+        const double* values = reinterpret_cast<const double*>(source);
+        target.clear();
+        target.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            target.emplace_back(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+        }
+    }
+
+    void readIndices(const unsigned char* source, uint64_t count, std::vector<int>& target) {
+        const int32_t* values = reinterpret_cast<const int32_t*>(source);
+        target.assign(values, values + count);
+    }
+}
+
+bool LNLibEx::LNMesh::ToBinaryFile(const LNLib::LN_Mesh& mesh, const std::string& filePath)
+{
+    if (!LNBinaryUtils::IsLittleEndian()) {
+        return false;
+    }
+
+    uint64_t faceIndexCount = 0;
+    for (const auto& face : mesh.Faces) {
+        faceIndexCount += face.size();
+    }
+    if (faceIndexCount > UINT32_MAX) {
+        return false;
+    }
+
+    BinaryHeader header = {};
+    std::memcpy(header.Magic, BinaryMagic, sizeof(BinaryMagic));
+    header.Version = BinaryVersion;
+    header.HeaderSize = sizeof(BinaryHeader);
+    header.SectionCount = BinarySectionCount;
+    header.Sections[VerticesSection].Count = mesh.Vertices.size();
+    header.Sections[FaceOffsetsSection].Count = mesh.Faces.size() + 1;
+    header.Sections[FaceIndicesSection].Count = faceIndexCount;
+    header.Sections[UVsSection].Count = mesh.UVs.size();
+    header.Sections[UVIndicesSection].Count = mesh.UVIndices.size();
+    header.Sections[NormalsSection].Count = mesh.Normals.size();
+    header.Sections[NormalIndicesSection].Count = mesh.NormalIndices.size();
+
+    uint64_t offset = LNBinaryUtils::AlignUp(sizeof(BinaryHeader), BinaryAlignment);
+    const uint64_t payloadOffset = offset;
+    for (int i = 0; i < BinarySectionCount; i++) {
+        header.Sections[i].Offset = offset;
+        offset = LNBinaryUtils::AlignUp(offset + header.Sections[i].Count * BinaryElementSize[i], BinaryAlignment);
+    }
+    header.FileSize = offset;
+
+    std::vector<char> buffer(header.FileSize, 0);
+    writeXYZs(mesh.Vertices, buffer.data() + header.Sections[VerticesSection].Offset);
+
+    uint32_t* faceOffsets = reinterpret_cast<uint32_t*>(buffer.data() + header.Sections[FaceOffsetsSection].Offset);
+    int32_t* faceIndices = reinterpret_cast<int32_t*>(buffer.data() + header.Sections[FaceIndicesSection].Offset);
+    uint32_t corner = 0;
+    for (size_t i = 0; i < mesh.Faces.size(); i++) {
+        faceOffsets[i] = corner;
+        std::copy(mesh.Faces[i].begin(), mesh.Faces[i].end(), faceIndices + corner);
+        corner += static_cast<uint32_t>(mesh.Faces[i].size());
+    }
+    faceOffsets[mesh.Faces.size()] = corner;
+
+    double* uvs = reinterpret_cast<double*>(buffer.data() + header.Sections[UVsSection].Offset);
+    for (size_t i = 0; i < mesh.UVs.size(); i++) {
+        uvs[2 * i] = mesh.UVs[i].GetU();
+        uvs[2 * i + 1] = mesh.UVs[i].GetV();
+    }
+    std::copy(mesh.UVIndices.begin(), mesh.UVIndices.end(), reinterpret_cast<int32_t*>(buffer.data() + header.Sections[UVIndicesSection].Offset));
+    writeXYZs(mesh.Normals, buffer.data() + header.Sections[NormalsSection].Offset);
+    std::copy(mesh.NormalIndices.begin(), mesh.NormalIndices.end(), reinterpret_cast<int32_t*>(buffer.data() + header.Sections[NormalIndicesSection].Offset));
+
+    header.Checksum = LNBinaryUtils::Checksum64(buffer.data() + payloadOffset, header.FileSize - payloadOffset);
+    std::memcpy(buffer.data(), &header, sizeof(BinaryHeader));
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(buffer.data(), buffer.size());
+    return file.good();
+}
+
+bool LNLibEx::LNMesh::FromBinaryFile(const std::string& filePath, LNLib::LN_Mesh& mesh)
+{
+    if (!LNBinaryUtils::IsLittleEndian()) {
+        return false;
+    }
+
+    LNMappedFile file;
+    if (!file.Open(filePath) || file.Size() < sizeof(BinaryHeader)) {
+        return false;
+    }
+
+    BinaryHeader header;
+    std::memcpy(&header, file.Data(), sizeof(BinaryHeader));
+    if (std::memcmp(header.Magic, BinaryMagic, sizeof(BinaryMagic)) != 0 ||
+        header.Version != BinaryVersion ||
+        header.HeaderSize != sizeof(BinaryHeader) ||
+        header.SectionCount != BinarySectionCount ||
+        header.FileSize != file.Size()) {
+        return false;
+    }
+
+    const uint64_t payloadOffset = LNBinaryUtils::AlignUp(sizeof(BinaryHeader), BinaryAlignment);
+    for (int i = 0; i < BinarySectionCount; i++) {
+        const BinarySectionEntry& section = header.Sections[i];
+        if (section.Offset % BinaryAlignment != 0 || section.Offset < payloadOffset ||
+            section.Offset > header.FileSize ||
+            section.Count > (header.FileSize - section.Offset) / BinaryElementSize[i]) {
+            return false;
+        }
+    }
+    if (header.Sections[FaceOffsetsSection].Count == 0 ||
+        LNBinaryUtils::Checksum64(file.Data() + payloadOffset, header.FileSize - payloadOffset) != header.Checksum) {
+        return false;
+    }
+
+    const uint32_t* faceOffsets = reinterpret_cast<const uint32_t*>(file.Data() + header.Sections[FaceOffsetsSection].Offset);
+    const int32_t* faceIndices = reinterpret_cast<const int32_t*>(file.Data() + header.Sections[FaceIndicesSection].Offset);
+    const uint64_t faceCount = header.Sections[FaceOffsetsSection].Count - 1;
+    if (faceOffsets[0] != 0 || faceOffsets[faceCount] != header.Sections[FaceIndicesSection].Count) {
+        return false;
+    }
+    for (uint64_t i = 0; i < faceCount; i++) {
+        if (faceOffsets[i] > faceOffsets[i + 1]) {
+            return false;
+        }
+    }
+
+    readXYZs(file.Data() + header.Sections[VerticesSection].Offset, header.Sections[VerticesSection].Count, mesh.Vertices);
+    mesh.Faces.clear();
+    mesh.Faces.reserve(faceCount);
+    for (uint64_t i = 0; i < faceCount; i++) {
+        mesh.Faces.emplace_back(faceIndices + faceOffsets[i], faceIndices + faceOffsets[i + 1]);
+    }
+
+    const double* uvs = reinterpret_cast<const double*>(file.Data() + header.Sections[UVsSection].Offset);
+    mesh.UVs.clear();
+    mesh.UVs.reserve(header.Sections[UVsSection].Count);
+    for (uint64_t i = 0; i < header.Sections[UVsSection].Count; i++) {
+        mesh.UVs.emplace_back(uvs[2 * i], uvs[2 * i + 1]);
+    }
+    readIndices(file.Data() + header.Sections[UVIndicesSection].Offset, header.Sections[UVIndicesSection].Count, mesh.UVIndices);
+    readXYZs(file.Data() + header.Sections[NormalsSection].Offset, header.Sections[NormalsSection].Count, mesh.Normals);
+    readIndices(file.Data() + header.Sections[NormalIndicesSection].Offset, header.Sections[NormalIndicesSection].Count, mesh.NormalIndices);
+
+    // A checksum only catches accidental damage, indices still have to stay inside their arrays.
+    if (!LNMeshReorder::Validate(mesh)) {
+        mesh = LNLib::LN_Mesh();
+        return false;
+    }
+    return true;
+}
+
+bool LNLibEx::LNMesh::ToCompressedFile(const LNLib::LN_Mesh& mesh, const std::string& filePath, int positionBits)
+{
+    std::vector<unsigned char> data;
+    if (!LNMeshCodec::Encode(mesh, data, positionBits)) {
+        return false;
+    }
 
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
     if (!file.is_open()) {
         return false;
     }
-    bool binary = isBinarySTL(file);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
 
-    if (binary) {
-        return readBinarySTL(file, mesh);
+bool LNLibEx::LNMesh::FromCompressedFile(const std::string& filePath, LNLib::LN_Mesh& mesh)
+{
+    LNMappedFile file;
+    if (!file.Open(filePath)) {
+        return false;
     }
-    else {
-        file.seekg(0, std::ios::beg);
-        file.close();
-        file.open(filePath);
-        return readASCIISTL(file, mesh);
+    return LNMeshCodec::Decode(file.Data(), file.Size(), mesh);
+}
+#pragma endregion
+
+#pragma region Normals
+bool LNLibEx::LNMesh::ComputeVertexNormals(LNLib::LN_Mesh& mesh, NormalWeighting weighting, double creaseAngle)
+{
+    LNNormalGenerator generator(mesh, weighting, creaseAngle);
+    return generator.Process();
+}
+#pragma endregion
+
+#pragma region Simplify
+bool LNLibEx::LNMesh::Simplify(const LNLib::LN_Mesh& mesh, int targetFaceCount, LNLib::LN_Mesh& result, std::vector<int>& vertexMap, double maxError)
+{
+    LNMeshSimplifier simplifier(mesh, targetFaceCount, maxError);
+    return simplifier.Process(result, vertexMap);
+}
+#pragma endregion
+
+
+#pragma region Reorder
+bool LNLibEx::LNMesh::OptimizeVertexCache(LNLib::LN_Mesh& mesh, int cacheSize)
+{
+    LNVertexCacheOptimizer optimizer(mesh, cacheSize);
+    return optimizer.Process();
+}
+
+bool LNLibEx::LNMesh::SortSpatially(LNLib::LN_Mesh& mesh, SpaceFillingCurve curve)
+{
+    LNSpatialSorter sorter(mesh, curve);
+    return sorter.Process();
+}
+#pragma endregion
+
+#pragma region Repair
+bool LNLibEx::LNMesh::Repair(LNLib::LN_Mesh& mesh, LNMeshRepairReport& report, double areaTolerance)
+{
+    LNMeshRepairer repairer(mesh, areaTolerance, report);
+    return repairer.Process();
+}
+
+bool LNLibEx::LNMesh::GetComponents(const LNLib::LN_Mesh& mesh, std::vector<int>& faceOrder, std::vector<int>& componentOffsets, bool weldCoincident)
+{
+    LNMeshComponents splitter(mesh, weldCoincident);
+    return splitter.Process(faceOrder, componentOffsets);
+}
+
+bool LNLibEx::LNMesh::SplitComponents(const LNLib::LN_Mesh& mesh, std::vector<LNLib::LN_Mesh>& components, bool weldCoincident)
+{
+    components.clear();
+    std::vector<int> faceOrder;
+    std::vector<int> componentOffsets;
+    LNMeshComponents splitter(mesh, weldCoincident);
+    if (!splitter.Process(faceOrder, componentOffsets)) {
+        return false;
     }
-	return false;
+    splitter.Extract(faceOrder, componentOffsets, components);
+    return true;
 }
 #pragma endregion
 
+
+#pragma region MassProperties
+namespace
+{
+    const size_t STLBatchTriangles = 65536;
+
+    bool computeBinarySTLMassProperties(const LNLibEx::LNMappedFile& file, LNLibEx::LNMassProperties& properties) {
+        const unsigned char* data = file.Data();
+        uint32_t facetCount = 0;
+        std::memcpy(&facetCount, data + 80, sizeof(facetCount));
+
+        auto readVertex = [data](int64_t facet, int corner) {
+            float values[3];
+            std::memcpy(values, data + 84 + 50 * facet + 12 + 12 * corner, sizeof(values));
+            return LNLib::XYZ(values[0], values[1], values[2]);
+        };
+        LNLibEx::LNMassAccumulator accumulator(facetCount > 0 ? readVertex(0, 0) : LNLib::XYZ(0, 0, 0));
+        accumulator.AddParallel(facetCount, [&](int64_t i, LNLibEx::LNMassAccumulator& partial) {
+            partial.AddTriangle(readVertex(i, 0), readVertex(i, 1), readVertex(i, 2));
+        });
+        accumulator.GetProperties(properties);
+        return true;
+    }
+
+    bool computeASCIISTLMassProperties(std::ifstream& file, LNLibEx::LNMassProperties& properties) {
+        LNLibEx::LNMassAccumulator accumulator;
+        bool hasOrigin = false;
+        std::vector<LNLib::XYZ> batch;
+        batch.reserve(3 * STLBatchTriangles);
+        auto flush = [&]() {
+            if (batch.empty()) {
+                return;
+            }
+            if (!hasOrigin) {
+                accumulator = LNLibEx::LNMassAccumulator(batch[0]);
+                hasOrigin = true;
+            }
+            accumulator.AddParallel(static_cast<int64_t>(batch.size() / 3), [&](int64_t i, LNLibEx::LNMassAccumulator& partial) {
+                partial.AddTriangle(batch[3 * i], batch[3 * i + 1], batch[3 * i + 2]);
+            });
+            batch.clear();
+        };
+
+        std::string line;
+        std::vector<LNLib::XYZ> facet;
+        while (std::getline(file, line)) {
+            line = trim(line);
+            if (line.empty()) continue;
+
+            std::istringstream iss(line);
+            std::string keyword;
+            iss >> keyword;
+
+            if (startsWith(keyword, "vertex")) {
+                double x = 0, y = 0, z = 0;
+                iss >> x >> y >> z;
+                facet.emplace_back(x, y, z);
+            }
+            else if (startsWith(keyword, "endfacet") ||
+                        (startsWith(keyword, "end") && iss >> keyword && startsWith(keyword, "facet"))) {
+                for (size_t i = 1; i + 1 < facet.size(); i++) {
+                    batch.emplace_back(facet[0]);
+                    batch.emplace_back(facet[i]);
+                    batch.emplace_back(facet[i + 1]);
+                }
+                facet.clear();
+                if (batch.size() >= 3 * STLBatchTriangles) {
+                    flush();
+                }
+            }
+        }
+        flush();
+        accumulator.GetProperties(properties);
+        return true;
+    }
+}
+
+bool LNLibEx::LNMesh::ComputeMassProperties(const LNLib::LN_Mesh& mesh, LNMassProperties& properties)
+{
+    properties = LNMassProperties();
+    const int vertexCount = static_cast<int>(mesh.Vertices.size());
+    for (const auto& face : mesh.Faces) {
+        for (int index : face) {
+            if (index < 0 || index >= vertexCount) {
+                return false;
+            }
+        }
+    }
+
+    LNMassAccumulator accumulator(vertexCount > 0 ? mesh.Vertices[0] : LNLib::XYZ(0, 0, 0));
+    accumulator.AddParallel(static_cast<int64_t>(mesh.Faces.size()), [&](int64_t i, LNMassAccumulator& partial) {
+        const std::vector<int>& face = mesh.Faces[i];
+        for (size_t k = 1; k + 1 < face.size(); k++) {
+            partial.AddTriangle(mesh.Vertices[face[0]], mesh.Vertices[face[k]], mesh.Vertices[face[k + 1]]);
+        }
+    });
+    accumulator.GetProperties(properties);
+    return true;
+}
+
+bool LNLibEx::LNMesh::ComputeMassPropertiesFromSTLFile(const std::string& filePath, LNMassProperties& properties)
+{
+    properties = LNMassProperties();
+    LNMappedFile mapped;
+    if (!mapped.Open(filePath)) {
+        return false;
+    }
+    if (mapped.Size() >= 84) {
+        uint32_t facetCount = 0;
+        std::memcpy(&facetCount, mapped.Data() + 80, sizeof(facetCount));
+        if (mapped.Size() == 84 + static_cast<size_t>(facetCount) * 50) {
+            return computeBinarySTLMassProperties(mapped, properties);
+        }
+    }
+    mapped.Close();
+
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+    return computeASCIISTLMassProperties(file, properties);
+}
+#pragma endregion
\ No newline at end of file
@@ -0,0 +1,422 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshBVH.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "LNParallel.h"
+#include "LNBVHBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define LNMESH_BVH_SSE
+#endif
+
+namespace
+{
+    struct Ray
+    {
+        double Origin[3];
+        double Direction[3];
+        double Inverse[3];
+    };
+
+    Ray makeRay(const LNLib::XYZ& origin, const LNLib::XYZ& direction) {
+        Ray ray;
+        for (int i = 0; i < 3; i++) {
+            ray.Origin[i] = origin[i];
+            ray.Direction[i] = direction[i];
+            double component = std::fabs(direction[i]) < 1E-30 ? std::copysign(1E-30, direction[i]) : direction[i];
+            ray.Inverse[i] = 1.0 / component;
+        }
+        return ray;
+    }
+
+    bool intersectTriangle(const double* a, const double* e1, const double* e2, const Ray& ray, double maxT, double& t) {
+        const double* d = ray.Direction;
+        double p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+        double determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if (determinant == 0.0) {
+            return false;
+        }
+        double inverse = 1.0 / determinant;
+        double s[3] = { ray.Origin[0] - a[0], ray.Origin[1] - a[1], ray.Origin[2] - a[2] };
+        double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+        if (u < 0.0 || u > 1.0) {
+            return false;
+        }
+        double q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+        double v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse;
+        if (v < 0.0 || u + v > 1.0) {
+            return false;
+        }
+        double candidate = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+        if (candidate < 0.0 || candidate > maxT) {
+            return false;
+        }
+        t = candidate;
+        return true;
+    }
+
+    /// Real-Time Collision Detection, Christer Ericson, 5.1.5.
+    void closestPointOnTriangle(const double* a, const double* e1, const double* e2, const double* p, double* result) {
+        auto dot = [](const double* x, const double* y) { return x[0] * y[0] + x[1] * y[1] + x[2] * y[2]; };
+        auto set = [&](double s, double t) {
+            for (int i = 0; i < 3; i++) {
+                result[i] = a[i] + s * e1[i] + t * e2[i];
+            }
+        };
+
+        double ap[3] = { p[0] - a[0], p[1] - a[1], p[2] - a[2] };
+        double d1 = dot(e1, ap);
+        double d2 = dot(e2, ap);
+        if (d1 <= 0.0 && d2 <= 0.0) {
+            set(0.0, 0.0);
+            return;
+        }
+
+        double bp[3] = { ap[0] - e1[0], ap[1] - e1[1], ap[2] - e1[2] };
+        double d3 = dot(e1, bp);
+        double d4 = dot(e2, bp);
+        if (d3 >= 0.0 && d4 <= d3) {
+            set(1.0, 0.0);
+            return;
+        }
+
+        double vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+            set(d1 / (d1 - d3), 0.0);
+            return;
+        }
+
+        double cp[3] = { ap[0] - e2[0], ap[1] - e2[1], ap[2] - e2[2] };
+        double d5 = dot(e1, cp);
+        double d6 = dot(e2, cp);
+        if (d6 >= 0.0 && d5 <= d6) {
+            set(0.0, 1.0);
+            return;
+        }
+
+        double vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+            set(0.0, d2 / (d2 - d6));
+            return;
+        }
+
+        double va = d3 * d6 - d5 * d4;
+        if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+            double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            set(1.0 - w, w);
+            return;
+        }
+
+        double denominator = 1.0 / (va + vb + vc);
+        set(vb * denominator, vc * denominator);
+    }
+}
+
+bool LNLibEx::LNMeshBVH::Build(const LNLib::LN_Mesh& mesh, int maxLeafSize)
+{
+    _nodes.clear();
+    _triangles.clear();
+
+    const int vertexCount = static_cast<int>(mesh.Vertices.size());
+    const int faceCount = static_cast<int>(mesh.Faces.size());
+    std::vector<int> triangleOffsets(faceCount + 1, 0);
+    for (int i = 0; i < faceCount; i++) {
+        const std::vector<int>& face = mesh.Faces[i];
+        if (face.size() < 3) {
+            return false;
+        }
+        for (int index : face) {
+            if (index < 0 || index >= vertexCount) {
+                return false;
+            }
+        }
+        triangleOffsets[i + 1] = triangleOffsets[i] + static_cast<int>(face.size()) - 2;
+    }
+
+    const int triangleCount = triangleOffsets[faceCount];
+    if (triangleCount == 0) {
+        return true;
+    }
+
+    std::vector<Triangle> triangles(triangleCount);
+    std::vector<LNBVHBuilder::Primitive> primitives(triangleCount);
+    LNParallel::For(0, faceCount, [&](int64_t i) {
+        const std::vector<int>& face = mesh.Faces[i];
+        const LNLib::XYZ& a = mesh.Vertices[face[0]];
+        for (size_t k = 1; k + 1 < face.size(); k++) {
+            const LNLib::XYZ& b = mesh.Vertices[face[k]];
+            const LNLib::XYZ& c = mesh.Vertices[face[k + 1]];
+            int index = triangleOffsets[i] + static_cast<int>(k) - 1;
+
+            Triangle& triangle = triangles[index];
+            LNBVHBuilder::Primitive& primitive = primitives[index];
+            for (int j = 0; j < 3; j++) {
+                triangle.Vertex[j] = a[j];
+                triangle.Edge1[j] = b[j] - a[j];
+                triangle.Edge2[j] = c[j] - a[j];
+                primitive.Box.Min[j] = std::min({ a[j], b[j], c[j] });
+                primitive.Box.Max[j] = std::max({ a[j], b[j], c[j] });
+                primitive.Centroid[j] = (a[j] + b[j] + c[j]) / 3.0;
+            }
+            triangle.Face = static_cast<int>(i);
+        }
+    }, 2048);
+
+    std::vector<int> indices(triangleCount);
+    for (int i = 0; i < triangleCount; i++) {
+        indices[i] = i;
+    }
+
+    LNBVHBuilder::Builder<Node> builder(primitives, indices, maxLeafSize, LNBVHBuilder::GetParallelDepth());
+    _nodes.reserve(2 * triangleCount / std::max(1, maxLeafSize) + 1);
+    builder.Build(0, triangleCount, 0, _nodes);
+
+    _triangles.resize(triangleCount);
+    LNParallel::For(0, triangleCount, [&](int64_t i) {
+        _triangles[i] = triangles[indices[i]];
+    }, 8192);
+    return true;
+}
+
+bool LNLibEx::LNMeshBVH::IsEmpty() const
+{
+    return _nodes.empty();
+}
+
+int LNLibEx::LNMeshBVH::GetNodeCount() const
+{
+    return static_cast<int>(_nodes.size());
+}
+
+namespace
+{
+    /// Slab test in double on the exact origin, float boxes widen to double without rounding.
+    template <typename NodeType>
+    inline bool intersectBox(const NodeType& node, const Ray& ray, double maxT, double& nearT) {
+#if defined(LNMESH_BVH_SSE)
+        // Axes 0 and 1 share a register, axis 2 runs in the low lane of another.
+        __m128d origin = _mm_loadu_pd(ray.Origin);
+        __m128d inverse = _mm_loadu_pd(ray.Inverse);
+        __m128d t0 = _mm_mul_pd(_mm_sub_pd(_mm_set_pd(node.Min[1], node.Min[0]), origin), inverse);
+        __m128d t1 = _mm_mul_pd(_mm_sub_pd(_mm_set_pd(node.Max[1], node.Max[0]), origin), inverse);
+        __m128d tNear = _mm_min_pd(t0, t1);
+        __m128d tFar = _mm_max_pd(t0, t1);
+
+        __m128d origin2 = _mm_load_sd(ray.Origin + 2);
+        __m128d inverse2 = _mm_load_sd(ray.Inverse + 2);
+        __m128d t2 = _mm_mul_sd(_mm_sub_sd(_mm_set_sd(node.Min[2]), origin2), inverse2);
+        __m128d t3 = _mm_mul_sd(_mm_sub_sd(_mm_set_sd(node.Max[2]), origin2), inverse2);
+
+        __m128d entry = _mm_max_sd(_mm_max_sd(tNear, _mm_unpackhi_pd(tNear, tNear)), _mm_min_sd(t2, t3));
+        __m128d exit = _mm_min_sd(_mm_min_sd(tFar, _mm_unpackhi_pd(tFar, tFar)), _mm_max_sd(t2, t3));
+        double entryT = std::max(_mm_cvtsd_f64(entry), 0.0);
+        double exitT = std::min(_mm_cvtsd_f64(exit), maxT);
+#else
+        double entryT = 0.0;
+        double exitT = maxT;
+        for (int i = 0; i < 3; i++) {
+            double t0 = (node.Min[i] - ray.Origin[i]) * ray.Inverse[i];
+            double t1 = (node.Max[i] - ray.Origin[i]) * ray.Inverse[i];
+            entryT = std::max(entryT, std::min(t0, t1));
+            exitT = std::min(exitT, std::max(t0, t1));
+        }
+#endif
+        nearT = entryT;
+        return entryT <= exitT * LNLibEx::LNBVHBuilder::ExitScale;
+    }
+
+    template <typename NodeType>
+    inline double boxSquaredDistance(const NodeType& node, const double* point) {
+        double result = 0.0;
+        for (int i = 0; i < 3; i++) {
+            double d = std::max({ static_cast<double>(node.Min[i]) - point[i], 0.0, point[i] - static_cast<double>(node.Max[i]) });
+            result += d * d;
+        }
+        return result;
+    }
+
+    template <typename NodeType, typename TriangleType>
+    bool intersectTree(const std::vector<NodeType>& nodes, const std::vector<TriangleType>& triangles,
+                       const LNLib::XYZ& origin, const LNLib::XYZ& direction, double maxDistance,
+                       std::vector<int>& stack, LNLibEx::LNMeshHit& hit) {
+        hit.Face = -1;
+        if (nodes.empty()) {
+            return false;
+        }
+
+        Ray ray = makeRay(origin, direction);
+        double bestT = maxDistance;
+        int bestTriangle = -1;
+        double nearT;
+
+        stack.clear();
+        if (intersectBox(nodes[0], ray, bestT, nearT)) {
+            stack.emplace_back(0);
+        }
+        while (!stack.empty()) {
+            int index = stack.back();
+            stack.pop_back();
+            const NodeType& node = nodes[index];
+            if (node.Count > 0) {
+                for (uint32_t i = node.Offset; i < node.Offset + node.Count; i++) {
+                    const TriangleType& triangle = triangles[i];
+                    double t;
+                    if (intersectTriangle(triangle.Vertex, triangle.Edge1, triangle.Edge2, ray, bestT, t)) {
+                        bestT = t;
+                        bestTriangle = static_cast<int>(i);
+                    }
+                }
+                continue;
+            }
+
+            int left = index + 1;
+            int right = index + static_cast<int>(node.Offset);
+            double leftT, rightT;
+            bool hitLeft = intersectBox(nodes[left], ray, bestT, leftT);
+            bool hitRight = intersectBox(nodes[right], ray, bestT, rightT);
+            if (hitLeft && hitRight) {
+                if (leftT < rightT) {
+                    stack.emplace_back(right);
+                    stack.emplace_back(left);
+                }
+                else {
+                    stack.emplace_back(left);
+                    stack.emplace_back(right);
+                }
+            }
+            else if (hitLeft) {
+                stack.emplace_back(left);
+            }
+            else if (hitRight) {
+                stack.emplace_back(right);
+            }
+        }
+
+        if (bestTriangle < 0) {
+            return false;
+        }
+        hit.Face = triangles[bestTriangle].Face;
+        hit.Distance = bestT;
+        hit.Point = origin + direction * bestT;
+        return true;
+    }
+
+    template <typename NodeType, typename TriangleType>
+    bool closestInTree(const std::vector<NodeType>& nodes, const std::vector<TriangleType>& triangles,
+                       const LNLib::XYZ& point, double maxDistance,
+                       std::vector<int>& stack, LNLibEx::LNMeshHit& hit) {
+        hit.Face = -1;
+        if (nodes.empty()) {
+            return false;
+        }
+
+        const double query[3] = { point[0], point[1], point[2] };
+        double bestSquared = maxDistance * maxDistance;
+        double bestPoint[3] = { 0, 0, 0 };
+        int bestTriangle = -1;
+
+        stack.clear();
+        if (boxSquaredDistance(nodes[0], query) <= bestSquared) {
+            stack.emplace_back(0);
+        }
+        while (!stack.empty()) {
+            int index = stack.back();
+            stack.pop_back();
+            const NodeType& node = nodes[index];
+            if (boxSquaredDistance(node, query) > bestSquared) {
+                continue;
+            }
+            if (node.Count > 0) {
+                for (uint32_t i = node.Offset; i < node.Offset + node.Count; i++) {
+                    const TriangleType& triangle = triangles[i];
+                    double candidate[3];
+                    closestPointOnTriangle(triangle.Vertex, triangle.Edge1, triangle.Edge2, query, candidate);
+                    double dx = candidate[0] - query[0];
+                    double dy = candidate[1] - query[1];
+                    double dz = candidate[2] - query[2];
+                    double squared = dx * dx + dy * dy + dz * dz;
+                    if (squared <= bestSquared) {
+                        bestSquared = squared;
+                        std::copy(candidate, candidate + 3, bestPoint);
+                        bestTriangle = static_cast<int>(i);
+                    }
+                }
+                continue;
+            }
+
+            int left = index + 1;
+            int right = index + static_cast<int>(node.Offset);
+            double leftDistance = boxSquaredDistance(nodes[left], query);
+            double rightDistance = boxSquaredDistance(nodes[right], query);
+            if (leftDistance < rightDistance) {
+                if (rightDistance <= bestSquared) stack.emplace_back(right);
+                if (leftDistance <= bestSquared) stack.emplace_back(left);
+            }
+            else {
+                if (leftDistance <= bestSquared) stack.emplace_back(left);
+                if (rightDistance <= bestSquared) stack.emplace_back(right);
+            }
+        }
+
+        if (bestTriangle < 0) {
+            return false;
+        }
+        hit.Face = triangles[bestTriangle].Face;
+        hit.Distance = std::sqrt(bestSquared);
+        hit.Point = LNLib::XYZ(bestPoint[0], bestPoint[1], bestPoint[2]);
+        return true;
+    }
+}
+
+bool LNLibEx::LNMeshBVH::Intersect(const LNLib::XYZ& origin, const LNLib::XYZ& direction, LNMeshHit& hit, double maxDistance) const
+{
+    std::vector<int> stack;
+    stack.reserve(64);
+    return intersectTree(_nodes, _triangles, origin, direction, maxDistance, stack, hit);
+}
+
+void LNLibEx::LNMeshBVH::Intersect(const std::vector<LNLib::XYZ>& origins, const std::vector<LNLib::XYZ>& directions, std::vector<LNMeshHit>& hits, double maxDistance) const
+{
+    const int64_t count = static_cast<int64_t>(std::min(origins.size(), directions.size()));
+    hits.assign(count, LNMeshHit());
+    LNParallel::ForEachChunk(0, count, 256, [&](int, int64_t begin, int64_t end) {
+        std::vector<int> stack;
+        stack.reserve(64);
+        for (int64_t i = begin; i < end; i++) {
+            intersectTree(_nodes, _triangles, origins[i], directions[i], maxDistance, stack, hits[i]);
+        }
+    });
+}
+
+bool LNLibEx::LNMeshBVH::GetClosestPoint(const LNLib::XYZ& point, LNMeshHit& hit, double maxDistance) const
+{
+    std::vector<int> stack;
+    stack.reserve(64);
+    return closestInTree(_nodes, _triangles, point, maxDistance, stack, hit);
+}
+
+void LNLibEx::LNMeshBVH::GetClosestPoints(const std::vector<LNLib::XYZ>& points, std::vector<LNMeshHit>& hits, double maxDistance) const
+{
+    const int64_t count = static_cast<int64_t>(points.size());
+    hits.assign(count, LNMeshHit());
+    LNParallel::ForEachChunk(0, count, 256, [&](int, int64_t begin, int64_t end) {
+        std::vector<int> stack;
+        stack.reserve(64);
+        for (int64_t i = begin; i < end; i++) {
+            closestInTree(_nodes, _triangles, points[i], maxDistance, stack, hits[i]);
+        }
+    });
+}
@@ -0,0 +1,490 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshCodec.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "UV.h"
+#include "LNBinaryUtils.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    const char CodecMagic[4] = { 'L', 'N', 'M', 'C' };
+    const uint32_t CodecVersion = 1;
+    const uint32_t AllTrianglesFlag = 1;
+    // Per-corner attribute indices equal to the face indices are not stored again.
+    const uint32_t SharedUVIndicesFlag = 2;
+    const uint32_t SharedNormalIndicesFlag = 4;
+    const int BlockSize = 4096;
+
+    enum CodecSection
+    {
+        PositionsStream = 0,
+        UVsStream,
+        NormalsStream,
+        FaceSizesStream,
+        FaceIndicesStream,
+        UVIndicesStream,
+        NormalIndicesStream,
+        CodecSectionCount
+    };
+
+    struct CodecHeader
+    {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t Flags;
+        uint8_t PositionBits;
+        uint8_t UVBits;
+        uint16_t Reserved0;
+        uint32_t VertexCount;
+        uint32_t FaceCount;
+        uint32_t CornerCount;
+        uint32_t UVCount;
+        uint32_t UVIndexCount;
+        uint32_t NormalCount;
+        uint32_t NormalIndexCount;
+        uint32_t Reserved1;
+        double PositionMin[3];
+        double PositionExtent[3];
+        double UVMin[2];
+        double UVExtent[2];
+        uint64_t Sections[CodecSectionCount][2];
+        uint64_t Checksum;
+    };
+
+    uint16_t quantize(double value, double minimum, double extent, uint32_t maximum) {
+        if (extent <= 0.0) {
+            return 0;
+        }
+        double q = std::round((value - minimum) / extent * maximum);
+        return static_cast<uint16_t>(std::min(std::max(q, 0.0), static_cast<double>(maximum)));
+    }
+
+    int16_t toSnorm(double value) {
+        return static_cast<int16_t>(std::round(std::min(std::max(value, -1.0), 1.0) * 32767.0));
+    }
+
+    void encodeOctahedral(const LNLib::XYZ& normal, int16_t* result) {
+        double x = normal.GetX();
+        double y = normal.GetY();
+        double z = normal.GetZ();
+        double sum = std::fabs(x) + std::fabs(y) + std::fabs(z);
+        if (sum <= 0.0) {
+            result[0] = 0;
+            result[1] = 0;
+            return;
+        }
+        x /= sum;
+        y /= sum;
+        if (z < 0.0) {
+            double ox = (1.0 - std::fabs(y)) * (x >= 0.0 ? 1.0 : -1.0);
+            double oy = (1.0 - std::fabs(x)) * (y >= 0.0 ? 1.0 : -1.0);
+            x = ox;
+            y = oy;
+        }
+        result[0] = toSnorm(x);
+        result[1] = toSnorm(y);
+    }
+
+    LNLib::XYZ decodeOctahedral(const int16_t* value) {
+        double x = std::max(value[0] / 32767.0, -1.0);
+        double y = std::max(value[1] / 32767.0, -1.0);
+        double z = 1.0 - std::fabs(x) - std::fabs(y);
+        double t = std::max(-z, 0.0);
+        x += x >= 0.0 ? -t : t;
+        y += y >= 0.0 ? -t : t;
+        double length = std::sqrt(x * x + y * y + z * z);
+        return LNLib::XYZ(x / length, y / length, z / length);
+    }
+
+    void writeVarint(uint32_t value, std::vector<unsigned char>& out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool readVarint(const unsigned char*& cursor, const unsigned char* end, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (cursor == end) {
+                return false;
+            }
+            unsigned char byte = *cursor++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Block stream: uint32 block count, uint32 block byte offsets (count + 1), then the blocks.
+    // Inside a block every value is the zigzag varint of its difference to one past the largest value so far,
+    // so indices renumbered by first use mostly code as 0 for a new vertex or a small number for a recent one.
+    void writeBlockStream(const int* values, size_t count, std::vector<unsigned char>& out) {
+        const int blockCount = static_cast<int>((count + BlockSize - 1) / BlockSize);
+        std::vector<std::vector<unsigned char>> blocks(blockCount);
+        LNLibEx::LNParallel::For(0, blockCount, [&](int64_t block) {
+            size_t begin = block * static_cast<size_t>(BlockSize);
+            size_t end = std::min(count, begin + BlockSize);
+            std::vector<unsigned char>& bytes = blocks[block];
+            bytes.reserve(2 * (end - begin));
+            int64_t highest = -1;
+            for (size_t i = begin; i < end; i++) {
+                uint32_t predicted = static_cast<uint32_t>(highest + 1);
+                int32_t delta = static_cast<int32_t>(predicted - static_cast<uint32_t>(values[i]));
+                writeVarint((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31), bytes);
+                highest = std::max<int64_t>(highest, values[i]);
+            }
+        }, 1);
+
+        std::vector<uint32_t> table(blockCount + 2);
+        table[0] = static_cast<uint32_t>(blockCount);
+        for (int i = 0; i < blockCount; i++) {
+            table[i + 2] = table[i + 1] + static_cast<uint32_t>(blocks[i].size());
+        }
+        size_t start = out.size();
+        out.resize(start + table.size() * sizeof(uint32_t));
+        std::memcpy(out.data() + start, table.data(), table.size() * sizeof(uint32_t));
+        for (const auto& bytes : blocks) {
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+    }
+
+    /// Every value of a block stream takes at least one byte, so counts larger than the section are corrupt.
+    /// Checked before any allocation, as the header is not covered by the checksum.
+    bool canHold(const CodecHeader& header, int section, uint32_t count) {
+        return count <= header.Sections[section][1];
+    }
+
+    bool readBlockStream(const unsigned char* data, uint64_t size, size_t count, int* values) {
+        uint32_t blockCount = 0;
+        if (size < sizeof(uint32_t)) {
+            return count == 0 && size == 0;
+        }
+        std::memcpy(&blockCount, data, sizeof(uint32_t));
+        if (blockCount != (count + BlockSize - 1) / BlockSize || (blockCount + 2ull) * sizeof(uint32_t) > size) {
+            return false;
+        }
+        std::vector<uint32_t> offsets(blockCount + 1);
+        std::memcpy(offsets.data(), data + sizeof(uint32_t), offsets.size() * sizeof(uint32_t));
+        const unsigned char* blockData = data + (blockCount + 2ull) * sizeof(uint32_t);
+        const uint64_t blockDataSize = size - (blockCount + 2ull) * sizeof(uint32_t);
+        if (offsets[0] != 0 || offsets[blockCount] != blockDataSize) {
+            return false;
+        }
+        for (uint32_t i = 0; i < blockCount; i++) {
+            if (offsets[i] > offsets[i + 1]) {
+                return false;
+            }
+        }
+
+        std::atomic<bool> isValid(true);
+        LNLibEx::LNParallel::For(0, blockCount, [&](int64_t block) {
+            const unsigned char* cursor = blockData + offsets[block];
+            const unsigned char* end = blockData + offsets[block + 1];
+            size_t begin = block * static_cast<size_t>(BlockSize);
+            size_t last = std::min(count, begin + BlockSize);
+            int64_t highest = -1;
+            for (size_t i = begin; i < last; i++) {
+                uint32_t zigzag;
+                if (!readVarint(cursor, end, zigzag)) {
+                    isValid = false;
+                    return;
+                }
+                uint32_t predicted = static_cast<uint32_t>(highest + 1);
+                values[i] = static_cast<int>(predicted - ((zigzag >> 1) ^ (0u - (zigzag & 1))));
+                highest = std::max<int64_t>(highest, values[i]);
+            }
+            if (cursor != end) {
+                isValid = false;
+            }
+        }, 1);
+        return isValid;
+    }
+
+    bool isInRange(const int* values, size_t count, uint32_t limit) {
+        std::atomic<bool> isValid(true);
+        LNLibEx::LNParallel::ForEachChunk(0, static_cast<int64_t>(count), 1 << 16, [&](int, int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; i++) {
+                if (values[i] < 0 || static_cast<uint32_t>(values[i]) >= limit) {
+                    isValid = false;
+                    return;
+                }
+            }
+        });
+        return isValid;
+    }
+}
+
+bool LNLibEx::LNMeshCodec::Encode(const LNLib::LN_Mesh& mesh, std::vector<unsigned char>& data, int positionBits, int uvBits)
+{
+    if (!LNBinaryUtils::IsLittleEndian() || positionBits < 1 || positionBits > 16 || uvBits < 1 || uvBits > 16) {
+        return false;
+    }
+
+    std::vector<int> faceSizes;
+    std::vector<int> faceIndices;
+    faceSizes.reserve(mesh.Faces.size());
+    bool isAllTriangles = true;
+    for (const auto& face : mesh.Faces) {
+        faceSizes.push_back(static_cast<int>(face.size()));
+        faceIndices.insert(faceIndices.end(), face.begin(), face.end());
+        isAllTriangles = isAllTriangles && face.size() == 3;
+    }
+    const uint64_t limit = std::numeric_limits<uint32_t>::max();
+    if (mesh.Vertices.size() > limit || mesh.Faces.size() > limit || faceIndices.size() > limit ||
+        mesh.UVs.size() > limit || mesh.Normals.size() > limit ||
+        !isInRange(faceIndices.data(), faceIndices.size(), static_cast<uint32_t>(mesh.Vertices.size())) ||
+        !isInRange(mesh.UVIndices.data(), mesh.UVIndices.size(), static_cast<uint32_t>(mesh.UVs.size())) ||
+        !isInRange(mesh.NormalIndices.data(), mesh.NormalIndices.size(), static_cast<uint32_t>(mesh.Normals.size()))) {
+        return false;
+    }
+
+    CodecHeader header = {};
+    std::memcpy(header.Magic, CodecMagic, sizeof(CodecMagic));
+    header.Version = CodecVersion;
+    header.Flags = isAllTriangles ? AllTrianglesFlag : 0;
+    const bool isSharedUVIndices = !mesh.UVIndices.empty() && mesh.UVIndices == faceIndices;
+    const bool isSharedNormalIndices = !mesh.NormalIndices.empty() && mesh.NormalIndices == faceIndices;
+    header.Flags |= isSharedUVIndices ? SharedUVIndicesFlag : 0;
+    header.Flags |= isSharedNormalIndices ? SharedNormalIndicesFlag : 0;
+    header.PositionBits = static_cast<uint8_t>(positionBits);
+    header.UVBits = static_cast<uint8_t>(uvBits);
+    header.VertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+    header.FaceCount = static_cast<uint32_t>(mesh.Faces.size());
+    header.CornerCount = static_cast<uint32_t>(faceIndices.size());
+    header.UVCount = static_cast<uint32_t>(mesh.UVs.size());
+    header.UVIndexCount = static_cast<uint32_t>(mesh.UVIndices.size());
+    header.NormalCount = static_cast<uint32_t>(mesh.Normals.size());
+    header.NormalIndexCount = static_cast<uint32_t>(mesh.NormalIndices.size());
+
+    double positionMax[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < mesh.Vertices.size(); i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            double value = mesh.Vertices[i][axis];
+            if (!std::isfinite(value)) {
+                return false;
+            }
+            header.PositionMin[axis] = i == 0 ? value : std::min(header.PositionMin[axis], value);
+            positionMax[axis] = i == 0 ? value : std::max(positionMax[axis], value);
+        }
+    }
+    double uvMax[2] = { 0.0, 0.0 };
+    for (size_t i = 0; i < mesh.UVs.size(); i++) {
+        for (int axis = 0; axis < 2; axis++) {
+            double value = mesh.UVs[i][axis];
+            if (!std::isfinite(value)) {
+                return false;
+            }
+            header.UVMin[axis] = i == 0 ? value : std::min(header.UVMin[axis], value);
+            uvMax[axis] = i == 0 ? value : std::max(uvMax[axis], value);
+        }
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        header.PositionExtent[axis] = positionMax[axis] - header.PositionMin[axis];
+    }
+    for (int axis = 0; axis < 2; axis++) {
+        header.UVExtent[axis] = uvMax[axis] - header.UVMin[axis];
+    }
+
+    data.assign(sizeof(CodecHeader), 0);
+    auto beginSection = [&](int section) {
+        data.resize(LNBinaryUtils::AlignUp(data.size(), 8), 0);
+        header.Sections[section][0] = data.size();
+    };
+    auto endSection = [&](int section) {
+        header.Sections[section][1] = data.size() - header.Sections[section][0];
+    };
+
+    const uint32_t positionMaximum = (1u << positionBits) - 1;
+    const size_t vertexCount = mesh.Vertices.size();
+    beginSection(PositionsStream);
+    data.resize(data.size() + 3 * vertexCount * sizeof(uint16_t));
+    uint16_t* positions = reinterpret_cast<uint16_t*>(data.data() + header.Sections[PositionsStream][0]);
+    LNParallel::For(0, static_cast<int64_t>(vertexCount), [&](int64_t i) {
+        for (int axis = 0; axis < 3; axis++) {
+            positions[axis * vertexCount + i] = quantize(mesh.Vertices[i][axis], header.PositionMin[axis], header.PositionExtent[axis], positionMaximum);
+        }
+    }, 1 << 14);
+    endSection(PositionsStream);
+
+    const uint32_t uvMaximum = (1u << uvBits) - 1;
+    const size_t uvCount = mesh.UVs.size();
+    beginSection(UVsStream);
+    data.resize(data.size() + 2 * uvCount * sizeof(uint16_t));
+    uint16_t* uvs = reinterpret_cast<uint16_t*>(data.data() + header.Sections[UVsStream][0]);
+    for (size_t i = 0; i < uvCount; i++) {
+        for (int axis = 0; axis < 2; axis++) {
+            uvs[axis * uvCount + i] = quantize(mesh.UVs[i][axis], header.UVMin[axis], header.UVExtent[axis], uvMaximum);
+        }
+    }
+    endSection(UVsStream);
+
+    beginSection(NormalsStream);
+    data.resize(data.size() + 2 * mesh.Normals.size() * sizeof(int16_t));
+    int16_t* normals = reinterpret_cast<int16_t*>(data.data() + header.Sections[NormalsStream][0]);
+    LNParallel::For(0, static_cast<int64_t>(mesh.Normals.size()), [&](int64_t i) {
+        encodeOctahedral(mesh.Normals[i], normals + 2 * i);
+    }, 1 << 14);
+    endSection(NormalsStream);
+
+    beginSection(FaceSizesStream);
+    if (!isAllTriangles) {
+        writeBlockStream(faceSizes.data(), faceSizes.size(), data);
+    }
+    endSection(FaceSizesStream);
+
+    beginSection(FaceIndicesStream);
+    writeBlockStream(faceIndices.data(), faceIndices.size(), data);
+    endSection(FaceIndicesStream);
+
+    beginSection(UVIndicesStream);
+    if (!isSharedUVIndices) {
+        writeBlockStream(mesh.UVIndices.data(), mesh.UVIndices.size(), data);
+    }
+    endSection(UVIndicesStream);
+
+    beginSection(NormalIndicesStream);
+    if (!isSharedNormalIndices) {
+        writeBlockStream(mesh.NormalIndices.data(), mesh.NormalIndices.size(), data);
+    }
+    endSection(NormalIndicesStream);
+
+    header.Checksum = LNBinaryUtils::Checksum64(data.data() + sizeof(CodecHeader), data.size() - sizeof(CodecHeader));
+    std::memcpy(data.data(), &header, sizeof(CodecHeader));
+    return true;
+}
+
+bool LNLibEx::LNMeshCodec::Decode(const unsigned char* data, size_t size, LNLib::LN_Mesh& mesh)
+{
+    if (!LNBinaryUtils::IsLittleEndian() || data == nullptr || size < sizeof(CodecHeader)) {
+        return false;
+    }
+
+    CodecHeader header;
+    std::memcpy(&header, data, sizeof(CodecHeader));
+    if (std::memcmp(header.Magic, CodecMagic, sizeof(CodecMagic)) != 0 ||
+        header.Version != CodecVersion ||
+        header.PositionBits < 1 || header.PositionBits > 16 ||
+        header.UVBits < 1 || header.UVBits > 16) {
+        return false;
+    }
+    for (int i = 0; i < CodecSectionCount; i++) {
+        if (header.Sections[i][0] < sizeof(CodecHeader) || header.Sections[i][0] % 8 != 0 ||
+            header.Sections[i][0] > size || header.Sections[i][1] > size - header.Sections[i][0]) {
+            return false;
+        }
+    }
+    const bool isAllTriangles = (header.Flags & AllTrianglesFlag) != 0;
+    const bool isSharedUVIndices = (header.Flags & SharedUVIndicesFlag) != 0;
+    const bool isSharedNormalIndices = (header.Flags & SharedNormalIndicesFlag) != 0;
+    if (header.Sections[PositionsStream][1] != 3ull * header.VertexCount * sizeof(uint16_t) ||
+        header.Sections[UVsStream][1] != 2ull * header.UVCount * sizeof(uint16_t) ||
+        header.Sections[NormalsStream][1] != 2ull * header.NormalCount * sizeof(int16_t) ||
+        (isAllTriangles && header.CornerCount != 3ull * header.FaceCount) ||
+        (isSharedUVIndices && header.UVIndexCount != header.CornerCount) ||
+        (isSharedNormalIndices && header.NormalIndexCount != header.CornerCount) ||
+        !canHold(header, FaceIndicesStream, header.CornerCount) ||
+        (!isAllTriangles && !canHold(header, FaceSizesStream, header.FaceCount)) ||
+        (!isSharedUVIndices && !canHold(header, UVIndicesStream, header.UVIndexCount)) ||
+        (!isSharedNormalIndices && !canHold(header, NormalIndicesStream, header.NormalIndexCount)) ||
+        LNBinaryUtils::Checksum64(data + sizeof(CodecHeader), size - sizeof(CodecHeader)) != header.Checksum) {
+        return false;
+    }
+
+    std::vector<int> faceSizes(header.FaceCount, 3);
+    std::vector<int> faceIndices(header.CornerCount);
+    std::vector<int> uvIndices(header.UVIndexCount);
+    std::vector<int> normalIndices(header.NormalIndexCount);
+    auto readStream = [&](int section, std::vector<int>& values) {
+        return readBlockStream(data + header.Sections[section][0], header.Sections[section][1], values.size(), values.data());
+    };
+    if ((!isAllTriangles && !readStream(FaceSizesStream, faceSizes)) ||
+        !readStream(FaceIndicesStream, faceIndices) ||
+        (!isSharedUVIndices && !readStream(UVIndicesStream, uvIndices)) ||
+        (!isSharedNormalIndices && !readStream(NormalIndicesStream, normalIndices))) {
+        return false;
+    }
+    if (isSharedUVIndices) {
+        uvIndices = faceIndices;
+    }
+    if (isSharedNormalIndices) {
+        normalIndices = faceIndices;
+    }
+    if (!isInRange(faceIndices.data(), faceIndices.size(), header.VertexCount) ||
+        !isInRange(uvIndices.data(), uvIndices.size(), header.UVCount) ||
+        !isInRange(normalIndices.data(), normalIndices.size(), header.NormalCount)) {
+        return false;
+    }
+    std::vector<uint32_t> faceOffsets(header.FaceCount + 1, 0);
+    for (uint32_t i = 0; i < header.FaceCount; i++) {
+        if (faceSizes[i] < 0) {
+            return false;
+        }
+        faceOffsets[i + 1] = faceOffsets[i] + static_cast<uint32_t>(faceSizes[i]);
+        if (faceOffsets[i + 1] > header.CornerCount) {
+            return false;
+        }
+    }
+    if (faceOffsets[header.FaceCount] != header.CornerCount) {
+        return false;
+    }
+
+    // Dequantization reads planar streams with a constant scale per axis, which the compiler vectorizes.
+    const size_t vertexCount = header.VertexCount;
+    const uint16_t* positions = reinterpret_cast<const uint16_t*>(data + header.Sections[PositionsStream][0]);
+    double positionScale[3];
+    for (int axis = 0; axis < 3; axis++) {
+        positionScale[axis] = header.PositionExtent[axis] / ((1u << header.PositionBits) - 1);
+    }
+    mesh.Vertices.resize(vertexCount);
+    LNParallel::ForEachChunk(0, static_cast<int64_t>(vertexCount), 1 << 14, [&](int, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+            mesh.Vertices[i] = LNLib::XYZ(header.PositionMin[0] + positions[i] * positionScale[0],
+                                          header.PositionMin[1] + positions[vertexCount + i] * positionScale[1],
+                                          header.PositionMin[2] + positions[2 * vertexCount + i] * positionScale[2]);
+        }
+    });
+
+    const size_t uvCount = header.UVCount;
+    const uint16_t* uvs = reinterpret_cast<const uint16_t*>(data + header.Sections[UVsStream][0]);
+    const double uScale = header.UVExtent[0] / ((1u << header.UVBits) - 1);
+    const double vScale = header.UVExtent[1] / ((1u << header.UVBits) - 1);
+    mesh.UVs.resize(uvCount);
+    for (size_t i = 0; i < uvCount; i++) {
+        mesh.UVs[i] = LNLib::UV(header.UVMin[0] + uvs[i] * uScale, header.UVMin[1] + uvs[uvCount + i] * vScale);
+    }
+
+    const int16_t* normals = reinterpret_cast<const int16_t*>(data + header.Sections[NormalsStream][0]);
+    mesh.Normals.resize(header.NormalCount);
+    LNParallel::For(0, header.NormalCount, [&](int64_t i) {
+        mesh.Normals[i] = decodeOctahedral(normals + 2 * i);
+    }, 1 << 14);
+
+    mesh.Faces.resize(header.FaceCount);
+    LNParallel::For(0, header.FaceCount, [&](int64_t i) {
+        mesh.Faces[i].assign(faceIndices.begin() + faceOffsets[i], faceIndices.begin() + faceOffsets[i + 1]);
+    }, 1 << 14);
+    mesh.UVIndices = std::move(uvIndices);
+    mesh.NormalIndices = std::move(normalIndices);
+    return true;
+}
@@ -0,0 +1,157 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshComponents.h"
+#include "LNMeshReorder.h"
+#include "LNUnionFind.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "UV.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+
+namespace
+{
+    bool isLess(const LNLib::XYZ& a, const LNLib::XYZ& b) {
+        if (a.GetX() != b.GetX()) return a.GetX() < b.GetX();
+        if (a.GetY() != b.GetY()) return a.GetY() < b.GetY();
+        return a.GetZ() < b.GetZ();
+    }
+
+    // Sorted unique copy of indices, then indices rewritten as positions in that list.
+    std::vector<int> compactIndices(std::vector<int>& indices) {
+        std::vector<int> used = indices;
+        std::sort(used.begin(), used.end());
+        used.erase(std::unique(used.begin(), used.end()), used.end());
+        for (int& index : indices) {
+            index = static_cast<int>(std::lower_bound(used.begin(), used.end(), index) - used.begin());
+        }
+        return used;
+    }
+}
+
+LNLibEx::LNMeshComponents::LNMeshComponents(const LNLib::LN_Mesh& mesh, bool weldCoincident):
+                                                _mesh(mesh), _weldCoincident(weldCoincident){}
+
+bool LNLibEx::LNMeshComponents::Process(std::vector<int>& faceOrder, std::vector<int>& componentOffsets)
+{
+    faceOrder.clear();
+    componentOffsets.assign(1, 0);
+    if (!LNMeshReorder::Validate(_mesh)) {
+        return false;
+    }
+
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+    LNUnionFind vertexSets(vertexCount);
+    if (_weldCoincident) {
+        // STL facets carry their own vertex copies, equal positions stand for a shared vertex.
+        std::vector<int> sorted(vertexCount);
+        for (int i = 0; i < vertexCount; i++) {
+            sorted[i] = i;
+        }
+        std::sort(sorted.begin(), sorted.end(), [&](int a, int b) {
+            return isLess(_mesh.Vertices[a], _mesh.Vertices[b]);
+        });
+        LNParallel::For(1, vertexCount, [&](int64_t i) {
+            const LNLib::XYZ& previous = _mesh.Vertices[sorted[i - 1]];
+            const LNLib::XYZ& current = _mesh.Vertices[sorted[i]];
+            if (!isLess(previous, current)) {
+                vertexSets.Unite(sorted[i - 1], sorted[i]);
+            }
+        }, 4096);
+    }
+    LNParallel::For(0, faceCount, [&](int64_t i) {
+        const std::vector<int>& face = _mesh.Faces[i];
+        for (size_t k = 1; k < face.size(); k++) {
+            vertexSets.Unite(face[0], face[k]);
+        }
+    }, 4096);
+
+    std::vector<int> vertexLabels;
+    const int setCount = vertexSets.GetLabels(vertexLabels);
+    std::vector<int> setComponents(setCount, -1);
+    std::vector<int> faceComponents(faceCount, -1);
+    int componentCount = 0;
+    for (int i = 0; i < faceCount; i++) {
+        if (_mesh.Faces[i].empty()) {
+            continue;
+        }
+        int& component = setComponents[vertexLabels[_mesh.Faces[i][0]]];
+        if (component < 0) {
+            component = componentCount++;
+            componentOffsets.emplace_back(0);
+        }
+        faceComponents[i] = component;
+        componentOffsets[component + 1]++;
+    }
+    for (int i = 0; i < componentCount; i++) {
+        componentOffsets[i + 1] += componentOffsets[i];
+    }
+
+    faceOrder.resize(componentOffsets.back());
+    std::vector<int> cursor(componentOffsets.begin(), componentOffsets.end() - 1);
+    for (int i = 0; i < faceCount; i++) {
+        if (faceComponents[i] >= 0) {
+            faceOrder[cursor[faceComponents[i]]++] = i;
+        }
+    }
+    return true;
+}
+
+void LNLibEx::LNMeshComponents::Extract(const std::vector<int>& faceOrder, const std::vector<int>& componentOffsets, std::vector<LNLib::LN_Mesh>& components) const
+{
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+    std::vector<int> cornerOffsets(faceCount + 1, 0);
+    for (int i = 0; i < faceCount; i++) {
+        cornerOffsets[i + 1] = cornerOffsets[i] + static_cast<int>(_mesh.Faces[i].size());
+    }
+
+    const int componentCount = static_cast<int>(componentOffsets.size()) - 1;
+    components.assign(componentCount, LNLib::LN_Mesh());
+    LNParallel::For(0, componentCount, [&](int64_t c) {
+        LNLib::LN_Mesh& component = components[c];
+        std::vector<int> vertexIndices;
+        std::vector<int> uvIndices;
+        std::vector<int> normalIndices;
+        std::vector<int> faceSizes;
+        for (int k = componentOffsets[c]; k < componentOffsets[c + 1]; k++) {
+            int face = faceOrder[k];
+            const std::vector<int>& vertices = _mesh.Faces[face];
+            vertexIndices.insert(vertexIndices.end(), vertices.begin(), vertices.end());
+            faceSizes.emplace_back(static_cast<int>(vertices.size()));
+            if (!_mesh.UVIndices.empty()) {
+                uvIndices.insert(uvIndices.end(), _mesh.UVIndices.begin() + cornerOffsets[face], _mesh.UVIndices.begin() + cornerOffsets[face + 1]);
+            }
+            if (!_mesh.NormalIndices.empty()) {
+                normalIndices.insert(normalIndices.end(), _mesh.NormalIndices.begin() + cornerOffsets[face], _mesh.NormalIndices.begin() + cornerOffsets[face + 1]);
+            }
+        }
+
+        for (int index : compactIndices(vertexIndices)) {
+            component.Vertices.emplace_back(_mesh.Vertices[index]);
+        }
+        for (int index : compactIndices(uvIndices)) {
+            component.UVs.emplace_back(_mesh.UVs[index]);
+        }
+        for (int index : compactIndices(normalIndices)) {
+            component.Normals.emplace_back(_mesh.Normals[index]);
+        }
+        component.Faces.reserve(faceSizes.size());
+        auto corner = vertexIndices.begin();
+        for (int size : faceSizes) {
+            component.Faces.emplace_back(corner, corner + size);
+            corner += size;
+        }
+        component.UVIndices = std::move(uvIndices);
+        component.NormalIndices = std::move(normalIndices);
+    }, 1);
+}
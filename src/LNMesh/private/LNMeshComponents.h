@@ -0,0 +1,42 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNObject.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Partition faces into connected components, faces are connected when they share a vertex.
+	/// Vertex sets are merged with a concurrent union-find so the faces are visited in parallel.
+	/// </summary>
+	class LNMeshComponents
+	{
+	private:
+
+		const LNLib::LN_Mesh& _mesh;
+		bool _weldCoincident;
+
+	public:
+
+		LNMeshComponents(const LNLib::LN_Mesh& mesh, bool weldCoincident);
+
+		/// <summary>
+		/// faceOrder lists faces grouped by component, component i holds faceOrder[componentOffsets[i]] to faceOrder[componentOffsets[i + 1]] exclusive.
+		/// Components are numbered in order of their first face and keep the input face order.
+		/// </summary>
+		bool Process(std::vector<int>& faceOrder, std::vector<int>& componentOffsets);
+
+		/// <summary>
+		/// Copy every component to its own mesh, keeping only the Vertices, UVs and Normals it references.
+		/// </summary>
+		void Extract(const std::vector<int>& faceOrder, const std::vector<int>& componentOffsets, std::vector<LNLib::LN_Mesh>& components) const;
+	};
+}
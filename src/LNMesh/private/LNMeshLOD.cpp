@@ -0,0 +1,335 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshLOD.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "LNMeshSimplifier.h"
+#include "LNBinaryUtils.h"
+#include "LNMappedFile.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    const char LODMagic[4] = { 'L', 'N', 'M', 'L' };
+    const uint32_t LODVersion = 1;
+
+    struct LODHeader
+    {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t LevelCount;
+        uint32_t InputVertexCount;
+        uint64_t VertexCount;
+        uint64_t IndexCount;
+        uint64_t FileSize;
+        uint64_t Checksum;
+    };
+
+    // Payload: level vertex counts, level offsets, vertices, indices and remaps, each padded to 8 bytes.
+    uint64_t getPayloadSize(uint64_t levelCount, uint64_t inputVertexCount, uint64_t vertexCount, uint64_t indexCount)
+    {
+        using LNLibEx::LNBinaryUtils::AlignUp;
+        return AlignUp(levelCount * sizeof(int32_t), 8) +
+               AlignUp((levelCount + 1) * sizeof(int32_t), 8) +
+               vertexCount * 3 * sizeof(double) +
+               AlignUp(indexCount * sizeof(int32_t), 8) +
+               AlignUp(levelCount * inputVertexCount * sizeof(int32_t), 8);
+    }
+}
+
+bool LNLibEx::LNMeshLOD::Build(const LNLib::LN_Mesh& mesh, int levelCount, double reduction)
+{
+    if (levelCount < 1 || !(reduction > 0.0 && reduction < 1.0)) {
+        return false;
+    }
+
+    // Level meshes keep their own compact vertices, toBase maps them back to level 0 vertices
+    // and toLevel maps input vertices to level vertices.
+    std::vector<LNLib::LN_Mesh> levels(1);
+    std::vector<std::vector<int>> toBase(1);
+    std::vector<std::vector<int>> toLevel(1);
+    LNMeshSimplifier triangulator(mesh, INT_MAX, 0.0, true);
+    if (!triangulator.Process(levels[0], toLevel[0])) {
+        return false;
+    }
+    toBase[0].resize(levels[0].Vertices.size());
+    for (size_t i = 0; i < toBase[0].size(); i++) {
+        toBase[0][i] = static_cast<int>(i);
+    }
+
+    while (static_cast<int>(levels.size()) < levelCount) {
+        const LNLib::LN_Mesh& previous = levels.back();
+        int target = static_cast<int>(static_cast<double>(previous.Faces.size()) * reduction);
+        if (target <= 0) {
+            break;
+        }
+
+        LNLib::LN_Mesh level;
+        std::vector<int> vertexMap;
+        LNMeshSimplifier simplifier(previous, target, LNLib::Constants::MaxDistance, true);
+        if (!simplifier.Process(level, vertexMap) || level.Faces.size() >= previous.Faces.size()) {
+            break;
+        }
+
+        const std::vector<int>& sources = simplifier.GetSourceVertices();
+        std::vector<int> levelToBase(sources.size());
+        for (size_t i = 0; i < sources.size(); i++) {
+            levelToBase[i] = toBase.back()[sources[i]];
+        }
+        std::vector<int> inputToLevel(toLevel.back().size());
+        for (size_t i = 0; i < inputToLevel.size(); i++) {
+            int v = toLevel.back()[i];
+            inputToLevel[i] = v < 0 ? -1 : vertexMap[v];
+        }
+
+        levels.emplace_back(std::move(level));
+        toBase.emplace_back(std::move(levelToBase));
+        toLevel.emplace_back(std::move(inputToLevel));
+    }
+
+    const int builtCount = static_cast<int>(levels.size());
+    const int baseCount = static_cast<int>(levels[0].Vertices.size());
+    std::vector<int> lastLevel(baseCount, 0);
+    for (int level = 1; level < builtCount; level++) {
+        for (int v : toBase[level]) {
+            lastLevel[v] = level;
+        }
+    }
+
+    std::vector<int> order(baseCount);
+    for (int i = 0; i < baseCount; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return lastLevel[a] > lastLevel[b]; });
+    std::vector<int> newIndices(baseCount);
+    _vertices.resize(baseCount);
+    for (int i = 0; i < baseCount; i++) {
+        newIndices[order[i]] = i;
+        _vertices[i] = levels[0].Vertices[order[i]];
+    }
+
+    _inputVertexCount = static_cast<int>(mesh.Vertices.size());
+    _levelVertexCounts.assign(builtCount, 0);
+    _levelOffsets.assign(builtCount + 1, 0);
+    _indices.clear();
+    _remaps.assign(static_cast<size_t>(builtCount) * _inputVertexCount, -1);
+    for (int level = 0; level < builtCount; level++) {
+        _levelVertexCounts[level] = static_cast<int>(levels[level].Vertices.size());
+        for (const auto& face : levels[level].Faces) {
+            for (int v : face) {
+                _indices.emplace_back(newIndices[toBase[level][v]]);
+            }
+        }
+        _levelOffsets[level + 1] = static_cast<int>(_indices.size());
+
+        int* remap = _remaps.data() + static_cast<size_t>(level) * _inputVertexCount;
+        for (int i = 0; i < _inputVertexCount; i++) {
+            int v = toLevel[level][i];
+            remap[i] = v < 0 ? -1 : newIndices[toBase[level][v]];
+        }
+    }
+    return true;
+}
+
+int LNLibEx::LNMeshLOD::GetLevelCount() const
+{
+    return static_cast<int>(_levelVertexCounts.size());
+}
+
+const std::vector<LNLib::XYZ>& LNLibEx::LNMeshLOD::GetVertices() const
+{
+    return _vertices;
+}
+
+int LNLibEx::LNMeshLOD::GetLevelVertexCount(int level) const
+{
+    return _levelVertexCounts[level];
+}
+
+int LNLibEx::LNMeshLOD::GetLevelFaceCount(int level) const
+{
+    return (_levelOffsets[level + 1] - _levelOffsets[level]) / 3;
+}
+
+const int* LNLibEx::LNMeshLOD::GetLevelIndices(int level) const
+{
+    return _indices.data() + _levelOffsets[level];
+}
+
+const int* LNLibEx::LNMeshLOD::GetVertexRemap(int level) const
+{
+    return _remaps.data() + static_cast<size_t>(level) * _inputVertexCount;
+}
+
+int LNLibEx::LNMeshLOD::GetInputVertexCount() const
+{
+    return _inputVertexCount;
+}
+
+int LNLibEx::LNMeshLOD::SelectLevel(int maxFaceCount) const
+{
+    for (int level = 0; level < GetLevelCount(); level++) {
+        if (GetLevelFaceCount(level) <= maxFaceCount) {
+            return level;
+        }
+    }
+    return GetLevelCount() - 1;
+}
+
+bool LNLibEx::LNMeshLOD::GetLevel(int level, LNLib::LN_Mesh& mesh) const
+{
+    if (level < 0 || level >= GetLevelCount()) {
+        return false;
+    }
+
+    mesh = LNLib::LN_Mesh();
+    const int vertexCount = _levelVertexCounts[level];
+    mesh.Vertices.assign(_vertices.begin(), _vertices.begin() + vertexCount);
+    const int faceCount = GetLevelFaceCount(level);
+    const int* indices = GetLevelIndices(level);
+    mesh.Faces.reserve(faceCount);
+    for (int i = 0; i < faceCount; i++) {
+        mesh.Faces.push_back({ indices[3 * i], indices[3 * i + 1], indices[3 * i + 2] });
+    }
+    return true;
+}
+
+bool LNLibEx::LNMeshLOD::Write(const std::string& filePath) const
+{
+    if (!LNBinaryUtils::IsLittleEndian()) {
+        return false;
+    }
+
+    LODHeader header = {};
+    std::memcpy(header.Magic, LODMagic, sizeof(LODMagic));
+    header.Version = LODVersion;
+    header.LevelCount = static_cast<uint32_t>(GetLevelCount());
+    header.InputVertexCount = static_cast<uint32_t>(_inputVertexCount);
+    header.VertexCount = _vertices.size();
+    header.IndexCount = _indices.size();
+    const uint64_t payloadSize = getPayloadSize(header.LevelCount, header.InputVertexCount, header.VertexCount, header.IndexCount);
+    header.FileSize = sizeof(LODHeader) + payloadSize;
+
+    std::vector<char> buffer(header.FileSize, 0);
+    char* cursor = buffer.data() + sizeof(LODHeader);
+    std::memcpy(cursor, _levelVertexCounts.data(), _levelVertexCounts.size() * sizeof(int32_t));
+    cursor += LNBinaryUtils::AlignUp(_levelVertexCounts.size() * sizeof(int32_t), 8);
+    std::memcpy(cursor, _levelOffsets.data(), _levelOffsets.size() * sizeof(int32_t));
+    cursor += LNBinaryUtils::AlignUp(_levelOffsets.size() * sizeof(int32_t), 8);
+    double* values = reinterpret_cast<double*>(cursor);
+    for (size_t i = 0; i < _vertices.size(); i++) {
+        values[3 * i] = _vertices[i].GetX();
+        values[3 * i + 1] = _vertices[i].GetY();
+        values[3 * i + 2] = _vertices[i].GetZ();
+    }
+    cursor += _vertices.size() * 3 * sizeof(double);
+    std::memcpy(cursor, _indices.data(), _indices.size() * sizeof(int32_t));
+    cursor += LNBinaryUtils::AlignUp(_indices.size() * sizeof(int32_t), 8);
+    std::memcpy(cursor, _remaps.data(), _remaps.size() * sizeof(int32_t));
+
+    header.Checksum = LNBinaryUtils::Checksum64(buffer.data() + sizeof(LODHeader), payloadSize);
+    std::memcpy(buffer.data(), &header, sizeof(LODHeader));
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(buffer.data(), buffer.size());
+    return file.good();
+}
+
+bool LNLibEx::LNMeshLOD::Read(const std::string& filePath)
+{
+    if (!LNBinaryUtils::IsLittleEndian()) {
+        return false;
+    }
+
+    LNMappedFile file;
+    if (!file.Open(filePath) || file.Size() < sizeof(LODHeader)) {
+        return false;
+    }
+
+    LODHeader header;
+    std::memcpy(&header, file.Data(), sizeof(LODHeader));
+    if (std::memcmp(header.Magic, LODMagic, sizeof(LODMagic)) != 0 ||
+        header.Version != LODVersion ||
+        header.LevelCount == 0 ||
+        header.FileSize != file.Size() ||
+        header.VertexCount > file.Size() / (3 * sizeof(double)) ||
+        header.IndexCount > file.Size() / sizeof(int32_t) ||
+        header.IndexCount % 3 != 0 ||
+        static_cast<uint64_t>(header.LevelCount) * header.InputVertexCount > file.Size() / sizeof(int32_t)) {
+        return false;
+    }
+    const uint64_t payloadSize = getPayloadSize(header.LevelCount, header.InputVertexCount, header.VertexCount, header.IndexCount);
+    if (header.FileSize != sizeof(LODHeader) + payloadSize ||
+        LNBinaryUtils::Checksum64(file.Data() + sizeof(LODHeader), payloadSize) != header.Checksum) {
+        return false;
+    }
+
+    const unsigned char* cursor = file.Data() + sizeof(LODHeader);
+    std::vector<int> levelVertexCounts(header.LevelCount);
+    std::memcpy(levelVertexCounts.data(), cursor, header.LevelCount * sizeof(int32_t));
+    cursor += LNBinaryUtils::AlignUp(header.LevelCount * sizeof(int32_t), 8);
+    std::vector<int> levelOffsets(header.LevelCount + 1);
+    std::memcpy(levelOffsets.data(), cursor, (header.LevelCount + 1) * sizeof(int32_t));
+    cursor += LNBinaryUtils::AlignUp((header.LevelCount + 1) * sizeof(int32_t), 8);
+    if (levelOffsets[0] != 0 || static_cast<uint64_t>(levelOffsets[header.LevelCount]) != header.IndexCount) {
+        return false;
+    }
+    for (uint32_t level = 0; level < header.LevelCount; level++) {
+        if (levelOffsets[level] > levelOffsets[level + 1] || (levelOffsets[level + 1] - levelOffsets[level]) % 3 != 0 ||
+            levelVertexCounts[level] < 0 || static_cast<uint64_t>(levelVertexCounts[level]) > header.VertexCount) {
+            return false;
+        }
+    }
+
+    const double* values = reinterpret_cast<const double*>(cursor);
+    std::vector<LNLib::XYZ> vertices;
+    vertices.reserve(header.VertexCount);
+    for (uint64_t i = 0; i < header.VertexCount; i++) {
+        vertices.emplace_back(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+    }
+    cursor += header.VertexCount * 3 * sizeof(double);
+    std::vector<int> indices(header.IndexCount);
+    std::memcpy(indices.data(), cursor, header.IndexCount * sizeof(int32_t));
+    cursor += LNBinaryUtils::AlignUp(header.IndexCount * sizeof(int32_t), 8);
+    for (uint32_t level = 0; level < header.LevelCount; level++) {
+        for (int i = levelOffsets[level]; i < levelOffsets[level + 1]; i++) {
+            if (indices[i] < 0 || indices[i] >= levelVertexCounts[level]) {
+                return false;
+            }
+        }
+    }
+    std::vector<int> remaps(static_cast<size_t>(header.LevelCount) * header.InputVertexCount);
+    std::memcpy(remaps.data(), cursor, remaps.size() * sizeof(int32_t));
+    for (uint32_t level = 0; level < header.LevelCount; level++) {
+        const int* remap = remaps.data() + static_cast<size_t>(level) * header.InputVertexCount;
+        for (uint32_t i = 0; i < header.InputVertexCount; i++) {
+            if (remap[i] < -1 || remap[i] >= levelVertexCounts[level]) {
+                return false;
+            }
+        }
+    }
+
+    _inputVertexCount = static_cast<int>(header.InputVertexCount);
+    _vertices = std::move(vertices);
+    _levelVertexCounts = std::move(levelVertexCounts);
+    _levelOffsets = std::move(levelOffsets);
+    _indices = std::move(indices);
+    _remaps = std::move(remaps);
+    return true;
+}
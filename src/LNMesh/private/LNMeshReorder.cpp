@@ -0,0 +1,135 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshReorder.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "UV.h"
+
+namespace
+{
+    template<typename T>
+    void permute(std::vector<T>& values, const std::vector<int>& newIndices) {
+        std::vector<T> result(values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            result[newIndices[i]] = values[i];
+        }
+        values = std::move(result);
+    }
+
+    std::vector<int> getFirstUseOrder(const std::vector<int>& indices, size_t count) {
+        std::vector<int> newIndices(count, -1);
+        int next = 0;
+        for (int index : indices) {
+            if (newIndices[index] < 0) {
+                newIndices[index] = next++;
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (newIndices[i] < 0) {
+                newIndices[i] = next++;
+            }
+        }
+        return newIndices;
+    }
+}
+
+bool LNLibEx::LNMeshReorder::Validate(const LNLib::LN_Mesh& mesh)
+{
+    const int vertexCount = static_cast<int>(mesh.Vertices.size());
+    size_t cornerCount = 0;
+    for (const auto& face : mesh.Faces) {
+        for (int index : face) {
+            if (index < 0 || index >= vertexCount) {
+                return false;
+            }
+        }
+        cornerCount += face.size();
+    }
+    if ((!mesh.UVIndices.empty() && mesh.UVIndices.size() != cornerCount) ||
+        (!mesh.NormalIndices.empty() && mesh.NormalIndices.size() != cornerCount)) {
+        return false;
+    }
+    for (int index : mesh.UVIndices) {
+        if (index < 0 || index >= static_cast<int>(mesh.UVs.size())) {
+            return false;
+        }
+    }
+    for (int index : mesh.NormalIndices) {
+        if (index < 0 || index >= static_cast<int>(mesh.Normals.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LNLibEx::LNMeshReorder::PermuteFaces(LNLib::LN_Mesh& mesh, const std::vector<int>& order)
+{
+    const size_t faceCount = mesh.Faces.size();
+    std::vector<size_t> cornerOffsets(faceCount + 1, 0);
+    for (size_t i = 0; i < faceCount; i++) {
+        cornerOffsets[i + 1] = cornerOffsets[i] + mesh.Faces[i].size();
+    }
+
+    auto permuteCorners = [&](std::vector<int>& indices) {
+        if (indices.empty()) {
+            return;
+        }
+        std::vector<int> result;
+        result.reserve(indices.size());
+        for (int face : order) {
+            result.insert(result.end(), indices.begin() + cornerOffsets[face], indices.begin() + cornerOffsets[face + 1]);
+        }
+        indices = std::move(result);
+    };
+    permuteCorners(mesh.UVIndices);
+    permuteCorners(mesh.NormalIndices);
+
+    std::vector<std::vector<int>> faces(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        faces[i] = std::move(mesh.Faces[order[i]]);
+    }
+    mesh.Faces = std::move(faces);
+}
+
+void LNLibEx::LNMeshReorder::PermuteVertices(LNLib::LN_Mesh& mesh, const std::vector<int>& newIndices)
+{
+    permute(mesh.Vertices, newIndices);
+    for (auto& face : mesh.Faces) {
+        for (int& index : face) {
+            index = newIndices[index];
+        }
+    }
+}
+
+void LNLibEx::LNMeshReorder::OrderByFirstUse(LNLib::LN_Mesh& mesh)
+{
+    std::vector<int> corners;
+    for (const auto& face : mesh.Faces) {
+        corners.insert(corners.end(), face.begin(), face.end());
+    }
+    PermuteVertices(mesh, getFirstUseOrder(corners, mesh.Vertices.size()));
+    OrderAttributesByFirstUse(mesh);
+}
+
+void LNLibEx::LNMeshReorder::OrderAttributesByFirstUse(LNLib::LN_Mesh& mesh)
+{
+    std::vector<int> newIndices = getFirstUseOrder(mesh.UVIndices, mesh.UVs.size());
+    permute(mesh.UVs, newIndices);
+    for (int& index : mesh.UVIndices) {
+        index = newIndices[index];
+    }
+
+    newIndices = getFirstUseOrder(mesh.NormalIndices, mesh.Normals.size());
+    permute(mesh.Normals, newIndices);
+    for (int& index : mesh.NormalIndices) {
+        index = newIndices[index];
+    }
+}
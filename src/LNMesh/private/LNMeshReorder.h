@@ -0,0 +1,51 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNObject.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Permutations of LN_Mesh elements that keep Faces, UVIndices and NormalIndices consistent.
+	/// UVIndices and NormalIndices are expected to be empty or hold one index per face corner.
+	/// </summary>
+	class LNMeshReorder
+	{
+	public:
+
+		/// <summary>
+		/// Check face and attribute indices before reordering.
+		/// </summary>
+		static bool Validate(const LNLib::LN_Mesh& mesh);
+
+		/// <summary>
+		/// Face order[i] of input becomes face i, per-corner indices move with their faces.
+		/// order may select a subset of faces, the others are dropped.
+		/// </summary>
+		static void PermuteFaces(LNLib::LN_Mesh& mesh, const std::vector<int>& order);
+
+		/// <summary>
+		/// Vertex i of input becomes vertex newIndices[i], newIndices must be a permutation.
+		/// </summary>
+		static void PermuteVertices(LNLib::LN_Mesh& mesh, const std::vector<int>& newIndices);
+
+		/// <summary>
+		/// Renumber Vertices, UVs and Normals in order of first reference by faces.
+		/// Unreferenced entries are kept at the end in their original order.
+		/// </summary>
+		static void OrderByFirstUse(LNLib::LN_Mesh& mesh);
+
+		/// <summary>
+		/// Renumber only UVs and Normals in order of first reference by faces.
+		/// </summary>
+		static void OrderAttributesByFirstUse(LNLib::LN_Mesh& mesh);
+	};
+}
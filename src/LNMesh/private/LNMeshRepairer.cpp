@@ -0,0 +1,284 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshRepairer.h"
+#include "LNMeshTopology.h"
+#include "LNMeshReorder.h"
+#include "LNUnionFind.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    // Faces smaller than this fraction of their longest edge squared are treated as zero area.
+    const double RelativeAreaTolerance = 1E-12;
+
+    double getSignedVolume(const LNLib::LN_Mesh& mesh, const std::vector<int>& face) {
+        double volume = 0.0;
+        const LNLib::XYZ& origin = mesh.Vertices[face[0]];
+        for (size_t k = 1; k + 1 < face.size(); k++) {
+            volume += origin.DotProduct(mesh.Vertices[face[k]].CrossProduct(mesh.Vertices[face[k + 1]]));
+        }
+        return volume / 6.0;
+    }
+}
+
+LNLibEx::LNMeshRepairer::LNMeshRepairer(LNLib::LN_Mesh& mesh, double areaTolerance, LNMeshRepairReport& report):
+                                                _mesh(mesh), _areaTolerance(areaTolerance), _report(report){}
+
+void LNLibEx::LNMeshRepairer::BuildCornerOffsets()
+{
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+    _cornerOffsets.assign(faceCount + 1, 0);
+    for (int i = 0; i < faceCount; i++) {
+        _cornerOffsets[i + 1] = _cornerOffsets[i] + static_cast<int>(_mesh.Faces[i].size());
+    }
+}
+
+void LNLibEx::LNMeshRepairer::RemoveDefectiveFaces()
+{
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+    std::vector<char> isDegenerate(faceCount, 0);
+    std::vector<std::vector<int>> keys(faceCount);
+    LNParallel::For(0, faceCount, [&](int64_t i) {
+        const std::vector<int>& face = _mesh.Faces[i];
+        std::vector<int>& key = keys[i];
+        key = face;
+        std::sort(key.begin(), key.end());
+        key.erase(std::unique(key.begin(), key.end()), key.end());
+        if (key.size() < 3) {
+            isDegenerate[i] = 1;
+            return;
+        }
+
+        LNLib::XYZ normal(0, 0, 0);
+        double longest = 0.0;
+        for (size_t k = 0; k < face.size(); k++) {
+            const LNLib::XYZ& current = _mesh.Vertices[face[k]];
+            const LNLib::XYZ& next = _mesh.Vertices[face[(k + 1) % face.size()]];
+            normal += current.CrossProduct(next);
+            longest = std::max(longest, current.Distance(next));
+        }
+        double area = 0.5 * normal.Length();
+        if (area <= _areaTolerance || area <= RelativeAreaTolerance * longest * longest) {
+            isDegenerate[i] = 1;
+        }
+    }, 4096);
+
+    std::vector<int> candidates;
+    candidates.reserve(faceCount);
+    for (int i = 0; i < faceCount; i++) {
+        if (isDegenerate[i]) {
+            _report.DegenerateFaces++;
+        }
+        else {
+            candidates.emplace_back(i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+        return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+    });
+
+    std::vector<char> isKept(faceCount, 0);
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (i > 0 && keys[candidates[i]] == keys[candidates[i - 1]]) {
+            _report.DuplicateFaces++;
+        }
+        else {
+            isKept[candidates[i]] = 1;
+        }
+    }
+
+    std::vector<int> order;
+    order.reserve(candidates.size());
+    for (int i = 0; i < faceCount; i++) {
+        if (isKept[i]) {
+            order.emplace_back(i);
+        }
+    }
+    if (static_cast<int>(order.size()) != faceCount) {
+        LNMeshReorder::PermuteFaces(_mesh, order);
+    }
+}
+
+void LNLibEx::LNMeshRepairer::FlipFace(int face)
+{
+    std::vector<int>& vertices = _mesh.Faces[face];
+    std::reverse(vertices.begin(), vertices.end());
+    if (!_mesh.UVIndices.empty()) {
+        std::reverse(_mesh.UVIndices.begin() + _cornerOffsets[face], _mesh.UVIndices.begin() + _cornerOffsets[face + 1]);
+    }
+    if (!_mesh.NormalIndices.empty()) {
+        std::reverse(_mesh.NormalIndices.begin() + _cornerOffsets[face], _mesh.NormalIndices.begin() + _cornerOffsets[face + 1]);
+    }
+}
+
+void LNLibEx::LNMeshRepairer::Orient()
+{
+    LNMeshTopology topology;
+    topology.Build(_mesh);
+    BuildCornerOffsets();
+
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+    const int edgeCount = topology.GetEdgeCount();
+    LNUnionFind faceSets(faceCount);
+    LNParallel::For(0, edgeCount, [&](int64_t edge) {
+        std::vector<int> halfEdges = topology.GetEdgeHalfEdges(static_cast<int>(edge));
+        if (halfEdges.size() == 2) {
+            faceSets.Unite(topology.GetFace(halfEdges[0]), topology.GetFace(halfEdges[1]));
+        }
+    }, 4096);
+
+    std::vector<int> labels;
+    const int componentCount = faceSets.GetLabels(labels);
+    std::vector<int> componentOffsets(componentCount + 1, 0);
+    for (int label : labels) {
+        componentOffsets[label + 1]++;
+    }
+    for (int i = 0; i < componentCount; i++) {
+        componentOffsets[i + 1] += componentOffsets[i];
+    }
+    std::vector<int> componentFaces(faceCount);
+    std::vector<int> cursor(componentOffsets.begin(), componentOffsets.end() - 1);
+    for (int i = 0; i < faceCount; i++) {
+        componentFaces[cursor[labels[i]]++] = i;
+    }
+
+    // Components share no manifold edge, so each one is flood filled and flipped by one thread.
+    std::vector<char> isFlipped(faceCount, 0);
+    std::vector<char> isVisited(faceCount, 0);
+    std::atomic<int> flippedCount(0);
+    std::atomic<int> nonOrientableCount(0);
+    LNParallel::For(0, componentCount, [&](int64_t component) {
+        const int begin = componentOffsets[component];
+        const int end = componentOffsets[component + 1];
+        bool isOrientable = true;
+        bool isClosed = true;
+        std::vector<int> queue;
+        queue.reserve(end - begin);
+        queue.emplace_back(componentFaces[begin]);
+        isVisited[componentFaces[begin]] = 1;
+        for (size_t q = 0; q < queue.size(); q++) {
+            int face = queue[q];
+            for (int halfEdge = topology.GetFaceHalfEdge(face); halfEdge < _cornerOffsets[face + 1]; halfEdge++) {
+                std::vector<int> halfEdges = topology.GetEdgeHalfEdges(topology.GetEdge(halfEdge));
+                if (halfEdges.size() != 2) {
+                    isClosed = false;
+                    continue;
+                }
+                int other = halfEdges[0] == halfEdge ? halfEdges[1] : halfEdges[0];
+                int neighbour = topology.GetFace(other);
+                bool isSameDirection = topology.GetOrigin(other) == topology.GetOrigin(halfEdge);
+                char flip = static_cast<char>(isFlipped[face] ^ (isSameDirection ? 1 : 0));
+                if (!isVisited[neighbour]) {
+                    isVisited[neighbour] = 1;
+                    isFlipped[neighbour] = flip;
+                    queue.emplace_back(neighbour);
+                }
+                else if (isFlipped[neighbour] != flip) {
+                    isOrientable = false;
+                }
+            }
+        }
+
+        // Closed shells face outwards, open ones keep the orientation of the majority.
+        bool isInverted = false;
+        if (isClosed && isOrientable) {
+            double volume = 0.0;
+            for (int face : queue) {
+                double faceVolume = getSignedVolume(_mesh, _mesh.Faces[face]);
+                volume += isFlipped[face] ? -faceVolume : faceVolume;
+            }
+            isInverted = volume < 0.0;
+        }
+        else {
+            int flips = 0;
+            for (int face : queue) {
+                flips += isFlipped[face];
+            }
+            isInverted = 2 * flips > static_cast<int>(queue.size());
+        }
+
+        int flips = 0;
+        for (int face : queue) {
+            if ((isFlipped[face] != 0) != isInverted) {
+                FlipFace(face);
+                flips++;
+            }
+        }
+        flippedCount += flips;
+        if (!isOrientable) {
+            nonOrientableCount++;
+        }
+    }, 1);
+
+    _report.ComponentCount = componentCount;
+    _report.FlippedFaces = flippedCount;
+    _report.NonOrientableComponents = nonOrientableCount;
+}
+
+void LNLibEx::LNMeshRepairer::FindHoles(const LNMeshTopology& topology)
+{
+    const int vertexCount = topology.GetVertexCount();
+    std::vector<int> boundaryOffsets(vertexCount + 1, 0);
+    std::vector<int> boundaryHalfEdges;
+    for (int edge : topology.GetBoundaryEdges()) {
+        int halfEdge = topology.GetEdgeHalfEdges(edge)[0];
+        boundaryHalfEdges.emplace_back(halfEdge);
+        boundaryOffsets[topology.GetOrigin(halfEdge) + 1]++;
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        boundaryOffsets[i + 1] += boundaryOffsets[i];
+    }
+    std::vector<int> outgoing(boundaryHalfEdges.size());
+    std::vector<int> cursor(boundaryOffsets.begin(), boundaryOffsets.end() - 1);
+    for (int halfEdge : boundaryHalfEdges) {
+        outgoing[cursor[topology.GetOrigin(halfEdge)]++] = halfEdge;
+    }
+
+    // Walks from every vertex with unused outgoing boundary half-edges until the loop closes.
+    std::vector<int> used(vertexCount, 0);
+    for (int origin = 0; origin < vertexCount; origin++) {
+        while (used[origin] < boundaryOffsets[origin + 1] - boundaryOffsets[origin]) {
+            std::vector<int> loop;
+            int vertex = origin;
+            while (used[vertex] < boundaryOffsets[vertex + 1] - boundaryOffsets[vertex]) {
+                int halfEdge = outgoing[boundaryOffsets[vertex] + used[vertex]];
+                used[vertex]++;
+                loop.emplace_back(vertex);
+                vertex = topology.GetTarget(halfEdge);
+                if (vertex == origin) {
+                    break;
+                }
+            }
+            _report.Holes.emplace_back(std::move(loop));
+        }
+    }
+}
+
+bool LNLibEx::LNMeshRepairer::Process()
+{
+    _report = LNMeshRepairReport();
+    if (!LNMeshReorder::Validate(_mesh)) {
+        return false;
+    }
+
+    RemoveDefectiveFaces();
+    Orient();
+
+    LNMeshTopology topology;
+    topology.Build(_mesh);
+    FindHoles(topology);
+    return true;
+}
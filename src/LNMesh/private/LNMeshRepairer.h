@@ -0,0 +1,42 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNObject.h"
+#include "LNMeshRepairReport.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	class LNMeshTopology;
+
+	class LNMeshRepairer
+	{
+	private:
+
+		LNLib::LN_Mesh& _mesh;
+		double _areaTolerance;
+		LNMeshRepairReport& _report;
+
+		std::vector<int> _cornerOffsets;
+
+	private:
+
+		void BuildCornerOffsets();
+		void RemoveDefectiveFaces();
+		void Orient();
+		void FlipFace(int face);
+		void FindHoles(const LNMeshTopology& topology);
+
+	public:
+
+		LNMeshRepairer(LNLib::LN_Mesh& mesh, double areaTolerance, LNMeshRepairReport& report);
+		bool Process();
+	};
+}
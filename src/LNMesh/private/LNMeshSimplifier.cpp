@@ -0,0 +1,513 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshSimplifier.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const double BoundaryWeight = 1000.0;
+    const double FlipThreshold = 0.2;
+
+    void cross(const double* a, const double* b, double* result) {
+        result[0] = a[1] * b[2] - a[2] * b[1];
+        result[1] = a[2] * b[0] - a[0] * b[2];
+        result[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    double dot(const double* a, const double* b) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    void addPlane(double* quadric, const double* normal, double d, double weight) {
+        const double a = normal[0];
+        const double b = normal[1];
+        const double c = normal[2];
+        quadric[0] += weight * a * a;
+        quadric[1] += weight * a * b;
+        quadric[2] += weight * a * c;
+        quadric[3] += weight * a * d;
+        quadric[4] += weight * b * b;
+        quadric[5] += weight * b * c;
+        quadric[6] += weight * b * d;
+        quadric[7] += weight * c * c;
+        quadric[8] += weight * c * d;
+        quadric[9] += weight * d * d;
+    }
+
+    double evaluate(const double* q, const double* v) {
+        const double x = v[0];
+        const double y = v[1];
+        const double z = v[2];
+        return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+             + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+             + q[7] * z * z + 2 * q[8] * z
+             + q[9];
+    }
+}
+
+LNLibEx::LNMeshSimplifier::LNMeshSimplifier(const LNLib::LN_Mesh& mesh, int targetFaceCount, double maxError, bool keepPositions):
+                                                _mesh(mesh), _targetFaceCount(std::max(0, targetFaceCount)), _maxError(maxError), _keepPositions(keepPositions){}
+
+bool LNLibEx::LNMeshSimplifier::Initialize()
+{
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    _positions.resize(3 * static_cast<size_t>(vertexCount));
+    for (int i = 0; i < vertexCount; i++) {
+        _positions[3 * i] = _mesh.Vertices[i].GetX();
+        _positions[3 * i + 1] = _mesh.Vertices[i].GetY();
+        _positions[3 * i + 2] = _mesh.Vertices[i].GetZ();
+    }
+
+    _triangles.clear();
+    for (const auto& face : _mesh.Faces) {
+        if (face.size() < 3) {
+            return false;
+        }
+        for (int index : face) {
+            if (index < 0 || index >= vertexCount) {
+                return false;
+            }
+        }
+        for (size_t k = 1; k + 1 < face.size(); k++) {
+            std::array<int, 3> triangle = { face[0], face[k], face[k + 1] };
+            if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2]) {
+                _triangles.emplace_back(triangle);
+            }
+        }
+    }
+    _aliveCount = static_cast<int>(_triangles.size());
+    _collapseTo.assign(vertexCount, -1);
+    _isBoundary.assign(vertexCount, 0);
+    _quadrics.assign(vertexCount, Quadric());
+
+    BuildVertexTriangles();
+
+    // Every vertex gathers the planes of its own triangles and boundary edges, no shared writes.
+    LNParallel::For(0, vertexCount, [&](int64_t v) {
+        double* quadric = _quadrics[v].A;
+        std::vector<std::pair<int, int>> edges;
+        for (int k = _vertexOffsets[v]; k < _vertexOffsets[v + 1]; k++) {
+            const std::array<int, 3>& triangle = _triangles[_vertexTriangles[k]];
+            const double* p0 = &_positions[3 * triangle[0]];
+            const double* p1 = &_positions[3 * triangle[1]];
+            const double* p2 = &_positions[3 * triangle[2]];
+            double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            double normal[3];
+            cross(e1, e2, normal);
+            double length = std::sqrt(dot(normal, normal));
+            if (length <= 0.0) {
+                continue;
+            }
+            for (int i = 0; i < 3; i++) {
+                normal[i] /= length;
+            }
+            addPlane(quadric, normal, -dot(normal, p0), 0.5 * length);
+
+            for (int i = 0; i < 3; i++) {
+                if (triangle[i] == v) {
+                    edges.emplace_back(triangle[(i + 1) % 3], _vertexTriangles[k]);
+                    edges.emplace_back(triangle[(i + 2) % 3], _vertexTriangles[k]);
+                }
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size(); ) {
+            size_t j = i;
+            while (j < edges.size() && edges[j].first == edges[i].first) {
+                j++;
+            }
+            if (j - i == 1) {
+                _isBoundary[v] = 1;
+                const std::array<int, 3>& triangle = _triangles[edges[i].second];
+                const double* p = &_positions[3 * v];
+                const double* q = &_positions[3 * edges[i].first];
+                const double* p0 = &_positions[3 * triangle[0]];
+                const double* p1 = &_positions[3 * triangle[1]];
+                const double* p2 = &_positions[3 * triangle[2]];
+                double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+                double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+                double faceNormal[3];
+                cross(e1, e2, faceNormal);
+                double edge[3] = { q[0] - p[0], q[1] - p[1], q[2] - p[2] };
+                double normal[3];
+                cross(edge, faceNormal, normal);
+                double length = std::sqrt(dot(normal, normal));
+                if (length > 0.0) {
+                    for (int k = 0; k < 3; k++) {
+                        normal[k] /= length;
+                    }
+                    addPlane(quadric, normal, -dot(normal, p), BoundaryWeight * dot(edge, edge));
+                }
+            }
+            i = j;
+        }
+    }, 1024);
+    return true;
+}
+
+void LNLibEx::LNMeshSimplifier::BuildVertexTriangles()
+{
+    const int vertexCount = static_cast<int>(_collapseTo.size());
+    const int triangleCount = static_cast<int>(_triangles.size());
+
+    _vertexOffsets.assign(vertexCount + 1, 0);
+    for (const auto& triangle : _triangles) {
+        if (triangle[0] < 0) {
+            continue;
+        }
+        for (int v : triangle) {
+            _vertexOffsets[v + 1]++;
+        }
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        _vertexOffsets[i + 1] += _vertexOffsets[i];
+    }
+
+    std::vector<int> cursor(_vertexOffsets.begin(), _vertexOffsets.end() - 1);
+    _vertexTriangles.resize(_vertexOffsets[vertexCount]);
+    for (int i = 0; i < triangleCount; i++) {
+        if (_triangles[i][0] < 0) {
+            continue;
+        }
+        for (int v : _triangles[i]) {
+            _vertexTriangles[cursor[v]++] = i;
+        }
+    }
+}
+
+void LNLibEx::LNMeshSimplifier::GetNeighbors(int vertex, std::vector<int>& neighbors) const
+{
+    neighbors.clear();
+    for (int k = _vertexOffsets[vertex]; k < _vertexOffsets[vertex + 1]; k++) {
+        for (int v : _triangles[_vertexTriangles[k]]) {
+            if (v != vertex) {
+                neighbors.emplace_back(v);
+            }
+        }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+}
+
+double LNLibEx::LNMeshSimplifier::ComputeCost(int a, int b, double* position) const
+{
+    double q[10];
+    for (int i = 0; i < 10; i++) {
+        q[i] = _quadrics[a].A[i] + _quadrics[b].A[i];
+    }
+
+    // Solve A * v = -b by Cramer's rule when well conditioned.
+    double m00 = q[0], m01 = q[1], m02 = q[2];
+    double m11 = q[4], m12 = q[5], m22 = q[7];
+    double c00 = m11 * m22 - m12 * m12;
+    double c01 = m02 * m12 - m01 * m22;
+    double c02 = m01 * m12 - m02 * m11;
+    double determinant = m00 * c00 + m01 * c01 + m02 * c02;
+    double scale = std::max({ std::fabs(m00), std::fabs(m11), std::fabs(m22) });
+    if (!_keepPositions && scale > 0.0 && std::fabs(determinant) > 1E-10 * scale * scale * scale) {
+        double c11 = m00 * m22 - m02 * m02;
+        double c12 = m01 * m02 - m00 * m12;
+        double c22 = m00 * m11 - m01 * m01;
+        double r[3] = { -q[3], -q[6], -q[8] };
+        double v[3] = {
+            (c00 * r[0] + c01 * r[1] + c02 * r[2]) / determinant,
+            (c01 * r[0] + c11 * r[1] + c12 * r[2]) / determinant,
+            (c02 * r[0] + c12 * r[1] + c22 * r[2]) / determinant,
+        };
+
+        // Reject solutions far away from the edge, they come from nearly flat quadrics.
+        const double* pa = &_positions[3 * a];
+        const double* pb = &_positions[3 * b];
+        double edge[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+        double offset[3] = { v[0] - 0.5 * (pa[0] + pb[0]), v[1] - 0.5 * (pa[1] + pb[1]), v[2] - 0.5 * (pa[2] + pb[2]) };
+        if (dot(offset, offset) <= 4.0 * dot(edge, edge)) {
+            std::copy(v, v + 3, position);
+            return std::max(0.0, evaluate(q, v));
+        }
+    }
+
+    const double* pa = &_positions[3 * a];
+    const double* pb = &_positions[3 * b];
+    double middle[3] = { 0.5 * (pa[0] + pb[0]), 0.5 * (pa[1] + pb[1]), 0.5 * (pa[2] + pb[2]) };
+    const double* candidates[3] = { pa, pb, middle };
+    const int candidateCount = _keepPositions ? 2 : 3;
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < candidateCount; i++) {
+        const double* candidate = candidates[i];
+        double error = evaluate(q, candidate);
+        if (error < best) {
+            best = error;
+            std::copy(candidate, candidate + 3, position);
+        }
+    }
+    return std::max(0.0, best);
+}
+
+bool LNLibEx::LNMeshSimplifier::IsCollapseValid(int a, int b, const double* position, std::vector<int>& scratchA, std::vector<int>& scratchB) const
+{
+    int shared = 0;
+    for (int k = _vertexOffsets[a]; k < _vertexOffsets[a + 1]; k++) {
+        const std::array<int, 3>& triangle = _triangles[_vertexTriangles[k]];
+        if (triangle[0] == b || triangle[1] == b || triangle[2] == b) {
+            shared++;
+        }
+    }
+    if (shared == 0 || shared > 2 || (_isBoundary[a] && _isBoundary[b] && shared == 2)) {
+        return false;
+    }
+
+    // Link condition: common neighbors must be exactly the apexes of the shared triangles.
+    GetNeighbors(a, scratchA);
+    GetNeighbors(b, scratchB);
+    int common = 0;
+    for (size_t i = 0, j = 0; i < scratchA.size() && j < scratchB.size(); ) {
+        if (scratchA[i] < scratchB[j]) {
+            i++;
+        }
+        else if (scratchA[i] > scratchB[j]) {
+            j++;
+        }
+        else {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    if (common != shared) {
+        return false;
+    }
+
+    for (int vertex : { a, b }) {
+        for (int k = _vertexOffsets[vertex]; k < _vertexOffsets[vertex + 1]; k++) {
+            const std::array<int, 3>& triangle = _triangles[_vertexTriangles[k]];
+            bool hasA = triangle[0] == a || triangle[1] == a || triangle[2] == a;
+            bool hasB = triangle[0] == b || triangle[1] == b || triangle[2] == b;
+            if (hasA && hasB) {
+                continue;
+            }
+
+            const double* before[3];
+            const double* after[3];
+            for (int i = 0; i < 3; i++) {
+                before[i] = &_positions[3 * triangle[i]];
+                after[i] = triangle[i] == vertex ? position : before[i];
+            }
+            double e1[3], e2[3], n0[3], n1[3];
+            for (int i = 0; i < 3; i++) {
+                e1[i] = before[1][i] - before[0][i];
+                e2[i] = before[2][i] - before[0][i];
+            }
+            cross(e1, e2, n0);
+            for (int i = 0; i < 3; i++) {
+                e1[i] = after[1][i] - after[0][i];
+                e2[i] = after[2][i] - after[0][i];
+            }
+            cross(e1, e2, n1);
+            double l0 = std::sqrt(dot(n0, n0));
+            double l1 = std::sqrt(dot(n1, n1));
+            if (l1 <= 0.0 || dot(n0, n1) < FlipThreshold * l0 * l1) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool LNLibEx::LNMeshSimplifier::CollapsePass()
+{
+    const int vertexCount = static_cast<int>(_collapseTo.size());
+    BuildVertexTriangles();
+
+    std::vector<int> edgeOffsets(vertexCount + 1, 0);
+    LNParallel::ForEachChunk(0, vertexCount, 1024, [&](int, int64_t begin, int64_t end) {
+        std::vector<int> neighbors;
+        for (int64_t v = begin; v < end; v++) {
+            GetNeighbors(static_cast<int>(v), neighbors);
+            edgeOffsets[v + 1] = static_cast<int>(neighbors.end() - std::upper_bound(neighbors.begin(), neighbors.end(), static_cast<int>(v)));
+        }
+    });
+    for (int i = 0; i < vertexCount; i++) {
+        edgeOffsets[i + 1] += edgeOffsets[i];
+    }
+
+    const int edgeCount = edgeOffsets[vertexCount];
+    if (edgeCount == 0) {
+        return false;
+    }
+    std::vector<int> edgeA(edgeCount);
+    std::vector<int> edgeB(edgeCount);
+    std::vector<double> costs(edgeCount);
+    std::vector<double> positions(3 * static_cast<size_t>(edgeCount));
+    LNParallel::ForEachChunk(0, vertexCount, 1024, [&](int, int64_t begin, int64_t end) {
+        std::vector<int> neighbors;
+        for (int64_t v = begin; v < end; v++) {
+            GetNeighbors(static_cast<int>(v), neighbors);
+            int e = edgeOffsets[v];
+            for (auto it = std::upper_bound(neighbors.begin(), neighbors.end(), static_cast<int>(v)); it != neighbors.end(); ++it, ++e) {
+                edgeA[e] = static_cast<int>(v);
+                edgeB[e] = *it;
+                costs[e] = ComputeCost(edgeA[e], edgeB[e], &positions[3 * static_cast<size_t>(e)]);
+            }
+        }
+    });
+
+    // Only the cheapest third of edges compete in one pass, which keeps the order close to a serial greedy collapse.
+    std::vector<int> pool;
+    pool.reserve(edgeCount);
+    for (int e = 0; e < edgeCount; e++) {
+        if (costs[e] <= _maxError) {
+            pool.emplace_back(e);
+        }
+    }
+    if (pool.empty()) {
+        return false;
+    }
+    auto byCost = [&](int x, int y) { return costs[x] < costs[y] || (costs[x] == costs[y] && x < y); };
+    size_t poolSize = std::min(pool.size(), std::max<size_t>(64, edgeCount / 3));
+    std::nth_element(pool.begin(), pool.begin() + (poolSize - 1), pool.end(), byCost);
+    pool.resize(poolSize);
+    std::sort(pool.begin(), pool.end(), byCost);
+
+    // Collapses in an independent set never touch the same triangle, so validity can be tested up front.
+    std::vector<char> isValid(poolSize, 0);
+    LNParallel::ForEachChunk(0, static_cast<int64_t>(poolSize), 256, [&](int, int64_t begin, int64_t end) {
+        std::vector<int> scratchA;
+        std::vector<int> scratchB;
+        for (int64_t i = begin; i < end; i++) {
+            int e = pool[i];
+            isValid[i] = IsCollapseValid(edgeA[e], edgeB[e], &positions[3 * static_cast<size_t>(e)], scratchA, scratchB) ? 1 : 0;
+        }
+    });
+
+    std::vector<char> isLocked(vertexCount, 0);
+    std::vector<int> accepted;
+    int removed = 0;
+    const int needed = _aliveCount - _targetFaceCount;
+    for (size_t i = 0; i < poolSize && removed < needed; i++) {
+        int e = pool[i];
+        int a = edgeA[e];
+        int b = edgeB[e];
+        if (!isValid[i] || isLocked[a] || isLocked[b]) {
+            continue;
+        }
+        accepted.emplace_back(e);
+        for (int vertex : { a, b }) {
+            for (int k = _vertexOffsets[vertex]; k < _vertexOffsets[vertex + 1]; k++) {
+                const std::array<int, 3>& triangle = _triangles[_vertexTriangles[k]];
+                bool hasA = triangle[0] == a || triangle[1] == a || triangle[2] == a;
+                bool hasB = triangle[0] == b || triangle[1] == b || triangle[2] == b;
+                if (vertex == a && hasA && hasB) {
+                    removed++;
+                }
+                for (int v : triangle) {
+                    isLocked[v] = 1;
+                }
+            }
+        }
+    }
+    if (accepted.empty()) {
+        return false;
+    }
+
+    LNParallel::For(0, static_cast<int64_t>(accepted.size()), [&](int64_t i) {
+        int e = accepted[i];
+        int a = edgeA[e];
+        int b = edgeB[e];
+        if (_keepPositions && std::equal(&positions[3 * static_cast<size_t>(e)], &positions[3 * static_cast<size_t>(e)] + 3, &_positions[3 * static_cast<size_t>(b)])) {
+            std::swap(a, b);
+        }
+        std::copy(&positions[3 * static_cast<size_t>(e)], &positions[3 * static_cast<size_t>(e)] + 3, &_positions[3 * static_cast<size_t>(a)]);
+        for (int k = 0; k < 10; k++) {
+            _quadrics[a].A[k] += _quadrics[b].A[k];
+        }
+        // The survivor inherits the border of b, so later collapses still respect it.
+        _isBoundary[a] |= _isBoundary[b];
+        _collapseTo[b] = a;
+    }, 1024);
+
+    LNParallel::For(0, static_cast<int64_t>(_triangles.size()), [&](int64_t i) {
+        std::array<int, 3>& triangle = _triangles[i];
+        if (triangle[0] < 0) {
+            return;
+        }
+        for (int& v : triangle) {
+            if (_collapseTo[v] >= 0) {
+                v = _collapseTo[v];
+            }
+        }
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) {
+            triangle = { -1, -1, -1 };
+        }
+    }, 8192);
+
+    _aliveCount -= removed;
+    return true;
+}
+
+void LNLibEx::LNMeshSimplifier::Compact(LNLib::LN_Mesh& result, std::vector<int>& vertexMap)
+{
+    const int vertexCount = static_cast<int>(_collapseTo.size());
+    std::vector<int> newIndices(vertexCount, -1);
+
+    result = LNLib::LN_Mesh();
+    _sourceVertices.clear();
+    result.Faces.reserve(_aliveCount);
+    for (const auto& triangle : _triangles) {
+        if (triangle[0] < 0) {
+            continue;
+        }
+        std::vector<int> face(3);
+        for (int i = 0; i < 3; i++) {
+            int v = triangle[i];
+            if (newIndices[v] < 0) {
+                newIndices[v] = static_cast<int>(result.Vertices.size());
+                _sourceVertices.emplace_back(v);
+                result.Vertices.emplace_back(_positions[3 * v], _positions[3 * v + 1], _positions[3 * v + 2]);
+            }
+            face[i] = newIndices[v];
+        }
+        result.Faces.emplace_back(face);
+    }
+
+    vertexMap.assign(vertexCount, -1);
+    for (int v = 0; v < vertexCount; v++) {
+        int root = v;
+        while (_collapseTo[root] >= 0) {
+            root = _collapseTo[root];
+        }
+        vertexMap[v] = newIndices[root];
+    }
+}
+
+bool LNLibEx::LNMeshSimplifier::Process(LNLib::LN_Mesh& result, std::vector<int>& vertexMap)
+{
+    if (!Initialize()) {
+        return false;
+    }
+    while (_aliveCount > _targetFaceCount && CollapsePass()) {
+    }
+    Compact(result, vertexMap);
+    return true;
+}
+
+
+const std::vector<int>& LNLibEx::LNMeshSimplifier::GetSourceVertices() const
+{
+    return _sourceVertices;
+}
@@ -0,0 +1,77 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNObject.h"
+#include <array>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Garland-Heckbert quadric error edge collapse.
+	/// 
+	/// Every pass evaluates all edges in parallel, picks cheap collapses whose one-rings do not overlap
+	/// (an independent set, so they never touch the same triangle) and applies them in parallel.
+	/// </summary>
+	class LNMeshSimplifier
+	{
+	private:
+
+		struct Quadric
+		{
+			double A[10] = {};
+		};
+
+		const LNLib::LN_Mesh& _mesh;
+		int _targetFaceCount;
+		double _maxError;
+		bool _keepPositions;
+
+		std::vector<double> _positions;
+		std::vector<Quadric> _quadrics;
+		std::vector<std::array<int, 3>> _triangles;
+		std::vector<char> _isBoundary;
+		std::vector<int> _collapseTo;
+		int _aliveCount = 0;
+		std::vector<int> _sourceVertices;
+
+		std::vector<int> _vertexOffsets;
+		std::vector<int> _vertexTriangles;
+
+	private:
+
+		bool Initialize();
+		void BuildVertexTriangles();
+		bool CollapsePass();
+		void Compact(LNLib::LN_Mesh& result, std::vector<int>& vertexMap);
+
+		void GetNeighbors(int vertex, std::vector<int>& neighbors) const;
+		bool IsCollapseValid(int a, int b, const double* position, std::vector<int>& scratchA, std::vector<int>& scratchB) const;
+		double ComputeCost(int a, int b, double* position) const;
+
+	public:
+
+		/// <summary>
+		/// With keepPositions every collapse moves one endpoint onto the other,
+		/// so result vertices are a subset of input vertices.
+		/// </summary>
+		LNMeshSimplifier(const LNLib::LN_Mesh& mesh, int targetFaceCount, double maxError, bool keepPositions = false);
+
+		/// <summary>
+		/// vertexMap gets the result vertex for every input vertex, -1 for vertices not used by any face.
+		/// </summary>
+		bool Process(LNLib::LN_Mesh& result, std::vector<int>& vertexMap);
+
+		/// <summary>
+		/// Input vertex that each result vertex was collapsed into, valid after Process.
+		/// </summary>
+		const std::vector<int>& GetSourceVertices() const;
+	};
+}
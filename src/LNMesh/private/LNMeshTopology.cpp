@@ -0,0 +1,266 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNMeshTopology.h"
+#include "LNObject.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+    enum class EdgeKind : unsigned char
+    {
+        Boundary = 0,
+        Manifold = 1,
+        Misoriented = 2,
+        NonManifold = 3,
+    };
+}
+
+bool LNLibEx::LNMeshTopology::Build(const LNLib::LN_Mesh& mesh)
+{
+    const int vertexCount = static_cast<int>(mesh.Vertices.size());
+    const int faceCount = static_cast<int>(mesh.Faces.size());
+
+    _vertexCount = 0;
+    _faceOffsets.assign(faceCount + 1, 0);
+    for (int i = 0; i < faceCount; i++) {
+        const std::vector<int>& face = mesh.Faces[i];
+        if (face.size() < 3) {
+            return false;
+        }
+        for (int index : face) {
+            if (index < 0 || index >= vertexCount) {
+                return false;
+            }
+        }
+        _faceOffsets[i + 1] = _faceOffsets[i] + static_cast<int>(face.size());
+    }
+    _vertexCount = vertexCount;
+
+    const int halfEdgeCount = _faceOffsets[faceCount];
+    _origins.resize(halfEdgeCount);
+    _faces.resize(halfEdgeCount);
+    LNParallel::For(0, faceCount, [&](int64_t i) {
+        const std::vector<int>& face = mesh.Faces[i];
+        for (size_t j = 0; j < face.size(); j++) {
+            _origins[_faceOffsets[i] + j] = face[j];
+            _faces[_faceOffsets[i] + j] = static_cast<int>(i);
+        }
+    }, 4096);
+
+    // Bucket half-edges on their smaller vertex (counting sort), then sort every bucket on the larger vertex.
+    std::vector<int> bucketOffsets(vertexCount + 1, 0);
+    for (int i = 0; i < halfEdgeCount; i++) {
+        bucketOffsets[std::min(_origins[i], GetTarget(i)) + 1]++;
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        bucketOffsets[i + 1] += bucketOffsets[i];
+    }
+    _edgeHalfEdges.resize(halfEdgeCount);
+    {
+        std::vector<int> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+        for (int i = 0; i < halfEdgeCount; i++) {
+            _edgeHalfEdges[cursor[std::min(_origins[i], GetTarget(i))]++] = i;
+        }
+    }
+
+    std::vector<int> bucketEdgeCounts(vertexCount + 1, 0);
+    LNParallel::For(0, vertexCount, [&](int64_t v) {
+        auto begin = _edgeHalfEdges.begin() + bucketOffsets[v];
+        auto end = _edgeHalfEdges.begin() + bucketOffsets[v + 1];
+        std::sort(begin, end, [&](int a, int b) {
+            int ta = std::max(_origins[a], GetTarget(a));
+            int tb = std::max(_origins[b], GetTarget(b));
+            return ta < tb || (ta == tb && a < b);
+        });
+        int previous = -1;
+        for (auto it = begin; it != end; ++it) {
+            int other = std::max(_origins[*it], GetTarget(*it));
+            if (other != previous) {
+                bucketEdgeCounts[v + 1]++;
+                previous = other;
+            }
+        }
+    }, 1024);
+    for (int i = 0; i < vertexCount; i++) {
+        bucketEdgeCounts[i + 1] += bucketEdgeCounts[i];
+    }
+
+    const int edgeCount = bucketEdgeCounts[vertexCount];
+    _edges.resize(halfEdgeCount);
+    _edgeOffsets.resize(edgeCount + 1);
+    _edgeOffsets[edgeCount] = halfEdgeCount;
+    LNParallel::For(0, vertexCount, [&](int64_t v) {
+        int edge = bucketEdgeCounts[v] - 1;
+        int previous = -1;
+        for (int k = bucketOffsets[v]; k < bucketOffsets[v + 1]; k++) {
+            int halfEdge = _edgeHalfEdges[k];
+            int other = std::max(_origins[halfEdge], GetTarget(halfEdge));
+            if (other != previous) {
+                _edgeOffsets[++edge] = k;
+                previous = other;
+            }
+            _edges[halfEdge] = edge;
+        }
+    }, 1024);
+
+    std::vector<EdgeKind> kinds(edgeCount);
+    _twins.assign(halfEdgeCount, -1);
+    LNParallel::For(0, edgeCount, [&](int64_t e) {
+        int begin = _edgeOffsets[e];
+        int size = _edgeOffsets[e + 1] - begin;
+        if (size == 1) {
+            kinds[e] = EdgeKind::Boundary;
+        }
+        else if (size == 2) {
+            int first = _edgeHalfEdges[begin];
+            int second = _edgeHalfEdges[begin + 1];
+            if (_origins[first] == GetTarget(second) && _origins[first] != _origins[second]) {
+                _twins[first] = second;
+                _twins[second] = first;
+                kinds[e] = EdgeKind::Manifold;
+            }
+            else {
+                kinds[e] = EdgeKind::Misoriented;
+            }
+        }
+        else {
+            kinds[e] = EdgeKind::NonManifold;
+        }
+    }, 4096);
+
+    _boundaryEdges.clear();
+    _nonManifoldEdges.clear();
+    _misorientedEdges.clear();
+    for (int e = 0; e < edgeCount; e++) {
+        switch (kinds[e]) {
+        case EdgeKind::Boundary:
+            _boundaryEdges.emplace_back(e);
+            break;
+        case EdgeKind::Misoriented:
+            _misorientedEdges.emplace_back(e);
+            break;
+        case EdgeKind::NonManifold:
+            _nonManifoldEdges.emplace_back(e);
+            break;
+        default:
+            break;
+        }
+    }
+
+    _vertexHalfEdges.assign(vertexCount, -1);
+    for (int i = 0; i < halfEdgeCount; i++) {
+        int& outgoing = _vertexHalfEdges[_origins[i]];
+        if (outgoing == -1 || (kinds[_edges[i]] == EdgeKind::Boundary && kinds[_edges[outgoing]] != EdgeKind::Boundary)) {
+            outgoing = i;
+        }
+    }
+    return true;
+}
+
+int LNLibEx::LNMeshTopology::GetVertexCount() const
+{
+    return _vertexCount;
+}
+
+int LNLibEx::LNMeshTopology::GetFaceCount() const
+{
+    return _faceOffsets.empty() ? 0 : static_cast<int>(_faceOffsets.size()) - 1;
+}
+
+int LNLibEx::LNMeshTopology::GetHalfEdgeCount() const
+{
+    return static_cast<int>(_origins.size());
+}
+
+int LNLibEx::LNMeshTopology::GetEdgeCount() const
+{
+    return _edgeOffsets.empty() ? 0 : static_cast<int>(_edgeOffsets.size()) - 1;
+}
+
+int LNLibEx::LNMeshTopology::GetOrigin(int halfEdge) const
+{
+    return _origins[halfEdge];
+}
+
+int LNLibEx::LNMeshTopology::GetTarget(int halfEdge) const
+{
+    return _origins[GetNext(halfEdge)];
+}
+
+int LNLibEx::LNMeshTopology::GetFace(int halfEdge) const
+{
+    return _faces[halfEdge];
+}
+
+int LNLibEx::LNMeshTopology::GetNext(int halfEdge) const
+{
+    int face = _faces[halfEdge];
+    return halfEdge + 1 < _faceOffsets[face + 1] ? halfEdge + 1 : _faceOffsets[face];
+}
+
+int LNLibEx::LNMeshTopology::GetPrevious(int halfEdge) const
+{
+    int face = _faces[halfEdge];
+    return halfEdge > _faceOffsets[face] ? halfEdge - 1 : _faceOffsets[face + 1] - 1;
+}
+
+int LNLibEx::LNMeshTopology::GetTwin(int halfEdge) const
+{
+    return _twins[halfEdge];
+}
+
+int LNLibEx::LNMeshTopology::GetEdge(int halfEdge) const
+{
+    return _edges[halfEdge];
+}
+
+int LNLibEx::LNMeshTopology::GetVertexHalfEdge(int vertex) const
+{
+    return _vertexHalfEdges[vertex];
+}
+
+int LNLibEx::LNMeshTopology::GetFaceHalfEdge(int face) const
+{
+    return _faceOffsets[face];
+}
+
+std::vector<int> LNLibEx::LNMeshTopology::GetEdgeHalfEdges(int edge) const
+{
+    return std::vector<int>(_edgeHalfEdges.begin() + _edgeOffsets[edge], _edgeHalfEdges.begin() + _edgeOffsets[edge + 1]);
+}
+
+const std::vector<int>& LNLibEx::LNMeshTopology::GetBoundaryEdges() const
+{
+    return _boundaryEdges;
+}
+
+const std::vector<int>& LNLibEx::LNMeshTopology::GetNonManifoldEdges() const
+{
+    return _nonManifoldEdges;
+}
+
+const std::vector<int>& LNLibEx::LNMeshTopology::GetMisorientedEdges() const
+{
+    return _misorientedEdges;
+}
+
+bool LNLibEx::LNMeshTopology::IsManifold() const
+{
+    return _nonManifoldEdges.empty();
+}
+
+bool LNLibEx::LNMeshTopology::IsClosed() const
+{
+    return _nonManifoldEdges.empty() && _misorientedEdges.empty() && _boundaryEdges.empty();
+}
@@ -0,0 +1,226 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNNormalGenerator.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double NormalMergeTolerance = 1E-12;
+
+    LNLib::XYZ newellNormal(const LNLib::LN_Mesh& mesh, const std::vector<int>& face) {
+        LNLib::XYZ normal(0, 0, 0);
+        for (size_t i = 0; i < face.size(); i++) {
+            const LNLib::XYZ& current = mesh.Vertices[face[i]];
+            const LNLib::XYZ& next = mesh.Vertices[face[(i + 1) % face.size()]];
+            normal.X() += (current.Y() - next.Y()) * (current.Z() + next.Z());
+            normal.Y() += (current.Z() - next.Z()) * (current.X() + next.X());
+            normal.Z() += (current.X() - next.X()) * (current.Y() + next.Y());
+        }
+        return normal;
+    }
+
+    double cornerAngle(const LNLib::XYZ& previous, const LNLib::XYZ& current, const LNLib::XYZ& next) {
+        LNLib::XYZ a = previous - current;
+        LNLib::XYZ b = next - current;
+        return std::atan2(a.CrossProduct(b).Length(), a.DotProduct(b));
+    }
+}
+
+LNLibEx::LNNormalGenerator::LNNormalGenerator(LNLib::LN_Mesh& mesh, NormalWeighting weighting, double creaseAngle):
+                                                _mesh(mesh), _weighting(weighting), _creaseCos(std::cos(creaseAngle)){}
+
+bool LNLibEx::LNNormalGenerator::BuildCorners()
+{
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+
+    _cornerOffsets.resize(faceCount + 1);
+    _cornerOffsets[0] = 0;
+    for (int i = 0; i < faceCount; i++) {
+        const std::vector<int>& face = _mesh.Faces[i];
+        if (face.size() < 3) {
+            return false;
+        }
+        for (int index : face) {
+            if (index < 0 || index >= vertexCount) {
+                return false;
+            }
+        }
+        _cornerOffsets[i + 1] = _cornerOffsets[i] + static_cast<int>(face.size());
+    }
+
+    _cornerFaces.resize(_cornerOffsets[faceCount]);
+    for (int i = 0; i < faceCount; i++) {
+        std::fill(_cornerFaces.begin() + _cornerOffsets[i], _cornerFaces.begin() + _cornerOffsets[i + 1], i);
+    }
+    return true;
+}
+
+void LNLibEx::LNNormalGenerator::ComputeFaceNormals()
+{
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+    _faceNormals.resize(faceCount);
+    _cornerWeights.resize(_cornerOffsets[faceCount]);
+
+    LNParallel::For(0, faceCount, [&](int64_t i) {
+        const std::vector<int>& face = _mesh.Faces[i];
+        LNLib::XYZ normal = newellNormal(_mesh, face);
+        double doubleArea = normal.Length();
+        bool isDegenerate = doubleArea <= 0.0;
+        _faceNormals[i] = isDegenerate ? LNLib::XYZ(0, 0, 0) : normal / doubleArea;
+
+        const int size = static_cast<int>(face.size());
+        for (int j = 0; j < size; j++) {
+            double weight = 0.0;
+            if (!isDegenerate) {
+                switch (_weighting) {
+                case NormalWeighting::Uniform:
+                    weight = 1.0;
+                    break;
+                case NormalWeighting::Area:
+                    weight = 0.5 * doubleArea;
+                    break;
+                case NormalWeighting::Angle:
+                    weight = cornerAngle(_mesh.Vertices[face[(j + size - 1) % size]],
+                                         _mesh.Vertices[face[j]],
+                                         _mesh.Vertices[face[(j + 1) % size]]);
+                    break;
+                }
+            }
+            _cornerWeights[_cornerOffsets[i] + j] = weight;
+        }
+    }, 512);
+}
+
+void LNLibEx::LNNormalGenerator::BuildVertexCorners()
+{
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+
+    _vertexOffsets.assign(vertexCount + 1, 0);
+    for (const auto& face : _mesh.Faces) {
+        for (int index : face) {
+            _vertexOffsets[index + 1]++;
+        }
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        _vertexOffsets[i + 1] += _vertexOffsets[i];
+    }
+
+    std::vector<int> cursor(_vertexOffsets.begin(), _vertexOffsets.end() - 1);
+    _vertexCorners.resize(_cornerOffsets[faceCount]);
+    for (int i = 0; i < faceCount; i++) {
+        const std::vector<int>& face = _mesh.Faces[i];
+        for (size_t j = 0; j < face.size(); j++) {
+            _vertexCorners[cursor[face[j]]++] = _cornerOffsets[i] + static_cast<int>(j);
+        }
+    }
+}
+
+void LNLibEx::LNNormalGenerator::GatherVertexNormals()
+{
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    const int cornerCount = static_cast<int>(_vertexCorners.size());
+    const bool isSmooth = _creaseCos <= -1.0;
+
+    std::vector<LNLib::XYZ> cornerNormals(cornerCount);
+    std::vector<int> cornerGroups(cornerCount, 0);
+    std::vector<int> groupOffsets(vertexCount + 1, 0);
+
+    // First pass: every vertex gathers from its own incident corners only, no shared writes.
+    LNParallel::For(0, vertexCount, [&](int64_t v) {
+        const int begin = _vertexOffsets[v];
+        const int end = _vertexOffsets[v + 1];
+        if (begin == end) {
+            return;
+        }
+
+        if (isSmooth) {
+            LNLib::XYZ normal(0, 0, 0);
+            for (int k = begin; k < end; k++) {
+                int corner = _vertexCorners[k];
+                normal += _faceNormals[_cornerFaces[corner]] * _cornerWeights[corner];
+            }
+            cornerNormals[_vertexCorners[begin]] = normal.IsZero(0.0) ? normal : normal.Normalize();
+            for (int k = begin; k < end; k++) {
+                cornerGroups[_vertexCorners[k]] = 0;
+            }
+            groupOffsets[v + 1] = 1;
+            return;
+        }
+
+        int groups = 0;
+        for (int k = begin; k < end; k++) {
+            int corner = _vertexCorners[k];
+            const LNLib::XYZ& faceNormal = _faceNormals[_cornerFaces[corner]];
+            LNLib::XYZ normal(0, 0, 0);
+            for (int l = begin; l < end; l++) {
+                int other = _vertexCorners[l];
+                const LNLib::XYZ& otherNormal = _faceNormals[_cornerFaces[other]];
+                if (other == corner || faceNormal.DotProduct(otherNormal) >= _creaseCos) {
+                    normal += otherNormal * _cornerWeights[other];
+                }
+            }
+            if (!normal.IsZero(0.0)) {
+                normal.Normalize();
+            }
+
+            int group = groups;
+            for (int l = begin; l < k; l++) {
+                int other = _vertexCorners[l];
+                if ((cornerNormals[other] - normal).SqrLength() <= NormalMergeTolerance) {
+                    group = cornerGroups[other];
+                    break;
+                }
+            }
+            if (group == groups) {
+                groups++;
+            }
+            cornerNormals[corner] = normal;
+            cornerGroups[corner] = group;
+        }
+        groupOffsets[v + 1] = groups;
+    }, 256);
+
+    for (int i = 0; i < vertexCount; i++) {
+        groupOffsets[i + 1] += groupOffsets[i];
+    }
+
+    // Second pass: every vertex writes its own contiguous slot range.
+    _mesh.Normals.assign(groupOffsets[vertexCount], LNLib::XYZ(0, 0, 0));
+    _mesh.NormalIndices.assign(cornerCount, 0);
+    LNParallel::For(0, vertexCount, [&](int64_t v) {
+        for (int k = _vertexOffsets[v]; k < _vertexOffsets[v + 1]; k++) {
+            int corner = _vertexCorners[k];
+            int slot = groupOffsets[v] + cornerGroups[corner];
+            if (!isSmooth || k == _vertexOffsets[v]) {
+                _mesh.Normals[slot] = cornerNormals[corner];
+            }
+            _mesh.NormalIndices[corner] = slot;
+        }
+    }, 1024);
+}
+
+bool LNLibEx::LNNormalGenerator::Process()
+{
+    if (!BuildCorners()) {
+        return false;
+    }
+    ComputeFaceNormals();
+    BuildVertexCorners();
+    GatherVertexNormals();
+    return true;
+}
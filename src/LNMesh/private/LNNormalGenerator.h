@@ -0,0 +1,45 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNObject.h"
+#include "LNMeshEnums.h"
+#include "XYZ.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	class LNNormalGenerator
+	{
+	private:
+
+		LNLib::LN_Mesh& _mesh;
+		NormalWeighting _weighting;
+		double _creaseCos;
+
+		std::vector<int> _cornerOffsets;
+		std::vector<LNLib::XYZ> _faceNormals;
+		std::vector<double> _cornerWeights;
+		std::vector<int> _vertexOffsets;
+		std::vector<int> _vertexCorners;
+		std::vector<int> _cornerFaces;
+
+	private:
+
+		bool BuildCorners();
+		void ComputeFaceNormals();
+		void BuildVertexCorners();
+		void GatherVertexNormals();
+
+	public:
+
+		LNNormalGenerator(LNLib::LN_Mesh& mesh, NormalWeighting weighting, double creaseAngle);
+		bool Process();
+	};
+}
@@ -0,0 +1,152 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNSpatialSorter.h"
+#include "LNMeshReorder.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    const int KeyBits = 21;
+    const uint32_t KeyMaximum = (1u << KeyBits) - 1;
+
+    uint64_t spreadBits(uint32_t value) {
+        uint64_t x = value & KeyMaximum;
+        x = (x | x << 32) & 0x1F00000000FFFFull;
+        x = (x | x << 16) & 0x1F0000FF0000FFull;
+        x = (x | x << 8) & 0x100F00F00F00F00Full;
+        x = (x | x << 4) & 0x10C30C30C30C30C3ull;
+        x = (x | x << 2) & 0x1249249249249249ull;
+        return x;
+    }
+
+    uint64_t interleave(const uint32_t* axes) {
+        return spreadBits(axes[0]) << 2 | spreadBits(axes[1]) << 1 | spreadBits(axes[2]);
+    }
+
+    // John Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707, 2004.
+    void axesToTranspose(uint32_t* axes) {
+        for (uint32_t q = 1u << (KeyBits - 1); q > 1; q >>= 1) {
+            uint32_t p = q - 1;
+            for (int i = 0; i < 3; i++) {
+                if (axes[i] & q) {
+                    axes[0] ^= p;
+                }
+                else {
+                    uint32_t t = (axes[0] ^ axes[i]) & p;
+                    axes[0] ^= t;
+                    axes[i] ^= t;
+                }
+            }
+        }
+        for (int i = 1; i < 3; i++) {
+            axes[i] ^= axes[i - 1];
+        }
+        uint32_t t = 0;
+        for (uint32_t q = 1u << (KeyBits - 1); q > 1; q >>= 1) {
+            if (axes[2] & q) {
+                t ^= q - 1;
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            axes[i] ^= t;
+        }
+    }
+}
+
+LNLibEx::LNSpatialSorter::LNSpatialSorter(LNLib::LN_Mesh& mesh, SpaceFillingCurve curve):
+                                                _mesh(mesh), _curve(curve){}
+
+void LNLibEx::LNSpatialSorter::ComputeBounds()
+{
+    double minimum[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+    double maximum[3] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+    for (const auto& vertex : _mesh.Vertices) {
+        for (int i = 0; i < 3; i++) {
+            minimum[i] = std::min(minimum[i], vertex[i]);
+            maximum[i] = std::max(maximum[i], vertex[i]);
+        }
+    }
+
+    // One scale for all axes keeps the cells cubic.
+    double extent = 0.0;
+    for (int i = 0; i < 3; i++) {
+        extent = std::max(extent, maximum[i] - minimum[i]);
+    }
+    _minimum = LNLib::XYZ(minimum[0], minimum[1], minimum[2]);
+    _scale = extent > 0.0 ? KeyMaximum / extent : 0.0;
+}
+
+uint64_t LNLibEx::LNSpatialSorter::ComputeKey(const LNLib::XYZ& point) const
+{
+    uint32_t axes[3];
+    for (int i = 0; i < 3; i++) {
+        double value = (point[i] - _minimum[i]) * _scale;
+        axes[i] = static_cast<uint32_t>(std::min(std::max(value, 0.0), static_cast<double>(KeyMaximum)));
+    }
+    if (_curve == SpaceFillingCurve::Hilbert) {
+        axesToTranspose(axes);
+    }
+    return interleave(axes);
+}
+
+std::vector<int> LNLibEx::LNSpatialSorter::SortByKeys(const std::vector<uint64_t>& keys) const
+{
+    std::vector<int> order(keys.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<int>(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b] || (keys[a] == keys[b] && a < b); });
+    return order;
+}
+
+bool LNLibEx::LNSpatialSorter::Process()
+{
+    if (!LNMeshReorder::Validate(_mesh)) {
+        return false;
+    }
+    for (const auto& face : _mesh.Faces) {
+        if (face.empty()) {
+            return false;
+        }
+    }
+    ComputeBounds();
+
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    std::vector<uint64_t> keys(vertexCount);
+    LNParallel::For(0, vertexCount, [&](int64_t i) {
+        keys[i] = ComputeKey(_mesh.Vertices[i]);
+    });
+    std::vector<int> order = SortByKeys(keys);
+    std::vector<int> newIndices(vertexCount);
+    for (int i = 0; i < vertexCount; i++) {
+        newIndices[order[i]] = i;
+    }
+    LNMeshReorder::PermuteVertices(_mesh, newIndices);
+
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+    keys.resize(faceCount);
+    LNParallel::For(0, faceCount, [&](int64_t i) {
+        const std::vector<int>& face = _mesh.Faces[i];
+        LNLib::XYZ centroid(0, 0, 0);
+        for (int v : face) {
+            centroid += _mesh.Vertices[v];
+        }
+        keys[i] = ComputeKey(centroid / static_cast<double>(face.size()));
+    });
+    LNMeshReorder::PermuteFaces(_mesh, SortByKeys(keys));
+    LNMeshReorder::OrderAttributesByFirstUse(_mesh);
+    return true;
+}
@@ -0,0 +1,44 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNObject.h"
+#include "LNMeshEnums.h"
+#include "XYZ.h"
+#include <cstdint>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Sort vertices by their position and faces by their centroid along a space-filling curve.
+	/// Coordinates are quantized to 21 bits per axis inside the bounding box, giving 63-bit curve keys.
+	/// </summary>
+	class LNSpatialSorter
+	{
+	private:
+
+		LNLib::LN_Mesh& _mesh;
+		SpaceFillingCurve _curve;
+
+		LNLib::XYZ _minimum;
+		double _scale = 0.0;
+
+	private:
+
+		void ComputeBounds();
+		uint64_t ComputeKey(const LNLib::XYZ& point) const;
+		std::vector<int> SortByKeys(const std::vector<uint64_t>& keys) const;
+
+	public:
+
+		LNSpatialSorter(LNLib::LN_Mesh& mesh, SpaceFillingCurve curve);
+		bool Process();
+	};
+}
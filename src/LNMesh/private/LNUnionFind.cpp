@@ -0,0 +1,72 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNUnionFind.h"
+#include "LNParallel.h"
+
+#include <utility>
+
+LNLibEx::LNUnionFind::LNUnionFind(int count):_parents(count)
+{
+    LNParallel::For(0, count, [&](int64_t i) {
+        _parents[i].store(static_cast<int>(i), std::memory_order_relaxed);
+    }, 1 << 16);
+}
+
+int LNLibEx::LNUnionFind::Find(int element)
+{
+    int current = element;
+    while (true) {
+        int parent = _parents[current].load(std::memory_order_acquire);
+        if (parent == current) {
+            return current;
+        }
+        int grandParent = _parents[parent].load(std::memory_order_acquire);
+        if (parent != grandParent) {
+            _parents[current].compare_exchange_weak(parent, grandParent, std::memory_order_acq_rel);
+        }
+        current = grandParent;
+    }
+}
+
+void LNLibEx::LNUnionFind::Unite(int a, int b)
+{
+    while (true) {
+        a = Find(a);
+        b = Find(b);
+        if (a == b) {
+            return;
+        }
+        if (a < b) {
+            std::swap(a, b);
+        }
+        // a may have been linked by another thread since Find, then retry.
+        int expected = a;
+        if (_parents[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+}
+
+int LNLibEx::LNUnionFind::GetLabels(std::vector<int>& labels)
+{
+    const int count = static_cast<int>(_parents.size());
+    labels.resize(count);
+    LNParallel::For(0, count, [&](int64_t i) {
+        labels[i] = Find(static_cast<int>(i));
+    }, 1 << 14);
+
+    // Roots are the smallest element of their set, so a forward pass numbers sets in order.
+    int setCount = 0;
+    for (int i = 0; i < count; i++) {
+        labels[i] = labels[i] == i ? setCount++ : labels[labels[i]];
+    }
+    return setCount;
+}
@@ -0,0 +1,41 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include <atomic>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Lock-free disjoint sets, Unite and Find may be called from many threads at once.
+	/// 
+	/// Roots are linked by compare-and-swap, always the larger root under the smaller one,
+	/// and Find halves paths as it walks so later queries stay short.
+	/// </summary>
+	class LNUnionFind
+	{
+	private:
+
+		std::vector<std::atomic<int>> _parents;
+
+	public:
+
+		explicit LNUnionFind(int count);
+
+		int Find(int element);
+		void Unite(int a, int b);
+
+		/// <summary>
+		/// Label every element with its set, sets numbered 0, 1, ... in order of their smallest element.
+		/// Return the number of sets. Call after all Unite calls have finished.
+		/// </summary>
+		int GetLabels(std::vector<int>& labels);
+	};
+}
@@ -0,0 +1,495 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNVertexArray.h"
+#include "XYZ.h"
+#include "Matrix4d.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #include <immintrin.h>
+    #define LNMESH_VERTEX_X86
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define LNMESH_TARGET(isa)
+    #else
+        #define LNMESH_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+namespace
+{
+    const size_t Alignment = 64;
+    const size_t AlignmentCount = Alignment / sizeof(double);
+    const int64_t Grain = 1 << 16;
+
+    enum class SimdLevel
+    {
+        Scalar,
+        AVX2,
+        AVX512,
+    };
+
+    SimdLevel detectSimdLevel() {
+#if defined(LNMESH_VERTEX_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return SimdLevel::Scalar;
+        }
+        __cpuid(info, 1);
+        bool hasFMA = (info[2] & (1 << 12)) != 0;
+        bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+        if (!hasOSXSave) {
+            return SimdLevel::Scalar;
+        }
+        unsigned long long xcr0 = _xgetbv(0);
+        __cpuidex(info, 7, 0);
+        bool hasAVX2 = hasFMA && (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+        bool hasAVX512 = hasAVX2 && (info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6;
+        return hasAVX512 ? SimdLevel::AVX512 : (hasAVX2 ? SimdLevel::AVX2 : SimdLevel::Scalar);
+#elif defined(LNMESH_VERTEX_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::Scalar;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    SimdLevel getSimdLevel() {
+        static const SimdLevel level = detectSimdLevel();
+        return level;
+    }
+
+    struct Bounds
+    {
+        double Minimum[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+        double Maximum[3] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+    };
+
+    // Row-major 4x4 matrix, point is a column vector.
+    void transformScalar(double* x, double* y, double* z, int64_t begin, int64_t end, const double* m, bool isAffine) {
+        for (int64_t i = begin; i < end; i++) {
+            double px = x[i];
+            double py = y[i];
+            double pz = z[i];
+            double rx = m[0] * px + m[1] * py + m[2] * pz + m[3];
+            double ry = m[4] * px + m[5] * py + m[6] * pz + m[7];
+            double rz = m[8] * px + m[9] * py + m[10] * pz + m[11];
+            if (!isAffine) {
+                double w = m[12] * px + m[13] * py + m[14] * pz + m[15];
+                rx /= w;
+                ry /= w;
+                rz /= w;
+            }
+            x[i] = rx;
+            y[i] = ry;
+            z[i] = rz;
+        }
+    }
+
+    void boundsScalar(const double* const* axes, int64_t begin, int64_t end, Bounds& bounds) {
+        for (int axis = 0; axis < 3; axis++) {
+            const double* values = axes[axis];
+            for (int64_t i = begin; i < end; i++) {
+                bounds.Minimum[axis] = std::min(bounds.Minimum[axis], values[i]);
+                bounds.Maximum[axis] = std::max(bounds.Maximum[axis], values[i]);
+            }
+        }
+    }
+
+    void sumScalar(const double* const* axes, int64_t begin, int64_t end, double* sums) {
+        for (int axis = 0; axis < 3; axis++) {
+            const double* values = axes[axis];
+            double sum = 0.0;
+            for (int64_t i = begin; i < end; i++) {
+                sum += values[i];
+            }
+            sums[axis] += sum;
+        }
+    }
+
+#if defined(LNMESH_VERTEX_X86)
+    LNMESH_TARGET("avx2,fma")
+    void transformAVX2(double* x, double* y, double* z, int64_t begin, int64_t end, const double* m, bool isAffine) {
+        __m256d c[16];
+        for (int k = 0; k < 16; k++) {
+            c[k] = _mm256_set1_pd(m[k]);
+        }
+        int64_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m256d px = _mm256_loadu_pd(x + i);
+            __m256d py = _mm256_loadu_pd(y + i);
+            __m256d pz = _mm256_loadu_pd(z + i);
+            __m256d rx = _mm256_fmadd_pd(c[0], px, _mm256_fmadd_pd(c[1], py, _mm256_fmadd_pd(c[2], pz, c[3])));
+            __m256d ry = _mm256_fmadd_pd(c[4], px, _mm256_fmadd_pd(c[5], py, _mm256_fmadd_pd(c[6], pz, c[7])));
+            __m256d rz = _mm256_fmadd_pd(c[8], px, _mm256_fmadd_pd(c[9], py, _mm256_fmadd_pd(c[10], pz, c[11])));
+            if (!isAffine) {
+                __m256d w = _mm256_fmadd_pd(c[12], px, _mm256_fmadd_pd(c[13], py, _mm256_fmadd_pd(c[14], pz, c[15])));
+                rx = _mm256_div_pd(rx, w);
+                ry = _mm256_div_pd(ry, w);
+                rz = _mm256_div_pd(rz, w);
+            }
+            _mm256_storeu_pd(x + i, rx);
+            _mm256_storeu_pd(y + i, ry);
+            _mm256_storeu_pd(z + i, rz);
+        }
+        transformScalar(x, y, z, i, end, m, isAffine);
+    }
+
+    LNMESH_TARGET("avx2")
+    void boundsAVX2(const double* const* axes, int64_t begin, int64_t end, Bounds& bounds) {
+        int64_t last = begin + (end - begin) / 4 * 4;
+        for (int axis = 0; axis < 3; axis++) {
+            const double* values = axes[axis];
+            __m256d minimum = _mm256_set1_pd(bounds.Minimum[axis]);
+            __m256d maximum = _mm256_set1_pd(bounds.Maximum[axis]);
+            for (int64_t i = begin; i < last; i += 4) {
+                __m256d v = _mm256_loadu_pd(values + i);
+                minimum = _mm256_min_pd(minimum, v);
+                maximum = _mm256_max_pd(maximum, v);
+            }
+            alignas(32) double lanes[8];
+            _mm256_store_pd(lanes, minimum);
+            _mm256_store_pd(lanes + 4, maximum);
+            for (int k = 0; k < 4; k++) {
+                bounds.Minimum[axis] = std::min(bounds.Minimum[axis], lanes[k]);
+                bounds.Maximum[axis] = std::max(bounds.Maximum[axis], lanes[4 + k]);
+            }
+        }
+        boundsScalar(axes, last, end, bounds);
+    }
+
+    LNMESH_TARGET("avx2")
+    void sumAVX2(const double* const* axes, int64_t begin, int64_t end, double* sums) {
+        int64_t last = begin + (end - begin) / 4 * 4;
+        for (int axis = 0; axis < 3; axis++) {
+            const double* values = axes[axis];
+            __m256d sum = _mm256_setzero_pd();
+            for (int64_t i = begin; i < last; i += 4) {
+                sum = _mm256_add_pd(sum, _mm256_loadu_pd(values + i));
+            }
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, sum);
+            sums[axis] += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+        sumScalar(axes, last, end, sums);
+    }
+
+    LNMESH_TARGET("avx512f")
+    void transformAVX512(double* x, double* y, double* z, int64_t begin, int64_t end, const double* m, bool isAffine) {
+        __m512d c[16];
+        for (int k = 0; k < 16; k++) {
+            c[k] = _mm512_set1_pd(m[k]);
+        }
+        for (int64_t i = begin; i < end; i += 8) {
+            __mmask8 mask = end - i >= 8 ? static_cast<__mmask8>(0xFF) : static_cast<__mmask8>((1u << (end - i)) - 1);
+            __m512d px = _mm512_maskz_loadu_pd(mask, x + i);
+            __m512d py = _mm512_maskz_loadu_pd(mask, y + i);
+            __m512d pz = _mm512_maskz_loadu_pd(mask, z + i);
+            __m512d rx = _mm512_fmadd_pd(c[0], px, _mm512_fmadd_pd(c[1], py, _mm512_fmadd_pd(c[2], pz, c[3])));
+            __m512d ry = _mm512_fmadd_pd(c[4], px, _mm512_fmadd_pd(c[5], py, _mm512_fmadd_pd(c[6], pz, c[7])));
+            __m512d rz = _mm512_fmadd_pd(c[8], px, _mm512_fmadd_pd(c[9], py, _mm512_fmadd_pd(c[10], pz, c[11])));
+            if (!isAffine) {
+                __m512d w = _mm512_fmadd_pd(c[12], px, _mm512_fmadd_pd(c[13], py, _mm512_fmadd_pd(c[14], pz, c[15])));
+                rx = _mm512_div_pd(rx, w);
+                ry = _mm512_div_pd(ry, w);
+                rz = _mm512_div_pd(rz, w);
+            }
+            _mm512_mask_storeu_pd(x + i, mask, rx);
+            _mm512_mask_storeu_pd(y + i, mask, ry);
+            _mm512_mask_storeu_pd(z + i, mask, rz);
+        }
+    }
+
+    LNMESH_TARGET("avx512f")
+    void boundsAVX512(const double* const* axes, int64_t begin, int64_t end, Bounds& bounds) {
+        int64_t last = begin + (end - begin) / 8 * 8;
+        for (int axis = 0; axis < 3; axis++) {
+            const double* values = axes[axis];
+            __m512d minimum = _mm512_set1_pd(bounds.Minimum[axis]);
+            __m512d maximum = _mm512_set1_pd(bounds.Maximum[axis]);
+            for (int64_t i = begin; i < last; i += 8) {
+                __m512d v = _mm512_loadu_pd(values + i);
+                minimum = _mm512_min_pd(minimum, v);
+                maximum = _mm512_max_pd(maximum, v);
+            }
+            bounds.Minimum[axis] = std::min(bounds.Minimum[axis], _mm512_reduce_min_pd(minimum));
+            bounds.Maximum[axis] = std::max(bounds.Maximum[axis], _mm512_reduce_max_pd(maximum));
+        }
+        boundsScalar(axes, last, end, bounds);
+    }
+
+    LNMESH_TARGET("avx512f")
+    void sumAVX512(const double* const* axes, int64_t begin, int64_t end, double* sums) {
+        for (int axis = 0; axis < 3; axis++) {
+            const double* values = axes[axis];
+            __m512d sum = _mm512_setzero_pd();
+            for (int64_t i = begin; i < end; i += 8) {
+                __mmask8 mask = end - i >= 8 ? static_cast<__mmask8>(0xFF) : static_cast<__mmask8>((1u << (end - i)) - 1);
+                sum = _mm512_add_pd(sum, _mm512_maskz_loadu_pd(mask, values + i));
+            }
+            sums[axis] += _mm512_reduce_add_pd(sum);
+        }
+    }
+#endif
+
+    void transform(double* x, double* y, double* z, int64_t begin, int64_t end, const double* m, bool isAffine) {
+#if defined(LNMESH_VERTEX_X86)
+        switch (getSimdLevel()) {
+        case SimdLevel::AVX512:
+            transformAVX512(x, y, z, begin, end, m, isAffine);
+            return;
+        case SimdLevel::AVX2:
+            transformAVX2(x, y, z, begin, end, m, isAffine);
+            return;
+        default:
+            break;
+        }
+#endif
+        transformScalar(x, y, z, begin, end, m, isAffine);
+    }
+
+    void computeBounds(const double* const* axes, int64_t begin, int64_t end, Bounds& bounds) {
+#if defined(LNMESH_VERTEX_X86)
+        switch (getSimdLevel()) {
+        case SimdLevel::AVX512:
+            boundsAVX512(axes, begin, end, bounds);
+            return;
+        case SimdLevel::AVX2:
+            boundsAVX2(axes, begin, end, bounds);
+            return;
+        default:
+            break;
+        }
+#endif
+        boundsScalar(axes, begin, end, bounds);
+    }
+
+    void computeSums(const double* const* axes, int64_t begin, int64_t end, double* sums) {
+#if defined(LNMESH_VERTEX_X86)
+        switch (getSimdLevel()) {
+        case SimdLevel::AVX512:
+            sumAVX512(axes, begin, end, sums);
+            return;
+        case SimdLevel::AVX2:
+            sumAVX2(axes, begin, end, sums);
+            return;
+        default:
+            break;
+        }
+#endif
+        sumScalar(axes, begin, end, sums);
+    }
+}
+
+LNLibEx::LNVertexArray::LNVertexArray()
+{
+}
+
+LNLibEx::LNVertexArray::LNVertexArray(const std::vector<LNLib::XYZ>& vertices)
+{
+    Assign(vertices);
+}
+
+LNLibEx::LNVertexArray::LNVertexArray(const LNVertexArray& other)
+{
+    *this = other;
+}
+
+LNLibEx::LNVertexArray::LNVertexArray(LNVertexArray&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+LNLibEx::LNVertexArray& LNLibEx::LNVertexArray::operator=(const LNVertexArray& other)
+{
+    if (this != &other) {
+        Allocate(other._count);
+        if (_data) {
+            std::memcpy(_data, other._data, 3 * _stride * sizeof(double));
+        }
+    }
+    return *this;
+}
+
+LNLibEx::LNVertexArray& LNLibEx::LNVertexArray::operator=(LNVertexArray&& other) noexcept
+{
+    if (this != &other) {
+        Release();
+        std::swap(_data, other._data);
+        std::swap(_count, other._count);
+        std::swap(_stride, other._stride);
+    }
+    return *this;
+}
+
+LNLibEx::LNVertexArray::~LNVertexArray()
+{
+    Release();
+}
+
+void LNLibEx::LNVertexArray::Allocate(int count)
+{
+    Release();
+    if (count <= 0) {
+        return;
+    }
+    // Every axis starts on an alignment boundary and is padded with zeros up to the next one.
+    _count = count;
+    _stride = (static_cast<size_t>(count) + AlignmentCount - 1) / AlignmentCount * AlignmentCount;
+    _data = static_cast<double*>(::operator new(3 * _stride * sizeof(double), std::align_val_t(Alignment)));
+    std::memset(_data, 0, 3 * _stride * sizeof(double));
+}
+
+void LNLibEx::LNVertexArray::Release()
+{
+    if (_data) {
+        ::operator delete(_data, std::align_val_t(Alignment));
+    }
+    _data = nullptr;
+    _count = 0;
+    _stride = 0;
+}
+
+void LNLibEx::LNVertexArray::Assign(const std::vector<LNLib::XYZ>& vertices)
+{
+    Allocate(static_cast<int>(vertices.size()));
+    double* x = X();
+    double* y = Y();
+    double* z = Z();
+    LNParallel::ForEachChunk(0, _count, Grain, [&](int, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+            x[i] = vertices[i].GetX();
+            y[i] = vertices[i].GetY();
+            z[i] = vertices[i].GetZ();
+        }
+    });
+}
+
+void LNLibEx::LNVertexArray::CopyTo(std::vector<LNLib::XYZ>& vertices) const
+{
+    vertices.resize(_count);
+    const double* x = X();
+    const double* y = Y();
+    const double* z = Z();
+    LNParallel::ForEachChunk(0, _count, Grain, [&](int, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+            vertices[i] = LNLib::XYZ(x[i], y[i], z[i]);
+        }
+    });
+}
+
+int LNLibEx::LNVertexArray::GetCount() const
+{
+    return _count;
+}
+
+double* LNLibEx::LNVertexArray::X()
+{
+    return _data;
+}
+
+double* LNLibEx::LNVertexArray::Y()
+{
+    return _data ? _data + _stride : nullptr;
+}
+
+double* LNLibEx::LNVertexArray::Z()
+{
+    return _data ? _data + 2 * _stride : nullptr;
+}
+
+const double* LNLibEx::LNVertexArray::X() const
+{
+    return _data;
+}
+
+const double* LNLibEx::LNVertexArray::Y() const
+{
+    return _data ? _data + _stride : nullptr;
+}
+
+const double* LNLibEx::LNVertexArray::Z() const
+{
+    return _data ? _data + 2 * _stride : nullptr;
+}
+
+void LNLibEx::LNVertexArray::Transform(const LNLib::Matrix4d& matrix)
+{
+    double m[16];
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) {
+            m[4 * row + column] = matrix.GetElement(row, column);
+        }
+    }
+    const bool isAffine = m[12] == 0.0 && m[13] == 0.0 && m[14] == 0.0 && m[15] == 1.0;
+
+    double* x = X();
+    double* y = Y();
+    double* z = Z();
+    LNParallel::ForEachChunk(0, _count, Grain, [&](int, int64_t begin, int64_t end) {
+        transform(x, y, z, begin, end, m, isAffine);
+    });
+}
+
+bool LNLibEx::LNVertexArray::GetBounds(LNLib::XYZ& minimum, LNLib::XYZ& maximum) const
+{
+    if (_count == 0) {
+        return false;
+    }
+
+    const double* axes[3] = { X(), Y(), Z() };
+    std::vector<Bounds> chunkBounds(LNParallel::GetChunkCount(0, _count, Grain));
+    LNParallel::ForEachChunk(0, _count, Grain, [&](int chunk, int64_t begin, int64_t end) {
+        computeBounds(axes, begin, end, chunkBounds[chunk]);
+    });
+
+    Bounds bounds;
+    for (const Bounds& chunk : chunkBounds) {
+        for (int axis = 0; axis < 3; axis++) {
+            bounds.Minimum[axis] = std::min(bounds.Minimum[axis], chunk.Minimum[axis]);
+            bounds.Maximum[axis] = std::max(bounds.Maximum[axis], chunk.Maximum[axis]);
+        }
+    }
+    minimum = LNLib::XYZ(bounds.Minimum[0], bounds.Minimum[1], bounds.Minimum[2]);
+    maximum = LNLib::XYZ(bounds.Maximum[0], bounds.Maximum[1], bounds.Maximum[2]);
+    return true;
+}
+
+LNLib::XYZ LNLibEx::LNVertexArray::GetCentroid() const
+{
+    if (_count == 0) {
+        return LNLib::XYZ(0, 0, 0);
+    }
+
+    const double* axes[3] = { X(), Y(), Z() };
+    std::vector<double> chunkSums(3 * static_cast<size_t>(LNParallel::GetChunkCount(0, _count, Grain)), 0.0);
+    LNParallel::ForEachChunk(0, _count, Grain, [&](int chunk, int64_t begin, int64_t end) {
+        computeSums(axes, begin, end, &chunkSums[3 * static_cast<size_t>(chunk)]);
+    });
+
+    double sums[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < chunkSums.size(); i++) {
+        sums[i % 3] += chunkSums[i];
+    }
+    return LNLib::XYZ(sums[0] / _count, sums[1] / _count, sums[2] / _count);
+}
@@ -0,0 +1,191 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNVertexCacheOptimizer.h"
+#include "LNMeshReorder.h"
+#include "LNObject.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const float CacheDecayPower = 1.5f;
+    const float LastFaceScore = 0.75f;
+    const float ValenceBoostScale = 2.0f;
+    const float ValenceBoostPower = 0.5f;
+    const int MinCacheSize = 4;
+
+    /// Degenerate faces may list a vertex more than once, only its first corner counts.
+    bool isRepeated(const std::vector<int>& face, size_t corner)
+    {
+        return std::find(face.begin(), face.begin() + corner, face[corner]) != face.begin() + corner;
+    }
+}
+
+LNLibEx::LNVertexCacheOptimizer::LNVertexCacheOptimizer(LNLib::LN_Mesh& mesh, int cacheSize):
+                                                _mesh(mesh), _cacheSize(std::max(cacheSize, MinCacheSize)){}
+
+void LNLibEx::LNVertexCacheOptimizer::BuildVertexFaces()
+{
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+
+    _vertexOffsets.assign(vertexCount + 1, 0);
+    for (const auto& face : _mesh.Faces) {
+        for (size_t i = 0; i < face.size(); i++) {
+            if (!isRepeated(face, i)) {
+                _vertexOffsets[face[i] + 1]++;
+            }
+        }
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        _vertexOffsets[i + 1] += _vertexOffsets[i];
+    }
+
+    _activeCounts.assign(vertexCount, 0);
+    _vertexFaces.resize(_vertexOffsets[vertexCount]);
+    for (int i = 0; i < faceCount; i++) {
+        const std::vector<int>& face = _mesh.Faces[i];
+        for (size_t j = 0; j < face.size(); j++) {
+            if (!isRepeated(face, j)) {
+                _vertexFaces[_vertexOffsets[face[j]] + _activeCounts[face[j]]++] = i;
+            }
+        }
+    }
+}
+
+float LNLibEx::LNVertexCacheOptimizer::ComputeVertexScore(int vertex) const
+{
+    const int activeCount = _activeCounts[vertex];
+    if (activeCount == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    const int position = _cachePositions[vertex];
+    if (position >= 0) {
+        if (position < 3) {
+            score = LastFaceScore;
+        }
+        else {
+            float scaler = 1.0f / static_cast<float>(_cacheSize - 3);
+            score = std::pow(1.0f - static_cast<float>(position - 3) * scaler, CacheDecayPower);
+        }
+    }
+    return score + ValenceBoostScale * std::pow(static_cast<float>(activeCount), -ValenceBoostPower);
+}
+
+void LNLibEx::LNVertexCacheOptimizer::BuildFaceOrder(std::vector<int>& order)
+{
+    const int vertexCount = static_cast<int>(_mesh.Vertices.size());
+    const int faceCount = static_cast<int>(_mesh.Faces.size());
+
+    _cachePositions.assign(vertexCount, -1);
+    _vertexScores.resize(vertexCount);
+    for (int i = 0; i < vertexCount; i++) {
+        _vertexScores[i] = ComputeVertexScore(i);
+    }
+
+    std::vector<char> isEmitted(faceCount, 0);
+    std::vector<int> cache;
+    std::vector<int> nextCache;
+    order.clear();
+    order.reserve(faceCount);
+
+    int cursor = 0;
+    int best = -1;
+    while (static_cast<int>(order.size()) < faceCount) {
+        // Nothing adjacent to the cache is left, restart from the first face not emitted yet.
+        if (best < 0) {
+            while (isEmitted[cursor]) {
+                cursor++;
+            }
+            best = cursor;
+        }
+
+        isEmitted[best] = 1;
+        order.emplace_back(best);
+        const std::vector<int>& face = _mesh.Faces[best];
+        for (size_t i = 0; i < face.size(); i++) {
+            if (isRepeated(face, i)) {
+                continue;
+            }
+            int v = face[i];
+            int* faces = _vertexFaces.data() + _vertexOffsets[v];
+            int last = --_activeCounts[v];
+            for (int k = 0; k <= last; k++) {
+                if (faces[k] == best) {
+                    std::swap(faces[k], faces[last]);
+                    break;
+                }
+            }
+        }
+
+        nextCache.clear();
+        for (int v : face) {
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) {
+                nextCache.emplace_back(v);
+            }
+        }
+        for (int v : cache) {
+            if (std::find(face.begin(), face.end(), v) == face.end()) {
+                nextCache.emplace_back(v);
+            }
+        }
+        for (size_t i = 0; i < nextCache.size(); i++) {
+            _cachePositions[nextCache[i]] = i < static_cast<size_t>(_cacheSize) ? static_cast<int>(i) : -1;
+        }
+        for (int v : nextCache) {
+            _vertexScores[v] = ComputeVertexScore(v);
+        }
+
+        best = -1;
+        float bestScore = -1.0f;
+        for (int v : nextCache) {
+            for (int k = _vertexOffsets[v]; k < _vertexOffsets[v] + _activeCounts[v]; k++) {
+                int f = _vertexFaces[k];
+                float score = 0.0f;
+                const std::vector<int>& candidate = _mesh.Faces[f];
+                for (size_t i = 0; i < candidate.size(); i++) {
+                    score += isRepeated(candidate, i) ? 0.0f : _vertexScores[candidate[i]];
+                }
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = f;
+                }
+            }
+        }
+
+        if (nextCache.size() > static_cast<size_t>(_cacheSize)) {
+            nextCache.resize(_cacheSize);
+        }
+        std::swap(cache, nextCache);
+    }
+}
+
+bool LNLibEx::LNVertexCacheOptimizer::Process()
+{
+    for (const auto& face : _mesh.Faces) {
+        if (face.size() < 3) {
+            return false;
+        }
+    }
+    if (!LNMeshReorder::Validate(_mesh)) {
+        return false;
+    }
+
+    BuildVertexFaces();
+    std::vector<int> order;
+    BuildFaceOrder(order);
+    LNMeshReorder::PermuteFaces(_mesh, order);
+    LNMeshReorder::OrderByFirstUse(_mesh);
+    return true;
+}
@@ -0,0 +1,47 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNObject.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Tom Forsyth's linear-speed vertex cache optimisation.
+	/// 
+	/// Faces are emitted greedily by the score of their vertices, which rewards vertices
+	/// recently put into a simulated LRU cache and vertices with few remaining faces.
+	/// Polygons are scored as a whole, so faces are never split.
+	/// </summary>
+	class LNVertexCacheOptimizer
+	{
+	private:
+
+		LNLib::LN_Mesh& _mesh;
+		int _cacheSize;
+
+		std::vector<int> _vertexOffsets;
+		std::vector<int> _vertexFaces;
+		std::vector<int> _activeCounts;
+		std::vector<int> _cachePositions;
+		std::vector<float> _vertexScores;
+
+	private:
+
+		void BuildVertexFaces();
+		float ComputeVertexScore(int vertex) const;
+		void BuildFaceOrder(std::vector<int>& order);
+
+	public:
+
+		LNVertexCacheOptimizer(LNLib::LN_Mesh& mesh, int cacheSize);
+		bool Process();
+	};
+}
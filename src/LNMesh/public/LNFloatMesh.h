@@ -0,0 +1,50 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Single precision counterpart of LN_Mesh with flat arrays.
+	/// 
+	/// Positions, UVs and normals are interleaved floats and faces are stored as
+	/// offsets into one index array, which takes about half the memory of LN_Mesh.
+	/// UVIndices and NormalIndices have the same per face corner meaning as in LN_Mesh.
+	/// </summary>
+	struct LNMesh_EXPORT LNFloatMesh
+	{
+		/// <summary>
+		/// x, y, z per vertex.
+		/// </summary>
+		std::vector<float> Vertices;
+
+		/// <summary>
+		/// Face i uses FaceIndices[FaceOffsets[i]] to FaceIndices[FaceOffsets[i + 1] - 1].
+		/// Holds face count + 1 entries once a face is added.
+		/// </summary>
+		std::vector<int> FaceOffsets;
+		std::vector<int> FaceIndices;
+
+		/// <summary>
+		/// u, v per texture coordinate.
+		/// </summary>
+		std::vector<float> UVs;
+		std::vector<int> UVIndices;
+
+		/// <summary>
+		/// x, y, z per normal.
+		/// </summary>
+		std::vector<float> Normals;
+		std::vector<int> NormalIndices;
+	};
+}
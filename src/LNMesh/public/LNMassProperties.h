@@ -0,0 +1,43 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include "XYZ.h"
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Integral properties of a closed mesh for unit density.
+	/// Volume, Centroid and Inertia are only meaningful when the faces enclose a solid and point outwards.
+	/// </summary>
+	struct LNMesh_EXPORT LNMassProperties
+	{
+		/// <summary>
+		/// Sum of all face areas.
+		/// </summary>
+		double Area = 0.0;
+
+		/// <summary>
+		/// Enclosed volume, negative when faces point inwards.
+		/// </summary>
+		double Volume = 0.0;
+
+		/// <summary>
+		/// Center of mass of the enclosed volume.
+		/// </summary>
+		LNLib::XYZ Centroid;
+
+		/// <summary>
+		/// Inertia tensor about Centroid as row-major 3x3 matrix, off-diagonal terms are the negated products of inertia.
+		/// </summary>
+		double Inertia[9] = {};
+	};
+}
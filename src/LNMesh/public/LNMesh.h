@@ -9,7 +9,12 @@
  */
 
 #include "LNMeshDefinitions.h"
+#include "LNMeshEnums.h"
 #include "LNObject.h"
+#include "LNFloatMesh.h"
+#include "LNMeshRepairReport.h"
+#include "LNMassProperties.h"
+#include "Constants.h"
 #include <string>
 #include <vector>
 #pragma once
@@ -28,10 +33,125 @@ namespace LNLibEx
 		/// </remarks>
 		static bool FromOBJFile(const std::string& filePath, LNLib::LN_Mesh& mesh);
 
+		/// <summary>
+		/// Load .obj file keeping positions, UVs and normals in single precision.
+		/// </summary>
+		static bool FromOBJFile(const std::string& filePath, LNFloatMesh& mesh);
+
 		/// <summary>
 		/// Load ASCII or Binary .stl file to generate Mesh.
 		/// </summary>
 		static bool FromSTLFile(const std::string& filePath, LNLib::LN_Mesh& mesh);
+
+		/// <summary>
+		/// Load ASCII or Binary .stl file keeping positions and normals in single precision,
+		/// which is exact for binary .stl files.
+		/// </summary>
+		static bool FromSTLFile(const std::string& filePath, LNFloatMesh& mesh);
+
+		/// <summary>
+		/// Widen single precision mesh to LN_Mesh.
+		/// </summary>
+		static void ToMesh(const LNFloatMesh& source, LNLib::LN_Mesh& mesh);
+
+		/// <summary>
+		/// Narrow LN_Mesh to single precision mesh.
+		/// </summary>
+		static void ToFloatMesh(const LNLib::LN_Mesh& source, LNFloatMesh& mesh);
+
+		/// <summary>
+		/// Save Mesh to native binary cache file.
+		/// </summary>
+		/// <remarks>
+		/// Flat little-endian arrays in 64-byte aligned sections, guarded by a version and checksum.
+		/// </remarks>
+		static bool ToBinaryFile(const LNLib::LN_Mesh& mesh, const std::string& filePath);
+
+		/// <summary>
+		/// Load native binary cache file written by ToBinaryFile through memory mapping.
+		/// </summary>
+		static bool FromBinaryFile(const std::string& filePath, LNLib::LN_Mesh& mesh);
+
+		/// <summary>
+		/// Save Mesh to compressed file, see LNMeshCodec for the encoding.
+		/// </summary>
+		static bool ToCompressedFile(const LNLib::LN_Mesh& mesh, const std::string& filePath, int positionBits = 16);
+
+		/// <summary>
+		/// Load compressed file written by ToCompressedFile through memory mapping.
+		/// </summary>
+		static bool FromCompressedFile(const std::string& filePath, LNLib::LN_Mesh& mesh);
+
+		/// <summary>
+		/// Compute smooth vertex normals, replacing Normals and NormalIndices of mesh.
+		/// NormalIndices is filled per face corner in the same order as Faces.
+		/// </summary>
+		/// <remarks>
+		/// Corners whose face normals differ by more than creaseAngle (radians) are not smoothed together,
+		/// so such vertices receive one normal per smoothing group. Default creaseAngle smooths everything.
+		/// </remarks>
+		static bool ComputeVertexNormals(LNLib::LN_Mesh& mesh, NormalWeighting weighting = NormalWeighting::Angle, double creaseAngle = LNLib::Constants::Pi);
+
+		/// <summary>
+		/// Reduce mesh to at most targetFaceCount triangles by quadric error edge collapse.
+		/// vertexMap receives the result vertex of every input vertex, -1 if the vertex is not referenced.
+		/// </summary>
+		/// <remarks>
+		/// Polygons are triangulated first and the result only carries Vertices and Faces.
+		/// maxError bounds the quadric error (squared distance) of a single collapse, so the result may keep more faces than targetFaceCount.
+		/// Boundaries are preserved and collapses that fold faces or break manifoldness are rejected.
+		/// </remarks>
+		static bool Simplify(const LNLib::LN_Mesh& mesh, int targetFaceCount, LNLib::LN_Mesh& result, std::vector<int>& vertexMap, double maxError = LNLib::Constants::MaxDistance);
+
+		/// <summary>
+		/// Reorder Faces for post-transform vertex cache locality, then renumber Vertices, UVs and Normals by first use.
+		/// UVIndices and NormalIndices follow their faces and must be empty or hold one index per face corner.
+		/// </summary>
+		static bool OptimizeVertexCache(LNLib::LN_Mesh& mesh, int cacheSize = 32);
+
+		/// <summary>
+		/// Sort Vertices by position and Faces by centroid along a space-filling curve, rewriting all index arrays.
+		/// UVs and Normals are renumbered by first use, UVIndices and NormalIndices must be empty or hold one index per face corner.
+		/// </summary>
+		static bool SortSpatially(LNLib::LN_Mesh& mesh, SpaceFillingCurve curve = SpaceFillingCurve::Hilbert);
+
+		/// <summary>
+		/// Remove degenerate and duplicate faces, make faces of each connected component consistently oriented and collect boundary loops.
+		/// Faces with area not greater than areaTolerance are degenerate.
+		/// </summary>
+		/// <remarks>
+		/// Closed components are oriented outwards, open ones follow the orientation of most of their faces.
+		/// UVIndices and NormalIndices follow their faces and must be empty or hold one index per face corner.
+		/// </remarks>
+		static bool Repair(LNLib::LN_Mesh& mesh, LNMeshRepairReport& report, double areaTolerance = 0.0);
+
+		/// <summary>
+		/// Group faces into connected components, faces sharing a vertex belong to the same component.
+		/// Component i holds faceOrder[componentOffsets[i]] to faceOrder[componentOffsets[i + 1]] exclusive, components are ordered by their first face.
+		/// </summary>
+		/// <remarks>
+		/// With weldCoincident, vertices at identical positions count as shared, so unwelded STL facets group into their bodies.
+		/// </remarks>
+		static bool GetComponents(const LNLib::LN_Mesh& mesh, std::vector<int>& faceOrder, std::vector<int>& componentOffsets, bool weldCoincident = true);
+
+		/// <summary>
+		/// Split mesh into one LN_Mesh per connected component, see GetComponents.
+		/// Each component keeps only the Vertices, UVs and Normals its faces reference, in their input order.
+		/// </summary>
+		static bool SplitComponents(const LNLib::LN_Mesh& mesh, std::vector<LNLib::LN_Mesh>& components, bool weldCoincident = true);
+
+		/// <summary>
+		/// Compute area, volume, centroid and inertia tensor of a closed mesh, polygons are triangulated as fans.
+		/// </summary>
+		static bool ComputeMassProperties(const LNLib::LN_Mesh& mesh, LNMassProperties& properties);
+
+		/// <summary>
+		/// Compute mass properties directly from an STL file (either ASCII or Binary) without building a mesh.
+		/// </summary>
+		/// <remarks>
+		/// Binary files are memory-mapped and integrated in parallel, ASCII files are read in batches of facets.
+		/// </remarks>
+		static bool ComputeMassPropertiesFromSTLFile(const std::string& filePath, LNMassProperties& properties);
 	};
 }
 
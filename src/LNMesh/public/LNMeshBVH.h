@@ -0,0 +1,100 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include <cstdint>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	struct LNMesh_EXPORT LNMeshHit
+	{
+		/// <summary>
+		/// Index of hit face in LN_Mesh::Faces, -1 if nothing is hit.
+		/// </summary>
+		int Face = -1;
+
+		/// <summary>
+		/// Ray parameter for ray casting, distance for closest point query.
+		/// </summary>
+		double Distance = 0.0;
+
+		LNLib::XYZ Point;
+	};
+
+	/// <summary>
+	/// Bounding volume hierarchy over faces of LN_Mesh.
+	/// 
+	/// Built with binned SAH, large subtrees are built in parallel.
+	/// Nodes are flattened depth-first (left child follows its parent) into 32-byte records,
+	/// and node boxes are tested in double precision with SSE2 where available.
+	/// Polygon faces are fan-triangulated internally, hits always report the original face index.
+	/// </summary>
+	class LNMesh_EXPORT LNMeshBVH
+	{
+	public:
+
+		/// <summary>
+		/// Return false if a face has less than 3 vertices or an index out of range.
+		/// </summary>
+		bool Build(const LNLib::LN_Mesh& mesh, int maxLeafSize = 4);
+
+		bool IsEmpty() const;
+
+		int GetNodeCount() const;
+
+		/// <summary>
+		/// Nearest hit along ray origin + t * direction for t in [0, maxDistance].
+		/// Direction does not need to be normalized, Distance is reported in units of direction.
+		/// </summary>
+		bool Intersect(const LNLib::XYZ& origin, const LNLib::XYZ& direction, LNMeshHit& hit, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+		/// <summary>
+		/// Batched ray casting in parallel, hits[i].Face is -1 for missed rays.
+		/// </summary>
+		void Intersect(const std::vector<LNLib::XYZ>& origins, const std::vector<LNLib::XYZ>& directions, std::vector<LNMeshHit>& hits, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+		/// <summary>
+		/// Closest point on mesh within maxDistance of point.
+		/// </summary>
+		bool GetClosestPoint(const LNLib::XYZ& point, LNMeshHit& hit, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+		/// <summary>
+		/// Batched closest point queries in parallel, hits[i].Face is -1 if nothing lies within maxDistance.
+		/// </summary>
+		void GetClosestPoints(const std::vector<LNLib::XYZ>& points, std::vector<LNMeshHit>& hits, double maxDistance = LNLib::Constants::MaxDistance) const;
+
+	private:
+
+		struct Node
+		{
+			float Min[3];
+			// Interior: offset from this node to the right child. Leaf: first triangle.
+			uint32_t Offset;
+			float Max[3];
+			// Zero for interior node.
+			uint32_t Count;
+		};
+
+		struct Triangle
+		{
+			double Vertex[3];
+			double Edge1[3];
+			double Edge2[3];
+			int Face;
+		};
+
+		std::vector<Node> _nodes;
+		std::vector<Triangle> _triangles;
+	};
+}
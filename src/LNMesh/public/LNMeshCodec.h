@@ -0,0 +1,42 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include "LNObject.h"
+#include <cstddef>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Lossy compact encoding of LN_Mesh.
+	/// 
+	/// Positions and UVs are quantized relative to their bounding box and stored as planar 16-bit streams,
+	/// normals are octahedral encoded into two 16-bit values, and every index array is delta and varint coded.
+	/// Index streams are cut into independent blocks, so encoding and decoding run in parallel.
+	/// </summary>
+	class LNMesh_EXPORT LNMeshCodec
+	{
+	public:
+
+		/// <summary>
+		/// Encode mesh into data. positionBits and uvBits (1 to 16) set the quantization grid,
+		/// the position error per axis is at most half a grid step of the bounding box.
+		/// Return false if an index is out of range or a coordinate is not finite.
+		/// </summary>
+		static bool Encode(const LNLib::LN_Mesh& mesh, std::vector<unsigned char>& data, int positionBits = 16, int uvBits = 16);
+
+		/// <summary>
+		/// Decode data written by Encode, return false if data is truncated or inconsistent.
+		/// </summary>
+		static bool Decode(const unsigned char* data, size_t size, LNLib::LN_Mesh& mesh);
+	};
+}
@@ -0,0 +1,32 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#pragma once
+
+namespace LNLibEx
+{
+	enum class NormalWeighting : int
+	{
+		// Every incident face contributes equally.
+		Uniform = 0,
+		// Incident faces contribute by their area.
+		Area = 1,
+		// Incident faces contribute by the corner angle at the vertex.
+		Angle = 2,
+	};
+
+	enum class SpaceFillingCurve : int
+	{
+		// Z-order, interleaved coordinate bits.
+		Morton = 0,
+		// No jumps between consecutive cells, better locality than Morton.
+		Hilbert = 1,
+	};
+}
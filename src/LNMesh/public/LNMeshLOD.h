@@ -0,0 +1,88 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include <string>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Chain of progressively simplified triangle meshes sharing one vertex buffer.
+	/// 
+	/// Level 0 is the triangulated input and every next level is decimated from the previous one
+	/// without moving vertices, so all levels index the same vertex buffer.
+	/// Vertices are ordered by the coarsest level that still uses them,
+	/// hence level i only references the first GetLevelVertexCount(i) vertices.
+	/// </summary>
+	class LNMesh_EXPORT LNMeshLOD
+	{
+	public:
+
+		/// <summary>
+		/// Build up to levelCount levels, each one targeting reduction times the faces of the previous level.
+		/// Building stops early once a level can not be reduced any more.
+		/// Only Vertices and Faces of mesh are used.
+		/// </summary>
+		bool Build(const LNLib::LN_Mesh& mesh, int levelCount, double reduction = 0.5);
+
+		int GetLevelCount() const;
+
+		const std::vector<LNLib::XYZ>& GetVertices() const;
+
+		int GetLevelVertexCount(int level) const;
+
+		int GetLevelFaceCount(int level) const;
+
+		/// <summary>
+		/// Triangle indices of level into GetVertices(), 3 per face.
+		/// </summary>
+		const int* GetLevelIndices(int level) const;
+
+		/// <summary>
+		/// For every vertex of the input mesh, its vertex in GetVertices() used by level, -1 if unused.
+		/// </summary>
+		const int* GetVertexRemap(int level) const;
+
+		int GetInputVertexCount() const;
+
+		/// <summary>
+		/// Finest level with at most maxFaceCount faces, the coarsest level if none qualifies.
+		/// </summary>
+		int SelectLevel(int maxFaceCount) const;
+
+		/// <summary>
+		/// Copy level into standalone LN_Mesh holding only the vertices it uses.
+		/// </summary>
+		bool GetLevel(int level, LNLib::LN_Mesh& mesh) const;
+
+		/// <summary>
+		/// Write all levels into one native binary file.
+		/// </summary>
+		bool Write(const std::string& filePath) const;
+
+		/// <summary>
+		/// Load file written by Write through memory mapping.
+		/// </summary>
+		bool Read(const std::string& filePath);
+
+	private:
+
+		int _inputVertexCount = 0;
+		std::vector<LNLib::XYZ> _vertices;
+		std::vector<int> _levelVertexCounts;
+		std::vector<int> _levelOffsets;
+		std::vector<int> _indices;
+		std::vector<int> _remaps;
+	};
+}
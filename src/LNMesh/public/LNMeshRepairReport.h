@@ -0,0 +1,49 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	struct LNMesh_EXPORT LNMeshRepairReport
+	{
+		/// <summary>
+		/// Removed faces with less than 3 distinct vertices or (near) zero area.
+		/// </summary>
+		int DegenerateFaces = 0;
+
+		/// <summary>
+		/// Removed faces using the same vertices as an earlier face, in any order.
+		/// </summary>
+		int DuplicateFaces = 0;
+
+		/// <summary>
+		/// Faces whose vertex order was reversed to agree with their neighbours.
+		/// </summary>
+		int FlippedFaces = 0;
+
+		/// <summary>
+		/// Groups of faces connected through manifold edges.
+		/// </summary>
+		int ComponentCount = 0;
+
+		/// <summary>
+		/// Components which can not be oriented consistently, such as a Moebius strip.
+		/// </summary>
+		int NonOrientableComponents = 0;
+
+		/// <summary>
+		/// Boundary loops of the repaired mesh as vertex indices, in the direction of their faces.
+		/// </summary>
+		std::vector<std::vector<int>> Holes;
+	};
+}
@@ -0,0 +1,104 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include "LNObject.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Half-edge connectivity of LN_Mesh.
+	/// 
+	/// Half-edge i is the i-th face corner in Faces order, running from that corner to the next one,
+	/// so half-edge indices match per-corner arrays such as NormalIndices.
+	/// Half-edges on the same undirected vertex pair are grouped into one edge.
+	/// </summary>
+	class LNMesh_EXPORT LNMeshTopology
+	{
+	public:
+
+		/// <summary>
+		/// Build connectivity by bucketing half-edges on their smaller vertex
+		/// and sorting each bucket in parallel, no hash maps involved.
+		/// Return false if a face has less than 3 vertices or an index out of range.
+		/// </summary>
+		bool Build(const LNLib::LN_Mesh& mesh);
+
+		int GetVertexCount() const;
+		int GetFaceCount() const;
+		int GetHalfEdgeCount() const;
+		int GetEdgeCount() const;
+
+		int GetOrigin(int halfEdge) const;
+		int GetTarget(int halfEdge) const;
+		int GetFace(int halfEdge) const;
+		int GetNext(int halfEdge) const;
+		int GetPrevious(int halfEdge) const;
+
+		/// <summary>
+		/// Opposite half-edge, or -1 when the edge is boundary, non-manifold or inconsistently oriented.
+		/// </summary>
+		int GetTwin(int halfEdge) const;
+
+		int GetEdge(int halfEdge) const;
+
+		/// <summary>
+		/// One outgoing half-edge of vertex, or -1 for isolated vertex.
+		/// Boundary vertices return their outgoing boundary half-edge.
+		/// </summary>
+		int GetVertexHalfEdge(int vertex) const;
+
+		int GetFaceHalfEdge(int face) const;
+
+		/// <summary>
+		/// All half-edges lying on edge.
+		/// </summary>
+		std::vector<int> GetEdgeHalfEdges(int edge) const;
+
+		/// <summary>
+		/// Edges used by only one face.
+		/// </summary>
+		const std::vector<int>& GetBoundaryEdges() const;
+
+		/// <summary>
+		/// Edges shared by more than two faces.
+		/// </summary>
+		const std::vector<int>& GetNonManifoldEdges() const;
+
+		/// <summary>
+		/// Edges shared by two faces which traverse it in the same direction.
+		/// </summary>
+		const std::vector<int>& GetMisorientedEdges() const;
+
+		bool IsManifold() const;
+
+		/// <summary>
+		/// Manifold, consistently oriented and without boundary.
+		/// </summary>
+		bool IsClosed() const;
+
+	private:
+
+		int _vertexCount = 0;
+		std::vector<int> _faceOffsets;
+		std::vector<int> _origins;
+		std::vector<int> _faces;
+		std::vector<int> _twins;
+		std::vector<int> _edges;
+		std::vector<int> _vertexHalfEdges;
+		std::vector<int> _edgeOffsets;
+		std::vector<int> _edgeHalfEdges;
+		std::vector<int> _boundaryEdges;
+		std::vector<int> _nonManifoldEdges;
+		std::vector<int> _misorientedEdges;
+	};
+}
@@ -0,0 +1,77 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNMeshDefinitions.h"
+#include "XYZ.h"
+#include "Matrix4d.h"
+#include <cstddef>
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Structure-of-arrays copy of mesh vertices for bulk operations.
+	/// 
+	/// X, Y and Z are separate 64-byte aligned double arrays, so kernels process
+	/// 4 (AVX2) or 8 (AVX-512) vertices per instruction. The instruction set is chosen at runtime,
+	/// with a scalar fallback, and large arrays are split across threads.
+	/// </summary>
+	class LNMesh_EXPORT LNVertexArray
+	{
+	public:
+
+		LNVertexArray();
+		explicit LNVertexArray(const std::vector<LNLib::XYZ>& vertices);
+		LNVertexArray(const LNVertexArray& other);
+		LNVertexArray(LNVertexArray&& other) noexcept;
+		LNVertexArray& operator=(const LNVertexArray& other);
+		LNVertexArray& operator=(LNVertexArray&& other) noexcept;
+		~LNVertexArray();
+
+		void Assign(const std::vector<LNLib::XYZ>& vertices);
+
+		void CopyTo(std::vector<LNLib::XYZ>& vertices) const;
+
+		int GetCount() const;
+
+		double* X();
+		double* Y();
+		double* Z();
+		const double* X() const;
+		const double* Y() const;
+		const double* Z() const;
+
+		/// <summary>
+		/// Apply matrix to every vertex like Matrix4d::OfPoint.
+		/// The homogeneous divide is skipped when the last row of matrix is (0, 0, 0, 1).
+		/// </summary>
+		void Transform(const LNLib::Matrix4d& matrix);
+
+		/// <summary>
+		/// Axis-aligned bounding box, return false for empty array.
+		/// </summary>
+		bool GetBounds(LNLib::XYZ& minimum, LNLib::XYZ& maximum) const;
+
+		/// <summary>
+		/// Average of all vertices, origin for empty array.
+		/// </summary>
+		LNLib::XYZ GetCentroid() const;
+
+	private:
+
+		void Allocate(int count);
+		void Release();
+
+		double* _data = nullptr;
+		int _count = 0;
+		size_t _stride = 0;
+	};
+}
@@ -0,0 +1,210 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNAdaptiveTessellator.h"
+#include "LNObject.h"
+#include "NurbsSurface.h"
+#include "XYZ.h"
+#include "UV.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Sample points per direction inside a knot span when bounding its bending.
+    const int MaxSpanSamples = 6;
+
+    // Relative size of the parameter step away from a degenerate point (pole, collapsed edge) to find its normal.
+    const double NormalNudge = 1E-6;
+
+    std::vector<double> subdivide(const std::vector<double>& knots, const std::vector<int>& segments) {
+        std::vector<double> parameters;
+        for (size_t i = 0; i + 1 < knots.size(); i++) {
+            for (int k = 0; k < segments[i]; k++) {
+                parameters.emplace_back(knots[i] + (knots[i + 1] - knots[i]) * k / segments[i]);
+            }
+        }
+        parameters.emplace_back(knots.back());
+        return parameters;
+    }
+}
+
+LNLibEx::LNAdaptiveTessellator::LNAdaptiveTessellator(const LNLib::LN_NurbsSurface& surface, const LNTessellationOptions& options):
+                                                _surface(surface), _options(options){}
+
+std::vector<double> LNLibEx::LNAdaptiveTessellator::GetSpanKnots(bool isUDirection) const
+{
+    const std::vector<double>& knotVector = isUDirection ? _surface.KnotVectorU : _surface.KnotVectorV;
+    const int degree = isUDirection ? _surface.DegreeU : _surface.DegreeV;
+    const int controlPointCount = static_cast<int>(knotVector.size()) - degree - 1;
+
+    std::vector<double> knots;
+    for (int i = degree; i <= controlPointCount; i++) {
+        if (knots.empty() || knotVector[i] > knots.back()) {
+            knots.emplace_back(knotVector[i]);
+        }
+    }
+    return knots;
+}
+
+void LNLibEx::LNAdaptiveTessellator::ComputeSpanSegments(double u0, double u1, double v0, double v1, int& uSegments, int& vSegments) const
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double chordal = _options.ChordalTolerance;
+    const double angle = _options.AngleTolerance;
+    const int samples = std::min(MaxSpanSamples, std::max(_surface.DegreeU, _surface.DegreeV) + 3);
+
+    double uStep = infinity;
+    double vStep = infinity;
+    for (int i = 0; i < samples; i++) {
+        for (int j = 0; j < samples; j++) {
+            LNLib::UV uv(u0 + (u1 - u0) * i / (samples - 1), v0 + (v1 - v0) * j / (samples - 1));
+            auto derivatives = LNLib::NurbsSurface::ComputeRationalSurfaceDerivatives(_surface, 2, uv);
+            const LNLib::XYZ& su = derivatives[1][0];
+            const LNLib::XYZ& sv = derivatives[0][1];
+            LNLib::XYZ normal = su.CrossProduct(sv);
+            double length = normal.Length();
+            if (length > 0.0) {
+                normal /= length;
+            }
+            else {
+                normal = ComputeNormal(_surface, uv);
+            }
+
+            // Only the normal part of the second derivatives moves the surface away from the chord,
+            // where no normal can be found the whole vector is used.
+            double uBend = derivatives[2][0].Length();
+            double vBend = derivatives[0][2].Length();
+            double twist = derivatives[1][1].Length();
+            if (normal.Length() > 0.0) {
+                uBend = std::fabs(derivatives[2][0].DotProduct(normal));
+                vBend = std::fabs(derivatives[0][2].DotProduct(normal));
+                twist = std::fabs(derivatives[1][1].DotProduct(normal));
+            }
+
+            // Chord of a step h deviates by bend * h^2 / 8, a bilinear cell by twist * hu * hv / 4,
+            // and the normal turns by bend * h / |first derivative|.
+            if (chordal > 0.0) {
+                if (uBend > 0.0) uStep = std::min(uStep, std::sqrt(8.0 * chordal / uBend));
+                if (vBend > 0.0) vStep = std::min(vStep, std::sqrt(8.0 * chordal / vBend));
+                if (twist > 0.0) {
+                    double step = std::sqrt(4.0 * chordal / twist);
+                    uStep = std::min(uStep, step);
+                    vStep = std::min(vStep, step);
+                }
+            }
+            if (angle > 0.0) {
+                if (uBend > 0.0) uStep = std::min(uStep, angle * su.Length() / uBend);
+                if (vBend > 0.0) vStep = std::min(vStep, angle * sv.Length() / vBend);
+            }
+        }
+    }
+
+    auto toSegments = [this](double span, double step) {
+        double segments = std::ceil(span / step);
+        return static_cast<int>(std::max(1.0, std::min(segments, static_cast<double>(_options.MaxSegmentsPerSpan))));
+    };
+    uSegments = toSegments(u1 - u0, uStep);
+    vSegments = toSegments(v1 - v0, vStep);
+}
+
+LNLib::XYZ LNLibEx::LNAdaptiveTessellator::ComputeNormal(const LNLib::LN_NurbsSurface& surface, const LNLib::UV& uv)
+{
+    LNLib::XYZ point, su, sv;
+    LNLib::NurbsSurface::ComputeRationalSurfaceFirstOrderDerivative(surface, uv, point, su, sv);
+    LNLib::XYZ normal = su.CrossProduct(sv);
+    if (normal.Length() > 0.0) {
+        return normal.Normalize();
+    }
+
+    // Step towards the middle of the domain, where the normal is defined.
+    double u0 = surface.KnotVectorU[surface.DegreeU];
+    double u1 = surface.KnotVectorU[surface.KnotVectorU.size() - surface.DegreeU - 1];
+    double v0 = surface.KnotVectorV[surface.DegreeV];
+    double v1 = surface.KnotVectorV[surface.KnotVectorV.size() - surface.DegreeV - 1];
+    LNLib::UV nudged(uv.GetU() + NormalNudge * (0.5 * (u0 + u1) - uv.GetU()), uv.GetV() + NormalNudge * (0.5 * (v0 + v1) - uv.GetV()));
+    LNLib::NurbsSurface::ComputeRationalSurfaceFirstOrderDerivative(surface, nudged, point, su, sv);
+    normal = su.CrossProduct(sv);
+    return normal.Length() > 0.0 ? normal.Normalize() : normal;
+}
+
+void LNLibEx::LNAdaptiveTessellator::ComputeParameters(std::vector<double>& uParameters, std::vector<double>& vParameters) const
+{
+    std::vector<double> uKnots = GetSpanKnots(true);
+    std::vector<double> vKnots = GetSpanKnots(false);
+    std::vector<int> uSegments(uKnots.size() - 1, 1);
+    std::vector<int> vSegments(vKnots.size() - 1, 1);
+    for (size_t i = 0; i < uSegments.size(); i++) {
+        for (size_t j = 0; j < vSegments.size(); j++) {
+            int uCount = 1;
+            int vCount = 1;
+            ComputeSpanSegments(uKnots[i], uKnots[i + 1], vKnots[j], vKnots[j + 1], uCount, vCount);
+            uSegments[i] = std::max(uSegments[i], uCount);
+            vSegments[j] = std::max(vSegments[j], vCount);
+        }
+    }
+    uParameters = subdivide(uKnots, uSegments);
+    vParameters = subdivide(vKnots, vSegments);
+}
+
+void LNLibEx::LNAdaptiveTessellator::Process(LNLib::LN_Mesh& mesh) const
+{
+    std::vector<double> uParameters;
+    std::vector<double> vParameters;
+    ComputeParameters(uParameters, vParameters);
+
+    const int rows = static_cast<int>(uParameters.size());
+    const int columns = static_cast<int>(vParameters.size());
+    mesh = LNLib::LN_Mesh();
+    mesh.Vertices.reserve(rows * columns);
+    mesh.UVs.reserve(rows * columns);
+    mesh.Normals.reserve(rows * columns);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < columns; j++) {
+            LNLib::UV uv(uParameters[i], vParameters[j]);
+            mesh.Vertices.emplace_back(LNLib::NurbsSurface::GetPointOnSurface(_surface, uv));
+            mesh.UVs.emplace_back(uv);
+            mesh.Normals.emplace_back(ComputeNormal(_surface, uv));
+        }
+    }
+
+    auto addTriangle = [&mesh](int a, int b, int c) {
+        // Triangles collapsed at poles or degenerate edges are left out.
+        if (mesh.Vertices[a].IsAlmostEqualTo(mesh.Vertices[b]) ||
+            mesh.Vertices[b].IsAlmostEqualTo(mesh.Vertices[c]) ||
+            mesh.Vertices[c].IsAlmostEqualTo(mesh.Vertices[a])) {
+            return;
+        }
+        mesh.Faces.push_back({ a, b, c });
+    };
+    for (int i = 0; i + 1 < rows; i++) {
+        for (int j = 0; j + 1 < columns; j++) {
+            int p00 = i * columns + j;
+            int p10 = p00 + columns;
+            int p11 = p10 + 1;
+            int p01 = p00 + 1;
+            if (mesh.Vertices[p00].Distance(mesh.Vertices[p11]) <= mesh.Vertices[p10].Distance(mesh.Vertices[p01])) {
+                addTriangle(p00, p10, p11);
+                addTriangle(p00, p11, p01);
+            }
+            else {
+                addTriangle(p00, p10, p01);
+                addTriangle(p10, p11, p01);
+            }
+        }
+    }
+
+    for (const auto& face : mesh.Faces) {
+        mesh.UVIndices.insert(mesh.UVIndices.end(), face.begin(), face.end());
+        mesh.NormalIndices.insert(mesh.NormalIndices.end(), face.begin(), face.end());
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNTessellationOptions.h"
+#include "LNObject.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Tessellate a surface on a tensor grid whose sample count per knot span follows the surface bending.
+	/// 
+	/// Second derivatives sampled inside each span bound the chordal deviation and the normal turn of a step,
+	/// every span column takes the largest count over its rows (and the other way round) so the grid stays conforming.
+	/// </summary>
+	class LNAdaptiveTessellator
+	{
+	private:
+
+		const LNLib::LN_NurbsSurface& _surface;
+		const LNTessellationOptions& _options;
+
+	private:
+
+		std::vector<double> GetSpanKnots(bool isUDirection) const;
+		void ComputeSpanSegments(double u0, double u1, double v0, double v1, int& uSegments, int& vSegments) const;
+
+	public:
+
+		/// <summary>
+		/// Unit normal at uv, taken slightly inside the domain where the surface degenerates (poles, collapsed edges).
+		/// </summary>
+		static LNLib::XYZ ComputeNormal(const LNLib::LN_NurbsSurface& surface, const LNLib::UV& uv);
+
+		LNAdaptiveTessellator(const LNLib::LN_NurbsSurface& surface, const LNTessellationOptions& options);
+
+		/// <summary>
+		/// Sorted parameters of the grid lines along U and V, including domain ends and all knots.
+		/// </summary>
+		void ComputeParameters(std::vector<double>& uParameters, std::vector<double>& vParameters) const;
+
+		/// <summary>
+		/// Output triangles with per-vertex UVs and Normals, UVIndices and NormalIndices equal the vertex indices.
+		/// </summary>
+		void Process(LNLib::LN_Mesh& mesh) const;
+	};
+}
@@ -0,0 +1,139 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNBatchTessellator.h"
+#include "LNAdaptiveTessellator.h"
+#include "LNObject.h"
+#include "NurbsSurface.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace
+{
+    int getCornerCount(const LNLib::LN_Mesh& mesh) {
+        int count = 0;
+        for (const auto& face : mesh.Faces) {
+            count += static_cast<int>(face.size());
+        }
+        return count;
+    }
+}
+
+LNLibEx::LNBatchTessellator::LNBatchTessellator(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNTessellationReport& report):
+                                                _surfaces(surfaces), _options(options), _report(report){}
+
+void LNLibEx::LNBatchTessellator::TessellateSurface(const LNLib::LN_NurbsSurface& surface, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh)
+{
+    LNLib::NurbsSurface::Check(surface);
+    switch (options.Mode) {
+    case TessellationMode::Adaptive: {
+        LNAdaptiveTessellator tessellator(surface, options);
+        tessellator.Process(mesh);
+        break;
+    }
+    default:
+        mesh = LNLib::NurbsSurface::Triangulate(surface, options.ResolutionU, options.ResolutionV, options.UseDelaunay);
+        break;
+    }
+}
+
+bool LNLibEx::LNBatchTessellator::Process(std::vector<LNLib::LN_Mesh>& meshes)
+{
+    const int surfaceCount = static_cast<int>(_surfaces.size());
+    meshes.assign(surfaceCount, LNLib::LN_Mesh());
+    _report.SurfaceSeconds.assign(surfaceCount, 0.0);
+    _report.FailedSurfaces.clear();
+
+    std::vector<char> isFailed(surfaceCount, 0);
+    LNParallel::ForDynamic(0, surfaceCount, [&](int64_t i) {
+        auto start = std::chrono::steady_clock::now();
+        try {
+            TessellateSurface(_surfaces[i], _options, meshes[i]);
+        }
+        catch (const std::exception&) {
+            meshes[i] = LNLib::LN_Mesh();
+            isFailed[i] = 1;
+        }
+        _report.SurfaceSeconds[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    });
+
+    _report.VertexOffsets.assign(surfaceCount + 1, 0);
+    _report.FaceOffsets.assign(surfaceCount + 1, 0);
+    for (int i = 0; i < surfaceCount; i++) {
+        if (isFailed[i]) {
+            _report.FailedSurfaces.emplace_back(i);
+        }
+        _report.VertexOffsets[i + 1] = _report.VertexOffsets[i] + static_cast<int>(meshes[i].Vertices.size());
+        _report.FaceOffsets[i + 1] = _report.FaceOffsets[i] + static_cast<int>(meshes[i].Faces.size());
+    }
+    return _report.FailedSurfaces.empty();
+}
+
+void LNLibEx::LNBatchTessellator::Merge(const std::vector<LNLib::LN_Mesh>& meshes, LNLib::LN_Mesh& mesh) const
+{
+    const int meshCount = static_cast<int>(meshes.size());
+    std::vector<int> cornerOffsets(meshCount + 1, 0);
+    std::vector<int> uvOffsets(meshCount + 1, 0);
+    std::vector<int> normalOffsets(meshCount + 1, 0);
+    bool hasUVs = true;
+    bool hasNormals = true;
+    for (int i = 0; i < meshCount; i++) {
+        const LNLib::LN_Mesh& part = meshes[i];
+        const int cornerCount = getCornerCount(part);
+        hasUVs = hasUVs && static_cast<int>(part.UVIndices.size()) == cornerCount;
+        hasNormals = hasNormals && static_cast<int>(part.NormalIndices.size()) == cornerCount;
+        cornerOffsets[i + 1] = cornerOffsets[i] + cornerCount;
+        uvOffsets[i + 1] = uvOffsets[i] + static_cast<int>(part.UVs.size());
+        normalOffsets[i + 1] = normalOffsets[i] + static_cast<int>(part.Normals.size());
+    }
+    hasUVs = hasUVs && cornerOffsets.back() > 0;
+    hasNormals = hasNormals && cornerOffsets.back() > 0;
+
+    mesh = LNLib::LN_Mesh();
+    mesh.Vertices.resize(_report.VertexOffsets.back());
+    mesh.Faces.resize(_report.FaceOffsets.back());
+    if (hasUVs) {
+        mesh.UVs.resize(uvOffsets.back());
+        mesh.UVIndices.resize(cornerOffsets.back());
+    }
+    if (hasNormals) {
+        mesh.Normals.resize(normalOffsets.back());
+        mesh.NormalIndices.resize(cornerOffsets.back());
+    }
+
+    // Every part writes its own ranges, so parts are copied independently.
+    LNParallel::ForDynamic(0, meshCount, [&](int64_t i) {
+        const LNLib::LN_Mesh& part = meshes[i];
+        const int vertexOffset = _report.VertexOffsets[i];
+        std::copy(part.Vertices.begin(), part.Vertices.end(), mesh.Vertices.begin() + vertexOffset);
+        for (size_t f = 0; f < part.Faces.size(); f++) {
+            std::vector<int>& face = mesh.Faces[_report.FaceOffsets[i] + f];
+            face = part.Faces[f];
+            for (int& index : face) {
+                index += vertexOffset;
+            }
+        }
+        if (hasUVs) {
+            std::copy(part.UVs.begin(), part.UVs.end(), mesh.UVs.begin() + uvOffsets[i]);
+            for (size_t k = 0; k < part.UVIndices.size(); k++) {
+                mesh.UVIndices[cornerOffsets[i] + k] = part.UVIndices[k] + uvOffsets[i];
+            }
+        }
+        if (hasNormals) {
+            std::copy(part.Normals.begin(), part.Normals.end(), mesh.Normals.begin() + normalOffsets[i]);
+            for (size_t k = 0; k < part.NormalIndices.size(); k++) {
+                mesh.NormalIndices[cornerOffsets[i] + k] = part.NormalIndices[k] + normalOffsets[i];
+            }
+        }
+    });
+}
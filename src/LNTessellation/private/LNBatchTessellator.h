@@ -0,0 +1,49 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNTessellationOptions.h"
+#include "LNTessellationReport.h"
+#include "LNObject.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Tessellate surfaces on all threads, then concatenate the meshes at precomputed offsets.
+	/// </summary>
+	class LNBatchTessellator
+	{
+	private:
+
+		const std::vector<LNLib::LN_NurbsSurface>& _surfaces;
+		const LNTessellationOptions& _options;
+		LNTessellationReport& _report;
+
+	public:
+
+		/// <summary>
+		/// Tessellate one surface in the mode of options, throw if the surface is invalid.
+		/// </summary>
+		static void TessellateSurface(const LNLib::LN_NurbsSurface& surface, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh);
+
+
+		LNBatchTessellator(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNTessellationReport& report);
+
+		/// <summary>
+		/// Fill meshes with one mesh per surface and the timings and offsets of report.
+		/// </summary>
+		bool Process(std::vector<LNLib::LN_Mesh>& meshes);
+
+		/// <summary>
+		/// Concatenate meshes produced by Process, shifting their indices by the offsets of report.
+		/// </summary>
+		void Merge(const std::vector<LNLib::LN_Mesh>& meshes, LNLib::LN_Mesh& mesh) const;
+	};
+}
@@ -0,0 +1,58 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNTessellation.h"
+#include "LNObject.h"
+#include "LNBatchTessellator.h"
+#include "LNWatertightTessellator.h"
+
+#include <chrono>
+#include <exception>
+
+bool LNLibEx::LNTessellation::Tessellate(const LNLib::LN_NurbsSurface& surface, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh)
+{
+    try {
+        LNBatchTessellator::TessellateSurface(surface, options, mesh);
+    }
+    catch (const std::exception&) {
+        mesh = LNLib::LN_Mesh();
+        return false;
+    }
+    return true;
+}
+
+bool LNLibEx::LNTessellation::Tessellate(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh, LNTessellationReport& report)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<LNLib::LN_Mesh> meshes;
+    LNBatchTessellator tessellator(surfaces, options, report);
+    bool result = tessellator.Process(meshes);
+    tessellator.Merge(meshes, mesh);
+    report.TotalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool LNLibEx::LNTessellation::Tessellate(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, std::vector<LNLib::LN_Mesh>& meshes, LNTessellationReport& report)
+{
+    auto start = std::chrono::steady_clock::now();
+    LNBatchTessellator tessellator(surfaces, options, report);
+    bool result = tessellator.Process(meshes);
+    report.TotalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool LNLibEx::LNTessellation::TessellateWatertight(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh, LNTessellationReport& report)
+{
+    auto start = std::chrono::steady_clock::now();
+    LNWatertightTessellator tessellator(surfaces, options, report);
+    bool result = tessellator.Process(mesh);
+    report.TotalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,530 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ *
+ */
+
+#include "LNWatertightTessellator.h"
+#include "LNAdaptiveTessellator.h"
+#include "LNObject.h"
+#include "NurbsSurface.h"
+#include "XYZ.h"
+#include "UV.h"
+#include "LNParallel.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+    const int ProjectionIterations = 16;
+
+    // Every patch needs an interior grid line along each boundary to zip the boundary samples to.
+    void ensureInteriorLine(std::vector<double>& parameters) {
+        if (parameters.size() == 2) {
+            parameters.insert(parameters.begin() + 1, 0.5 * (parameters[0] + parameters[1]));
+        }
+    }
+
+    std::vector<double> uniformParameters(double start, double end, int segments) {
+        segments = std::max(1, segments);
+        std::vector<double> parameters(segments + 1);
+        for (int i = 0; i <= segments; i++) {
+            parameters[i] = start + (end - start) * i / segments;
+        }
+        parameters.back() = end;
+        return parameters;
+    }
+
+    double getFraction(double parameter, double start, double end) {
+        return end == start ? 0.0 : (parameter - start) / (end - start);
+    }
+
+    struct CellHash
+    {
+        size_t operator()(const std::array<int64_t, 3>& cell) const {
+            uint64_t hash = 1469598103934665603ULL;
+            for (int64_t value : cell) {
+                hash = (hash ^ static_cast<uint64_t>(value)) * 1099511628211ULL;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    /// Grid cell index of value, clamped so that huge quotients (and non-finite values) stay representable.
+    int64_t getCell(double value, double cellSize) {
+        const double limit = 4611686018427387904.0;
+        double quotient = std::floor(value / cellSize);
+        return static_cast<int64_t>(std::max(-limit, std::min(limit, quotient)));
+    }
+}
+
+LNLibEx::LNWatertightTessellator::LNWatertightTessellator(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNTessellationReport& report):
+                                                _surfaces(surfaces), _options(options), _report(report){}
+
+LNLib::UV LNLibEx::LNWatertightTessellator::GetSideUV(int side, double parameter) const
+{
+    const std::vector<double>& u = _uParameters[side / 4];
+    const std::vector<double>& v = _vParameters[side / 4];
+    switch (side % 4) {
+    case 0: return LNLib::UV(parameter, v.front());
+    case 1: return LNLib::UV(u.back(), parameter);
+    case 2: return LNLib::UV(parameter, v.back());
+    default: return LNLib::UV(u.front(), parameter);
+    }
+}
+
+double LNLibEx::LNWatertightTessellator::ProjectToSide(int side, const LNLib::XYZ& point, double seed) const
+{
+    const LNLib::LN_NurbsSurface& surface = _surfaces[side / 4];
+    const std::vector<double>& parameters = _sides[side].Parameters;
+    const double low = std::min(parameters.front(), parameters.back());
+    const double high = std::max(parameters.front(), parameters.back());
+    const bool isUDirection = side % 2 == 0;
+
+    // Newton iteration on (S(t) - P) . S'(t) = 0 along the boundary curve.
+    double parameter = std::max(low, std::min(high, seed));
+    for (int i = 0; i < ProjectionIterations; i++) {
+        auto derivatives = LNLib::NurbsSurface::ComputeRationalSurfaceDerivatives(surface, 2, GetSideUV(side, parameter));
+        const LNLib::XYZ difference = derivatives[0][0] - point;
+        const LNLib::XYZ& first = isUDirection ? derivatives[1][0] : derivatives[0][1];
+        const LNLib::XYZ& second = isUDirection ? derivatives[2][0] : derivatives[0][2];
+        double slope = first.DotProduct(first) + difference.DotProduct(second);
+        if (slope <= 0.0) {
+            slope = first.DotProduct(first);
+        }
+        if (slope <= 0.0) {
+            break;
+        }
+        double next = std::max(low, std::min(high, parameter - difference.DotProduct(first) / slope));
+        bool isConverged = std::fabs(next - parameter) <= 1E-12 * (high - low);
+        parameter = next;
+        if (isConverged) {
+            break;
+        }
+    }
+    return parameter;
+}
+
+bool LNLibEx::LNWatertightTessellator::IsOnSide(int side, const LNLib::XYZ& point) const
+{
+    // Seed from the nearest sample, the projection then only has to refine within one segment.
+    const Side& target = _sides[side];
+    size_t nearest = 0;
+    for (size_t i = 1; i < target.Points.size(); i++) {
+        if (target.Points[i].Distance(point) < target.Points[nearest].Distance(point)) {
+            nearest = i;
+        }
+    }
+    double parameter = ProjectToSide(side, point, target.Parameters[nearest]);
+    LNLib::XYZ projection = LNLib::NurbsSurface::GetPointOnSurface(_surfaces[side / 4], GetSideUV(side, parameter));
+    return projection.Distance(point) <= _options.WeldTolerance;
+}
+
+void LNLibEx::LNWatertightTessellator::SampleSurfaces()
+{
+    const int surfaceCount = static_cast<int>(_surfaces.size());
+    _isFailed.assign(surfaceCount, 0);
+    _uParameters.assign(surfaceCount, std::vector<double>());
+    _vParameters.assign(surfaceCount, std::vector<double>());
+    _sides.assign(4 * surfaceCount, Side());
+    _report.SurfaceSeconds.assign(surfaceCount, 0.0);
+
+    LNParallel::ForDynamic(0, surfaceCount, [&](int64_t s) {
+        auto start = std::chrono::steady_clock::now();
+        const LNLib::LN_NurbsSurface& surface = _surfaces[s];
+        try {
+            LNLib::NurbsSurface::Check(surface);
+            std::vector<double>& u = _uParameters[s];
+            std::vector<double>& v = _vParameters[s];
+            if (_options.Mode == TessellationMode::Adaptive) {
+                LNAdaptiveTessellator tessellator(surface, _options);
+                tessellator.ComputeParameters(u, v);
+            }
+            else {
+                u = uniformParameters(surface.KnotVectorU[surface.DegreeU], surface.KnotVectorU[surface.KnotVectorU.size() - surface.DegreeU - 1], _options.ResolutionU);
+                v = uniformParameters(surface.KnotVectorV[surface.DegreeV], surface.KnotVectorV[surface.KnotVectorV.size() - surface.DegreeV - 1], _options.ResolutionV);
+            }
+            ensureInteriorLine(u);
+            ensureInteriorLine(v);
+
+            for (int k = 0; k < 4; k++) {
+                Side& side = _sides[4 * s + k];
+                side.Parameters = k % 2 == 0 ? u : v;
+                if (k >= 2) {
+                    std::reverse(side.Parameters.begin(), side.Parameters.end());
+                }
+                for (double parameter : side.Parameters) {
+                    side.Points.emplace_back(LNLib::NurbsSurface::GetPointOnSurface(surface, GetSideUV(static_cast<int>(4 * s + k), parameter)));
+                }
+            }
+        }
+        catch (const std::exception&) {
+            _isFailed[s] = 1;
+            for (int k = 0; k < 4; k++) {
+                _sides[4 * s + k] = Side();
+            }
+        }
+        _report.SurfaceSeconds[s] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    });
+}
+
+void LNLibEx::LNWatertightTessellator::WeldCorners()
+{
+    // Corners closer than WeldTolerance share a vertex, candidates are found in a hashed grid of that cell size.
+    // Below the resolution of the coordinates the cells grow to it, which keeps cell indices far from overflow.
+    const int sideCount = static_cast<int>(_sides.size());
+    double scale = 0.0;
+    for (int i = 0; i < sideCount; i++) {
+        if (!_isFailed[i / 4]) {
+            const LNLib::XYZ& corner = _sides[i].Points.front();
+            scale = std::max({ scale, std::fabs(corner[0]), std::fabs(corner[1]), std::fabs(corner[2]) });
+        }
+    }
+    const double cellSize = std::max({ _options.WeldTolerance, scale * 1E-12, std::numeric_limits<double>::min() });
+    std::unordered_map<std::array<int64_t, 3>, std::vector<int>, CellHash> cells;
+    for (int i = 0; i < sideCount; i++) {
+        if (_isFailed[i / 4]) {
+            continue;
+        }
+        const LNLib::XYZ& corner = _sides[i].Points.front();
+        std::array<int64_t, 3> cell;
+        for (int axis = 0; axis < 3; axis++) {
+            cell[axis] = getCell(corner[axis], cellSize);
+        }
+
+        int vertex = -1;
+        for (int dx = -1; dx <= 1 && vertex < 0; dx++) {
+            for (int dy = -1; dy <= 1 && vertex < 0; dy++) {
+                for (int dz = -1; dz <= 1 && vertex < 0; dz++) {
+                    auto found = cells.find({ cell[0] + dx, cell[1] + dy, cell[2] + dz });
+                    if (found == cells.end()) {
+                        continue;
+                    }
+                    for (int candidate : found->second) {
+                        if (_vertices[candidate].Distance(corner) <= _options.WeldTolerance) {
+                            vertex = candidate;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        if (vertex < 0) {
+            vertex = static_cast<int>(_vertices.size());
+            _vertices.emplace_back(corner);
+            cells[cell].emplace_back(vertex);
+        }
+        _sides[i].StartCorner = vertex;
+    }
+    for (int i = 0; i < sideCount; i++) {
+        if (!_isFailed[i / 4]) {
+            _sides[i].EndCorner = _sides[i - i % 4 + (i + 1) % 4].StartCorner;
+        }
+    }
+}
+
+void LNLibEx::LNWatertightTessellator::ShareBoundaries()
+{
+    std::vector<int> candidates;
+    for (int i = 0; i < static_cast<int>(_sides.size()); i++) {
+        if (_isFailed[i / 4]) {
+            continue;
+        }
+        Side& side = _sides[i];
+        side.Owner = i;
+        if (side.StartCorner == side.EndCorner) {
+            double length = 0.0;
+            for (size_t k = 1; k < side.Points.size(); k++) {
+                length += side.Points[k].Distance(side.Points[k - 1]);
+            }
+            side.IsDegenerate = length <= _options.WeldTolerance;
+        }
+        if (!side.IsDegenerate) {
+            candidates.emplace_back(i);
+        }
+    }
+
+    auto getKey = [this](int side) {
+        return std::make_pair(std::min(_sides[side].StartCorner, _sides[side].EndCorner), std::max(_sides[side].StartCorner, _sides[side].EndCorner));
+    };
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+        return getKey(a) < getKey(b) || (getKey(a) == getKey(b) && a < b);
+    });
+
+    // Sides between the same corners form a group, sides of a group lying on each other share their samples.
+    std::vector<char> isGrouped(_sides.size(), 0);
+    for (size_t begin = 0, end = 0; begin < candidates.size(); begin = end) {
+        while (end < candidates.size() && getKey(candidates[end]) == getKey(candidates[begin])) {
+            end++;
+        }
+        for (size_t a = begin; a < end; a++) {
+            if (isGrouped[candidates[a]]) {
+                continue;
+            }
+            std::vector<int> cluster = { candidates[a] };
+            const Side& first = _sides[candidates[a]];
+            for (size_t b = a + 1; b < end; b++) {
+                const Side& other = _sides[candidates[b]];
+                if (!isGrouped[candidates[b]] &&
+                    IsOnSide(candidates[a], other.Points[other.Points.size() / 2]) &&
+                    IsOnSide(candidates[b], first.Points[first.Points.size() / 2])) {
+                    cluster.emplace_back(candidates[b]);
+                }
+            }
+
+            int owner = cluster[0];
+            for (int side : cluster) {
+                isGrouped[side] = 1;
+                if (_sides[side].Points.size() > _sides[owner].Points.size()) {
+                    owner = side;
+                }
+            }
+            const Side& ownerSide = _sides[owner];
+            for (int side : cluster) {
+                Side& member = _sides[side];
+                member.Owner = owner;
+                if (member.StartCorner != member.EndCorner) {
+                    member.IsReversed = member.StartCorner != ownerSide.StartCorner;
+                    continue;
+                }
+
+                // Closed loops: the first quarter of a matching member lies on the first half of the owner.
+                const LNLib::XYZ& quarter = member.Points[member.Points.size() / 4];
+                size_t nearest = 0;
+                for (size_t k = 1; k < ownerSide.Points.size(); k++) {
+                    if (ownerSide.Points[k].Distance(quarter) < ownerSide.Points[nearest].Distance(quarter)) {
+                        nearest = k;
+                    }
+                }
+                member.IsReversed = 2 * nearest > ownerSide.Points.size() - 1;
+            }
+        }
+    }
+}
+
+void LNLibEx::LNWatertightTessellator::AssignVertices()
+{
+    std::vector<int> members;
+    for (int i = 0; i < static_cast<int>(_sides.size()); i++) {
+        if (_isFailed[i / 4]) {
+            continue;
+        }
+        Side& side = _sides[i];
+        if (side.Owner != i) {
+            members.emplace_back(i);
+            continue;
+        }
+        if (side.IsDegenerate) {
+            side.Vertices = { side.StartCorner };
+            side.VertexParameters = { side.Parameters.front() };
+            continue;
+        }
+        side.Vertices.emplace_back(side.StartCorner);
+        for (size_t k = 1; k + 1 < side.Points.size(); k++) {
+            side.Vertices.emplace_back(static_cast<int>(_vertices.size()));
+            _vertices.emplace_back(side.Points[k]);
+        }
+        side.Vertices.emplace_back(side.EndCorner);
+        side.VertexParameters = side.Parameters;
+    }
+
+    // Members take the owner samples and look up their own parameters of them.
+    LNParallel::ForDynamic(0, static_cast<int64_t>(members.size()), [&](int64_t m) {
+        const int index = members[m];
+        Side& member = _sides[index];
+        const Side& owner = _sides[member.Owner];
+        const size_t count = owner.Vertices.size();
+        member.Vertices.resize(count);
+        member.VertexParameters.resize(count);
+
+        const double start = member.Parameters.front();
+        const double end = member.Parameters.back();
+        double previous = start;
+        for (size_t k = 0; k < count; k++) {
+            size_t source = member.IsReversed ? count - 1 - k : k;
+            member.Vertices[k] = owner.Vertices[source];
+            double parameter = start;
+            if (k == count - 1) {
+                parameter = end;
+            }
+            else if (k > 0) {
+                double fraction = getFraction(owner.VertexParameters[source], owner.Parameters.front(), owner.Parameters.back());
+                double seed = start + (end - start) * (member.IsReversed ? 1.0 - fraction : fraction);
+                parameter = ProjectToSide(index, owner.Points[source], seed);
+                // Keep samples in travel order when the projection is ambiguous.
+                parameter = start < end ? std::max(parameter, previous) : std::min(parameter, previous);
+            }
+            member.VertexParameters[k] = parameter;
+            previous = parameter;
+        }
+    });
+
+    const int surfaceCount = static_cast<int>(_surfaces.size());
+    _innerOffsets.assign(surfaceCount + 1, static_cast<int>(_vertices.size()));
+    for (int s = 0; s < surfaceCount; s++) {
+        int innerCount = _isFailed[s] ? 0 : static_cast<int>((_uParameters[s].size() - 2) * (_vParameters[s].size() - 2));
+        _innerOffsets[s + 1] = _innerOffsets[s] + innerCount;
+    }
+}
+
+void LNLibEx::LNWatertightTessellator::TessellatePatch(int surface, LNLib::LN_Mesh& mesh) const
+{
+    const LNLib::LN_NurbsSurface& nurbs = _surfaces[surface];
+    const std::vector<double>& u = _uParameters[surface];
+    const std::vector<double>& v = _vParameters[surface];
+    const int rows = static_cast<int>(u.size()) - 2;
+    const int columns = static_cast<int>(v.size()) - 2;
+
+    // Local nodes carry UV and normal of this patch, nodeVertices maps them to the welded vertices.
+    std::vector<int> nodeVertices;
+    auto addNode = [&](int vertex, const LNLib::UV& uv) {
+        nodeVertices.emplace_back(vertex);
+        mesh.UVs.emplace_back(uv);
+        mesh.Normals.emplace_back(LNAdaptiveTessellator::ComputeNormal(nurbs, uv));
+        return static_cast<int>(nodeVertices.size()) - 1;
+    };
+    auto addTriangle = [&](int a, int b, int c) {
+        if (nodeVertices[a] == nodeVertices[b] || nodeVertices[b] == nodeVertices[c] || nodeVertices[c] == nodeVertices[a]) {
+            return;
+        }
+        mesh.Faces.push_back({ nodeVertices[a], nodeVertices[b], nodeVertices[c] });
+        mesh.UVIndices.insert(mesh.UVIndices.end(), { a, b, c });
+        mesh.NormalIndices.insert(mesh.NormalIndices.end(), { a, b, c });
+    };
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < columns; j++) {
+            LNLib::UV uv(u[i + 1], v[j + 1]);
+            mesh.Vertices.emplace_back(LNLib::NurbsSurface::GetPointOnSurface(nurbs, uv));
+            addNode(_innerOffsets[surface] + i * columns + j, uv);
+        }
+    }
+    for (int i = 0; i + 1 < rows; i++) {
+        for (int j = 0; j + 1 < columns; j++) {
+            int p00 = i * columns + j;
+            int p10 = p00 + columns;
+            int p11 = p10 + 1;
+            int p01 = p00 + 1;
+            if (mesh.Vertices[p00].Distance(mesh.Vertices[p11]) <= mesh.Vertices[p10].Distance(mesh.Vertices[p01])) {
+                addTriangle(p00, p10, p11);
+                addTriangle(p00, p11, p01);
+            }
+            else {
+                addTriangle(p00, p10, p01);
+                addTriangle(p10, p11, p01);
+            }
+        }
+    }
+
+    for (int k = 0; k < 4; k++) {
+        const int sideIndex = 4 * surface + k;
+        const Side& side = _sides[sideIndex];
+        const double start = side.Parameters.front();
+        const double end = side.Parameters.back();
+
+        std::vector<int> outer;
+        std::vector<double> outerFractions;
+        for (size_t n = 0; n < side.Vertices.size(); n++) {
+            outer.emplace_back(addNode(side.Vertices[n], GetSideUV(sideIndex, side.VertexParameters[n])));
+            outerFractions.emplace_back(getFraction(side.VertexParameters[n], start, end));
+        }
+
+        // Interior grid line next to the side, in the travel direction of the side.
+        std::vector<int> inner;
+        std::vector<double> innerFractions;
+        const int count = k % 2 == 0 ? rows : columns;
+        for (int n = 0; n < count; n++) {
+            int i = 0, j = 0;
+            switch (k) {
+            case 0: i = n; j = 0; break;
+            case 1: i = rows - 1; j = n; break;
+            case 2: i = rows - 1 - n; j = columns - 1; break;
+            default: i = 0; j = columns - 1 - n; break;
+            }
+            inner.emplace_back(i * columns + j);
+            innerFractions.emplace_back(getFraction(k % 2 == 0 ? u[i + 1] : v[j + 1], start, end));
+        }
+
+        // Zip both polylines, always advancing the one whose next node comes first along the side.
+        size_t a = 0, b = 0;
+        while (a + 1 < outer.size() || b + 1 < inner.size()) {
+            bool isOuterNext = b + 1 >= inner.size() ||
+                (a + 1 < outer.size() && outerFractions[a + 1] <= innerFractions[b + 1]);
+            if (isOuterNext) {
+                addTriangle(outer[a], outer[a + 1], inner[b]);
+                a++;
+            }
+            else {
+                addTriangle(outer[a], inner[b + 1], inner[b]);
+                b++;
+            }
+        }
+    }
+}
+
+bool LNLibEx::LNWatertightTessellator::Process(LNLib::LN_Mesh& mesh)
+{
+    mesh = LNLib::LN_Mesh();
+    _vertices.clear();
+    SampleSurfaces();
+    WeldCorners();
+    ShareBoundaries();
+    AssignVertices();
+
+    const int surfaceCount = static_cast<int>(_surfaces.size());
+    std::vector<LNLib::LN_Mesh> patches(surfaceCount);
+    LNParallel::ForDynamic(0, surfaceCount, [&](int64_t s) {
+        if (_isFailed[s]) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        TessellatePatch(static_cast<int>(s), patches[s]);
+        _report.SurfaceSeconds[s] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    });
+
+    _report.FailedSurfaces.clear();
+    _report.VertexOffsets.clear();
+    _report.FaceOffsets.assign(surfaceCount + 1, 0);
+    std::vector<int> cornerOffsets(surfaceCount + 1, 0);
+    std::vector<int> nodeOffsets(surfaceCount + 1, 0);
+    for (int s = 0; s < surfaceCount; s++) {
+        if (_isFailed[s]) {
+            _report.FailedSurfaces.emplace_back(s);
+        }
+        _report.FaceOffsets[s + 1] = _report.FaceOffsets[s] + static_cast<int>(patches[s].Faces.size());
+        cornerOffsets[s + 1] = cornerOffsets[s] + static_cast<int>(patches[s].UVIndices.size());
+        nodeOffsets[s + 1] = nodeOffsets[s] + static_cast<int>(patches[s].UVs.size());
+    }
+
+    _vertices.resize(_innerOffsets.back());
+    mesh.Faces.resize(_report.FaceOffsets.back());
+    mesh.UVs.resize(nodeOffsets.back());
+    mesh.Normals.resize(nodeOffsets.back());
+    mesh.UVIndices.resize(cornerOffsets.back());
+    mesh.NormalIndices.resize(cornerOffsets.back());
+    LNParallel::ForDynamic(0, surfaceCount, [&](int64_t s) {
+        LNLib::LN_Mesh& patch = patches[s];
+        std::copy(patch.Vertices.begin(), patch.Vertices.end(), _vertices.begin() + _innerOffsets[s]);
+        std::move(patch.Faces.begin(), patch.Faces.end(), mesh.Faces.begin() + _report.FaceOffsets[s]);
+        std::copy(patch.UVs.begin(), patch.UVs.end(), mesh.UVs.begin() + nodeOffsets[s]);
+        std::copy(patch.Normals.begin(), patch.Normals.end(), mesh.Normals.begin() + nodeOffsets[s]);
+        for (size_t k = 0; k < patch.UVIndices.size(); k++) {
+            mesh.UVIndices[cornerOffsets[s] + k] = patch.UVIndices[k] + nodeOffsets[s];
+            mesh.NormalIndices[cornerOffsets[s] + k] = patch.NormalIndices[k] + nodeOffsets[s];
+        }
+    });
+    mesh.Vertices = std::move(_vertices);
+    _vertices.clear();
+    return _report.FailedSurfaces.empty();
+}
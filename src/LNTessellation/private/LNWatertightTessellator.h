@@ -0,0 +1,75 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "LNTessellationOptions.h"
+#include "LNTessellationReport.h"
+#include "LNObject.h"
+#include "XYZ.h"
+#include "UV.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	/// <summary>
+	/// Tessellate a set of patches into one welded mesh without cracks along shared boundaries.
+	/// 
+	/// Patch corners are welded by position. Boundaries running between the same corners and lying on each other
+	/// are sampled once by the patch with the densest sampling, the others find the parameters of those samples by projection.
+	/// Every patch keeps its own interior grid and is zipped to its boundary samples by a strip of triangles.
+	/// </summary>
+	class LNWatertightTessellator
+	{
+	private:
+
+		/// <summary>
+		/// Boundary k of a patch runs counter-clockwise in the parameter domain: v = v0, u = u1, v = v1, u = u0.
+		/// </summary>
+		struct Side
+		{
+			std::vector<double> Parameters;
+			std::vector<LNLib::XYZ> Points;
+			int StartCorner = -1;
+			int EndCorner = -1;
+			bool IsDegenerate = false;
+			int Owner = -1;
+			bool IsReversed = false;
+			std::vector<int> Vertices;
+			std::vector<double> VertexParameters;
+		};
+
+		const std::vector<LNLib::LN_NurbsSurface>& _surfaces;
+		const LNTessellationOptions& _options;
+		LNTessellationReport& _report;
+
+		std::vector<char> _isFailed;
+		std::vector<std::vector<double>> _uParameters;
+		std::vector<std::vector<double>> _vParameters;
+		std::vector<Side> _sides;
+		std::vector<LNLib::XYZ> _vertices;
+		std::vector<int> _innerOffsets;
+
+	private:
+
+		LNLib::UV GetSideUV(int side, double parameter) const;
+		double ProjectToSide(int side, const LNLib::XYZ& point, double seed) const;
+		bool IsOnSide(int side, const LNLib::XYZ& point) const;
+
+		void SampleSurfaces();
+		void WeldCorners();
+		void ShareBoundaries();
+		void AssignVertices();
+		void TessellatePatch(int surface, LNLib::LN_Mesh& mesh) const;
+
+	public:
+
+		LNWatertightTessellator(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNTessellationReport& report);
+		bool Process(LNLib::LN_Mesh& mesh);
+	};
+}
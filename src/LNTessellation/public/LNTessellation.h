@@ -0,0 +1,62 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNTessellationDefinitions.h"
+#include "LNTessellationOptions.h"
+#include "LNTessellationReport.h"
+#include "LNObject.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	class LNTessellation_EXPORT LNTessellation
+	{
+	public:
+
+		/// <summary>
+		/// Tessellate a single surface, return false if the surface is invalid.
+		/// </summary>
+		/// <remarks>
+		/// Adaptive mode emits triangles with per-vertex UVs and Normals, spans are refined along U and V independently
+		/// until ChordalTolerance and AngleTolerance hold, so flat spans get a single pair of triangles.
+		/// </remarks>
+		static bool Tessellate(const LNLib::LN_NurbsSurface& surface, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh);
+
+		/// <summary>
+		/// Tessellate all surfaces in parallel and merge them into one mesh, surface i owns
+		/// vertices [VertexOffsets[i], VertexOffsets[i + 1]) and faces [FaceOffsets[i], FaceOffsets[i + 1]) of report.
+		/// Return false if any surface failed, the others are still merged.
+		/// </summary>
+		/// <remarks>
+		/// Surfaces are handed to threads one at a time, so a few expensive surfaces do not stall the batch.
+		/// UVs and Normals are kept only when every surface mesh provides them per face corner.
+		/// </remarks>
+		static bool Tessellate(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh, LNTessellationReport& report);
+
+		/// <summary>
+		/// Tessellate all surfaces in parallel, one mesh per surface.
+		/// Offsets of report describe the meshes as if they were merged.
+		/// </summary>
+		static bool Tessellate(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, std::vector<LNLib::LN_Mesh>& meshes, LNTessellationReport& report);
+
+		/// <summary>
+		/// Tessellate all surfaces into one mesh whose vertices are shared across patch boundaries,
+		/// surface i owns faces [FaceOffsets[i], FaceOffsets[i + 1]) of report, VertexOffsets is left empty.
+		/// Return false if any surface failed, the others are still tessellated.
+		/// </summary>
+		/// <remarks>
+		/// Corners within WeldTolerance are merged. Boundaries are shared when they run between the same corners
+		/// and lie on each other, a boundary meeting several patches (T-junction) is not split and leaves a crack.
+		/// UVs and Normals are emitted per face corner, so a vertex on a boundary keeps the UV of each patch.
+		/// </remarks>
+		static bool TessellateWatertight(const std::vector<LNLib::LN_NurbsSurface>& surfaces, const LNTessellationOptions& options, LNLib::LN_Mesh& mesh, LNTessellationReport& report);
+	};
+}
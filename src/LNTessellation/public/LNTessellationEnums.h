@@ -0,0 +1,22 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#pragma once
+
+namespace LNLibEx
+{
+	enum class TessellationMode : int
+	{
+		// Fixed ResolutionU x ResolutionV samples by LNLib::NurbsSurface::Triangulate.
+		Uniform = 0,
+		// Samples per knot span follow curvature, bounded by chordal and angle tolerances.
+		Adaptive = 1,
+	};
+}
@@ -0,0 +1,53 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNTessellationDefinitions.h"
+#include "LNTessellationEnums.h"
+#include "Constants.h"
+#pragma once
+
+namespace LNLibEx
+{
+	struct LNTessellation_EXPORT LNTessellationOptions
+	{
+		TessellationMode Mode = TessellationMode::Uniform;
+
+		/// <summary>
+		/// Uniform mode: samples along U and V passed to LNLib::NurbsSurface::Triangulate.
+		/// </summary>
+		int ResolutionU = 16;
+		int ResolutionV = 16;
+
+		/// <summary>
+		/// Uniform mode: use the Delaunay based triangulation of LNLib, more accurate but slower.
+		/// </summary>
+		bool UseDelaunay = false;
+
+		/// <summary>
+		/// Adaptive mode: largest distance between a triangle and the surface.
+		/// </summary>
+		double ChordalTolerance = 1E-2;
+
+		/// <summary>
+		/// Adaptive mode: largest turn of the surface normal along one triangle edge, in radians.
+		/// </summary>
+		double AngleTolerance = LNLib::Constants::Pi / 12.0;
+
+		/// <summary>
+		/// Adaptive mode: upper bound of segments along U or V inside one knot span.
+		/// </summary>
+		int MaxSegmentsPerSpan = 256;
+
+		/// <summary>
+		/// Watertight mode: patch corners and boundary samples closer than this distance are merged.
+		/// </summary>
+		double WeldTolerance = 1E-6;
+	};
+}
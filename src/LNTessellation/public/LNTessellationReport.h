@@ -0,0 +1,40 @@
+/*
+ * Owner:
+ * 2026/10/18 - Yuqing Liang (BIMCoder Liang)
+ * bim.frankliang@foxmail.com
+ *
+ * Use of this source code is governed by a LGPL-2.1 license that can be found in
+ * the LICENSE file.
+ * 
+ */
+
+#include "LNTessellationDefinitions.h"
+#include <vector>
+#pragma once
+
+namespace LNLibEx
+{
+	struct LNTessellation_EXPORT LNTessellationReport
+	{
+		/// <summary>
+		/// Wall time spent on each surface in seconds.
+		/// </summary>
+		std::vector<double> SurfaceSeconds;
+
+		/// <summary>
+		/// Wall time of the whole batch in seconds, including merging.
+		/// </summary>
+		double TotalSeconds = 0.0;
+
+		/// <summary>
+		/// First vertex and first face of each surface in the merged mesh, with one extra entry holding the totals.
+		/// </summary>
+		std::vector<int> VertexOffsets;
+		std::vector<int> FaceOffsets;
+
+		/// <summary>
+		/// Surfaces which could not be tessellated, their meshes are left empty.
+		/// </summary>
+		std::vector<int> FailedSurfaces;
+	};
+}
@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 #include "T_Utils.h"
 #include "LNData.h"
+#include "LNSurfaceArchive.h"
 #include "LNObject.h"
 #include <string>
 
@@ -67,3 +68,49 @@ TEST(Test_LNData, ExportIGES)
     std::string exportPath = LNTest::GetProgramDir() + "\\IGESTest.igs";
     EXPECT_TRUE(LNLibEx::LNData::ToIGESFile(surfaces, exportPath));
 }
+
+TEST(Test_LNData, BinaryArchive)
+{
+    std::vector<LNLib::LN_NurbsSurface> surfaces;
+
+    LNLib::LN_NurbsSurface surface1;
+    surface1.DegreeU = 2;
+    surface1.DegreeV = 2;
+    surface1.KnotVectorU = { 0, 0, 0, 1, 1, 1 };
+    surface1.KnotVectorV = { 0, 0, 0, 1, 1, 1 };
+    surface1.ControlPoints = {
+        {{0, 0, 0, 1}, {1, 0, 0, 1}, {2, 0, 0, 1}},
+        {{0, 1, 0, 1}, {1, 1, 0, 1}, {2, 1, 0, 1}},
+        {{0, 2, 0, 1}, {1, 2, 0, 1}, {2, 2, 0, 1}}
+    };
+    surfaces.push_back(surface1);
+
+    LNLib::LN_NurbsSurface surface2;
+    surface2.DegreeU = 3;
+    surface2.DegreeV = 3;
+    surface2.KnotVectorU = { 0, 0, 0, 0, 1, 1, 1, 1 };
+    surface2.KnotVectorV = { 0, 0, 0, 0, 1, 1, 1, 1 };
+    surface2.ControlPoints = {
+        {{3, 0, 0, 1}, {4, 0, 0, 1}, {5, 0, 0, 1}, {6, 0, 0, 1}},
+        {{3, 1, 0, 1}, {4, 1, 0, 2}, {5, 1, 0, 1}, {6, 1, 0, 1}},
+        {{3, 2, 0, 1}, {4, 2, 0, 1}, {5, 2, 0, 2}, {6, 2, 0, 1}},
+        {{3, 3, 0, 1}, {4, 3, 0, 1}, {5, 3, 0, 1}, {6, 3, 0, 1}}
+    };
+    surfaces.push_back(surface2);
+    std::string exportPath = LNTest::GetProgramDir() + "\\BinaryTest.lns";
+    EXPECT_TRUE(LNLibEx::LNData::ToBinaryFile(surfaces, exportPath));
+
+    LNLibEx::LNSurfaceArchive archive;
+    EXPECT_TRUE(archive.Open(exportPath));
+    EXPECT_TRUE(archive.GetSurfaceCount() == 2);
+
+    LNLib::LN_NurbsSurface surface;
+    EXPECT_TRUE(archive.GetSurface(1, surface));
+    EXPECT_TRUE(surface.DegreeU == 3);
+    EXPECT_TRUE(surface.KnotVectorV == surface2.KnotVectorV);
+    EXPECT_TRUE(surface.ControlPoints[1][1].IsAlmostEqualTo(surface2.ControlPoints[1][1]));
+
+    std::vector<LNLib::LN_NurbsSurface> imported;
+    EXPECT_TRUE(LNLibEx::LNData::FromBinaryFile(exportPath, imported));
+    EXPECT_TRUE(imported.size() == 2);
+}
@@ -0,0 +1,406 @@
+#include "gtest/gtest.h"
+#include "T_Utils.h"
+#include "LNGridEvaluator.h"
+#include "LNBezierSurfaceCache.h"
+#include "LNSurfaceProjector.h"
+#include "LNCurveLocator.h"
+#include "LNSurfaceBVH.h"
+#include "LNSurfaceIntersector.h"
+#include "LNSurfaceRayCaster.h"
+#include "LNObject.h"
+#include "NurbsCurve.h"
+#include "NurbsSurface.h"
+#include "Constants.h"
+#include "XYZ.h"
+#include "XYZW.h"
+#include "UV.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    /// Half cylinder of radius 1 and height 2 around Z, rational with two spans along U.
+    LNLib::LN_NurbsSurface createCylinderSurface()
+    {
+        const double w = std::sqrt(0.5);
+        const double x[5] = { 1, 1, 0, -1, -1 };
+        const double y[5] = { 0, 1, 1, 1, 0 };
+        const double weights[5] = { 1, w, 1, w, 1 };
+
+        LNLib::LN_NurbsSurface surface;
+        surface.DegreeU = 2;
+        surface.DegreeV = 1;
+        surface.KnotVectorU = { 0, 0, 0, 0.5, 0.5, 1, 1, 1 };
+        surface.KnotVectorV = { 0, 0, 1, 1 };
+        for (int i = 0; i < 5; i++) {
+            surface.ControlPoints.push_back({ LNLib::XYZW(LNLib::XYZ(x[i], y[i], 0), weights[i]), LNLib::XYZW(LNLib::XYZ(x[i], y[i], 2), weights[i]) });
+        }
+        return surface;
+    }
+
+    /// Half circle of radius 1 around the origin in the XY plane, rational with two spans.
+    LNLib::LN_NurbsCurve createHalfCircle()
+    {
+        const double w = std::sqrt(0.5);
+        LNLib::LN_NurbsCurve curve;
+        curve.Degree = 2;
+        curve.KnotVector = { 0, 0, 0, 0.5, 0.5, 1, 1, 1 };
+        curve.ControlPoints = {
+            LNLib::XYZW(LNLib::XYZ(1, 0, 0), 1), LNLib::XYZW(LNLib::XYZ(1, 1, 0), w), LNLib::XYZW(LNLib::XYZ(0, 1, 0), 1),
+            LNLib::XYZW(LNLib::XYZ(-1, 1, 0), w), LNLib::XYZW(LNLib::XYZ(-1, 0, 0), 1)
+        };
+        return curve;
+    }
+}
+
+TEST(Test_LNGeometry, GridEvaluator)
+{
+    LNLib::LN_NurbsSurface surface = createCylinderSurface();
+    std::vector<double> u;
+    std::vector<double> v;
+    for (int i = 0; i <= 20; i++) {
+        u.push_back(i / 20.0);
+    }
+    for (int j = 0; j <= 7; j++) {
+        v.push_back(j / 7.0);
+    }
+
+    LNLibEx::LNGridEvaluator evaluator;
+    EXPECT_TRUE(evaluator.Build(surface, u, v));
+    EXPECT_TRUE(evaluator.GetCountU() == 21 && evaluator.GetCountV() == 8);
+
+    std::vector<LNLib::XYZ> points;
+    std::vector<LNLib::XYZ> derivativesU;
+    std::vector<LNLib::XYZ> derivativesV;
+    std::vector<LNLib::XYZ> normals;
+    evaluator.EvaluateDerivatives(points, derivativesU, derivativesV);
+    evaluator.EvaluateNormals(normals);
+    for (size_t i = 0; i < u.size(); i++) {
+        for (size_t j = 0; j < v.size(); j++) {
+            size_t index = i * v.size() + j;
+            LNLib::XYZ point, su, sv;
+            LNLib::NurbsSurface::ComputeRationalSurfaceFirstOrderDerivative(surface, LNLib::UV(u[i], v[j]), point, su, sv);
+            EXPECT_TRUE(points[index].Distance(point) < 1E-12);
+            EXPECT_TRUE(derivativesU[index].Distance(su) < 1E-10);
+            EXPECT_TRUE(derivativesV[index].Distance(sv) < 1E-10);
+            EXPECT_NEAR(std::hypot(points[index].GetX(), points[index].GetY()), 1.0, 1E-12);
+            EXPECT_NEAR(normals[index].Length(), 1.0, 1E-12);
+        }
+    }
+
+    u.push_back(1.5);
+    EXPECT_FALSE(evaluator.Build(surface, u, v));
+    EXPECT_TRUE(evaluator.IsEmpty());
+}
+
+TEST(Test_LNGeometry, BezierSurfaceCache)
+{
+    LNLib::LN_NurbsSurface surface = createCylinderSurface();
+    LNLibEx::LNBezierSurfaceCache cache;
+    EXPECT_TRUE(cache.Build(surface));
+    EXPECT_TRUE(cache.GetPatchCountU() == 2 && cache.GetPatchCountV() == 1);
+    EXPECT_TRUE(cache.GetPatchControlPoints(1, 0)[0].ToXYZ(true).Distance(LNLib::XYZ(0, 1, 0)) < 1E-12);
+
+    std::vector<LNLib::UV> uvs;
+    for (int i = 0; i <= 16; i++) {
+        for (int j = 0; j <= 4; j++) {
+            uvs.emplace_back(i / 16.0, j / 4.0);
+        }
+    }
+    std::vector<LNLib::XYZ> points;
+    std::vector<LNLib::XYZ> normals;
+    cache.GetPoints(uvs, points);
+    cache.GetNormals(uvs, normals);
+    for (size_t i = 0; i < uvs.size(); i++) {
+        LNLib::XYZ point, su, sv;
+        LNLib::NurbsSurface::ComputeRationalSurfaceFirstOrderDerivative(surface, uvs[i], point, su, sv);
+        LNLib::XYZ cachedPoint, cachedU, cachedV;
+        cache.GetDerivatives(uvs[i], cachedPoint, cachedU, cachedV);
+        EXPECT_TRUE(points[i].Distance(point) < 1E-12);
+        EXPECT_TRUE(cachedU.Distance(su) < 1E-10);
+        EXPECT_TRUE(cachedV.Distance(sv) < 1E-10);
+        EXPECT_TRUE(normals[i].Distance(su.CrossProduct(sv).Normalize()) < 1E-10);
+    }
+
+    surface.KnotVectorU.pop_back();
+    EXPECT_FALSE(cache.Build(surface));
+    EXPECT_TRUE(cache.IsEmpty());
+}
+
+TEST(Test_LNGeometry, SurfaceProjector)
+{
+    LNLib::LN_NurbsSurface surface = createCylinderSurface();
+    LNLibEx::LNSurfaceProjector projector;
+    EXPECT_TRUE(projector.Build(surface));
+
+    // Points around the half cylinder, the closest point keeps the angle and clamps the height.
+    std::vector<LNLib::XYZ> points;
+    std::vector<LNLib::XYZ> expected;
+    for (int i = 0; i <= 30; i++) {
+        double angle = LNLib::Constants::Pi * i / 30.0;
+        for (int j = -1; j <= 3; j++) {
+            points.emplace_back(2.0 * std::cos(angle), 2.0 * std::sin(angle), 0.75 * j);
+            expected.emplace_back(std::cos(angle), std::sin(angle), std::max(0.0, std::min(2.0, 0.75 * j)));
+        }
+    }
+    std::vector<LNLibEx::LNSurfaceProjection> projections;
+    projector.Project(points, projections);
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT_TRUE(projections[i].Point.Distance(expected[i]) < 1E-9);
+        EXPECT_NEAR(projections[i].Distance, points[i].Distance(expected[i]), 1E-9);
+        EXPECT_TRUE(LNLib::NurbsSurface::GetPointOnSurface(surface, projections[i].Parameter).Distance(expected[i]) < 1E-9);
+    }
+}
+
+TEST(Test_LNGeometry, CurveLocator)
+{
+    LNLib::LN_NurbsCurve curve = createHalfCircle();
+    LNLibEx::LNCurveLocator locator;
+    EXPECT_TRUE(locator.Build(curve));
+    EXPECT_NEAR(locator.GetLength(), LNLib::Constants::Pi, 1E-10);
+
+    // Points at spacing along the arc sit at angle = length on the unit circle.
+    std::vector<double> parameters = locator.GetParametersBySpacing(0.1);
+    EXPECT_TRUE(parameters.size() == 32);
+    for (size_t i = 0; i < parameters.size(); i++) {
+        LNLib::XYZ point = LNLib::NurbsCurve::GetPointOnCurve(curve, parameters[i]);
+        EXPECT_TRUE(point.Distance(LNLib::XYZ(std::cos(0.1 * i), std::sin(0.1 * i), 0)) < 1E-9);
+        EXPECT_NEAR(locator.GetLength(parameters[i]), 0.1 * i, 1E-10);
+    }
+
+    std::vector<LNLib::XYZ> points;
+    for (int i = 0; i <= 40; i++) {
+        double angle = LNLib::Constants::Pi * i / 40.0;
+        points.emplace_back(3.0 * std::cos(angle), 3.0 * std::sin(angle), 0.5);
+    }
+    locator.Project(points, parameters);
+    for (size_t i = 0; i < points.size(); i++) {
+        double angle = LNLib::Constants::Pi * i / 40.0;
+        EXPECT_TRUE(locator.GetPoint(parameters[i]).Distance(LNLib::XYZ(std::cos(angle), std::sin(angle), 0)) < 1E-9);
+    }
+
+    curve.KnotVector.pop_back();
+    EXPECT_FALSE(locator.Build(curve));
+}
+
+TEST(Test_LNGeometry, SurfaceBVH)
+{
+    // 5 x 5 half cylinders on a grid of spacing 3, surface 5 * i + j at (3 * i, 3 * j), and an invalid surface.
+    std::vector<LNLib::LN_NurbsSurface> surfaces;
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            LNLib::LN_NurbsSurface surface = createCylinderSurface();
+            for (std::vector<LNLib::XYZW>& row : surface.ControlPoints) {
+                for (LNLib::XYZW& point : row) {
+                    point = LNLib::XYZW(point.ToXYZ(true) + LNLib::XYZ(3.0 * i, 3.0 * j, 0), point.W());
+                }
+            }
+            surfaces.emplace_back(surface);
+        }
+    }
+    surfaces.emplace_back(createCylinderSurface());
+    surfaces.back().KnotVectorV.pop_back();
+
+    LNLibEx::LNSurfaceBVH bvh;
+    EXPECT_FALSE(bvh.Build(surfaces, false));
+    EXPECT_TRUE(bvh.GetPatchCount() == 25);
+    EXPECT_FALSE(bvh.Build(surfaces));
+    EXPECT_TRUE(bvh.GetPatchCount() == 50);
+
+    LNLib::XYZ minimum;
+    LNLib::XYZ maximum;
+    EXPECT_FALSE(bvh.GetBounds(25, minimum, maximum));
+    EXPECT_TRUE(bvh.GetBounds(7, minimum, maximum));
+    EXPECT_TRUE(minimum.Distance(LNLib::XYZ(2, 6, 0)) < 1E-12 && maximum.Distance(LNLib::XYZ(4, 7, 2)) < 1E-12);
+
+    // A ray along X through row j = 0 enters the cylinders in order.
+    std::vector<LNLibEx::LNPatchReference> patches;
+    bvh.Intersect(LNLib::XYZ(-5, 0.5, 1), LNLib::XYZ(1, 0, 0), patches);
+    EXPECT_TRUE(patches.size() == 10);
+    for (size_t k = 0; k < patches.size(); k++) {
+        EXPECT_TRUE(patches[k].Surface == 5 * static_cast<int>(k / 2));
+        EXPECT_TRUE(patches[k].PatchU == static_cast<int>(k % 2 == 0 ? 1 : 0));
+    }
+    bvh.Intersect(LNLib::XYZ(-5, 0.5, 1), LNLib::XYZ(1, 0, 0), patches, 5.5);
+    EXPECT_TRUE(patches.size() == 2);
+
+    std::vector<int> found;
+    bvh.GetSurfaces(LNLib::XYZ(5.5, 8.5, -1), LNLib::XYZ(6.5, 9.5, 3), found);
+    EXPECT_TRUE(found.size() == 1 && found[0] == 13);
+    bvh.GetSurfaces(LNLib::XYZ(-10, -10, 2.5), LNLib::XYZ(20, 20, 3), found);
+    EXPECT_TRUE(found.empty());
+
+    // The closest surface, found by projecting onto every surface, is always among the nearest patches.
+    std::vector<LNLibEx::LNSurfaceProjector> projectors(25);
+    for (int k = 0; k < 25; k++) {
+        projectors[k].Build(surfaces[k]);
+    }
+    for (int k = 0; k < 40; k++) {
+        LNLib::XYZ point(-1.0 + 0.37 * k, 13.0 - 0.31 * k, -0.5 + 0.08 * k);
+        int closest = -1;
+        double distance = LNLib::Constants::MaxDistance;
+        for (int s = 0; s < 25; s++) {
+            double candidate = projectors[s].Project(point).Distance;
+            if (candidate < distance) {
+                distance = candidate;
+                closest = s;
+            }
+        }
+
+        bvh.GetNearestPatches(point, patches);
+        bool isFound = false;
+        for (const LNLibEx::LNPatchReference& patch : patches) {
+            isFound = isFound || patch.Surface == closest;
+        }
+        EXPECT_TRUE(isFound);
+        EXPECT_TRUE(patches.front().Distance <= distance + 1E-12);
+    }
+}
+
+TEST(Test_LNGeometry, SurfaceIntersector)
+{
+    // Half cylinder, the plane z = 1 and a biquadratic bump of height 0.5, the plane z = 0.25 cuts the bump in a loop.
+    std::vector<LNLib::LN_NurbsSurface> surfaces(4);
+    surfaces[0] = createCylinderSurface();
+    LNLib::NurbsSurface::CreateBilinearSurface(LNLib::XYZ(-2, 2, 1), LNLib::XYZ(2, 2, 1), LNLib::XYZ(-2, -2, 1), LNLib::XYZ(2, -2, 1), surfaces[1]);
+    LNLib::LN_NurbsSurface& bump = surfaces[2];
+    bump.DegreeU = 2;
+    bump.DegreeV = 2;
+    bump.KnotVectorU = { 0, 0, 0, 1, 1, 1 };
+    bump.KnotVectorV = { 0, 0, 0, 1, 1, 1 };
+    for (int i = 0; i < 3; i++) {
+        bump.ControlPoints.emplace_back();
+        for (int j = 0; j < 3; j++) {
+            bump.ControlPoints[i].emplace_back(LNLib::XYZ(10.0 + i, j, i == 1 && j == 1 ? 2.0 : 0.0), 1.0);
+        }
+    }
+    LNLib::NurbsSurface::CreateBilinearSurface(LNLib::XYZ(9, 3, 0.25), LNLib::XYZ(13, 3, 0.25), LNLib::XYZ(9, -1, 0.25), LNLib::XYZ(13, -1, 0.25), surfaces[3]);
+
+    LNLibEx::LNSurfaceIntersector intersector;
+    EXPECT_TRUE(intersector.Build(surfaces));
+
+    // Pair queries of two surfaces match the pairs of all surfaces, with the first surface given first.
+    std::vector<std::pair<LNLibEx::LNPatchReference, LNLibEx::LNPatchReference>> allPairs;
+    std::vector<std::pair<LNLibEx::LNPatchReference, LNLibEx::LNPatchReference>> pairs;
+    intersector.GetBVH().GetOverlappingPatches(allPairs);
+    intersector.GetBVH().GetOverlappingPatches(0, 1, pairs);
+    EXPECT_TRUE(!pairs.empty() && pairs.size() == static_cast<size_t>(std::count_if(allPairs.begin(), allPairs.end(), [](const std::pair<LNLibEx::LNPatchReference, LNLibEx::LNPatchReference>& pair) {
+        return pair.first.Surface == 0 && pair.second.Surface == 1;
+    })));
+    intersector.GetBVH().GetOverlappingPatches(1, 0, pairs);
+    EXPECT_TRUE(!pairs.empty() && pairs.front().first.Surface == 1 && pairs.front().second.Surface == 0);
+    intersector.GetBVH().GetOverlappingPatches(0, 2, pairs);
+    EXPECT_TRUE(pairs.empty());
+
+    LNLibEx::LNIntersectionOptions options;
+    std::vector<LNLibEx::LNIntersectionCurve> curves;
+    intersector.IntersectAll(curves, options);
+    EXPECT_TRUE(curves.size() == 2);
+    if (curves.size() != 2) {
+        return;
+    }
+
+    // The half circle of radius 1 at z = 1, ending on the cylinder boundary.
+    const LNLibEx::LNIntersectionCurve& arc = curves[0];
+    EXPECT_TRUE(arc.SurfaceA == 0 && arc.SurfaceB == 1 && !arc.IsClosed);
+    EXPECT_TRUE(arc.Points.size() > 10);
+    for (const LNLibEx::LNIntersectionPoint& point : arc.Points) {
+        EXPECT_NEAR(std::hypot(point.Point.GetX(), point.Point.GetY()), 1.0, 1E-6);
+        EXPECT_NEAR(point.Point.GetZ(), 1.0, 1E-6);
+        EXPECT_TRUE(LNLib::NurbsSurface::GetPointOnSurface(surfaces[0], point.ParameterA).Distance(point.Point) < 1E-6);
+        EXPECT_TRUE(LNLib::NurbsSurface::GetPointOnSurface(surfaces[1], point.ParameterB).Distance(point.Point) < 1E-6);
+    }
+    LNLib::XYZ first = arc.Points.front().Point;
+    LNLib::XYZ last = arc.Points.back().Point;
+    EXPECT_NEAR(std::fabs(first.GetX() - last.GetX()), 2.0, 1E-6);
+    for (size_t i = 1; i < arc.Points.size(); i++) {
+        LNLib::XYZ middle = (arc.Points[i - 1].Point + arc.Points[i].Point) * 0.5;
+        EXPECT_TRUE(1.0 - std::hypot(middle.GetX(), middle.GetY()) <= options.ChordalTolerance);
+    }
+
+    const LNLibEx::LNIntersectionCurve& loop = curves[1];
+    EXPECT_TRUE(loop.SurfaceA == 2 && loop.SurfaceB == 3 && loop.IsClosed);
+    for (const LNLibEx::LNIntersectionPoint& point : loop.Points) {
+        EXPECT_NEAR(point.Point.GetZ(), 0.25, 1E-6);
+        EXPECT_TRUE(LNLib::NurbsSurface::GetPointOnSurface(surfaces[2], point.ParameterA).Distance(point.Point) < 1E-6);
+    }
+
+    // Intersect refills curves, which arc refers to.
+    const size_t arcPointCount = arc.Points.size();
+    intersector.Intersect(1, 0, curves, options);
+    EXPECT_TRUE(curves.size() == 1 && curves[0].SurfaceA == 1 && curves[0].Points.size() == arcPointCount);
+    intersector.Intersect(0, 2, curves, options);
+    EXPECT_TRUE(curves.empty());
+}
+
+TEST(Test_LNGeometry, SurfaceRayCaster)
+{
+    LNLib::LN_NurbsSurface surface = createCylinderSurface();
+    LNLibEx::LNSurfaceRayCaster caster;
+    EXPECT_TRUE(caster.Build(surface));
+    EXPECT_TRUE(!caster.IsEmpty() && caster.GetLeafCount() > 2);
+
+    // Rays from radius 3 toward the axis hit at t = 2, rays from the axis outward at t = 1, rays above miss.
+    std::vector<LNLib::XYZ> origins;
+    std::vector<LNLib::XYZ> directions;
+    for (int i = 0; i < 37; i++) {
+        double angle = LNLib::Constants::Pi * (i + 0.5) / 37;
+        double z = 2.0 * i / 36;
+        LNLib::XYZ direction(std::cos(angle), std::sin(angle), 0);
+        origins.emplace_back(direction * 3.0 + LNLib::XYZ(0, 0, z));
+        directions.emplace_back(-direction);
+        origins.emplace_back(LNLib::XYZ(0, 0, 1));
+        directions.emplace_back(direction);
+        origins.emplace_back(direction * 3.0 + LNLib::XYZ(0, 0, 3));
+        directions.emplace_back(-direction);
+    }
+
+    std::vector<LNLibEx::LNSurfaceHit> hits;
+    caster.Intersect(origins, directions, hits);
+    EXPECT_TRUE(hits.size() == origins.size());
+    for (size_t i = 0; i < hits.size(); i++) {
+        const LNLibEx::LNSurfaceHit& hit = hits[i];
+        LNLibEx::LNSurfaceHit single;
+        EXPECT_TRUE(caster.Intersect(origins[i], directions[i], single) == hit.IsHit);
+        EXPECT_TRUE(single.Distance == hit.Distance && single.Point.Distance(hit.Point) == 0.0);
+        if (i % 3 == 2) {
+            EXPECT_FALSE(hit.IsHit);
+            continue;
+        }
+        EXPECT_TRUE(hit.IsHit);
+        EXPECT_NEAR(hit.Distance, i % 3 == 0 ? 2.0 : 1.0, 1E-9);
+        EXPECT_TRUE(hit.Point.Distance(origins[i] + directions[i] * hit.Distance) < 1E-9);
+        EXPECT_TRUE(LNLib::NurbsSurface::GetPointOnSurface(surface, hit.Parameter).Distance(hit.Point) < 1E-9);
+        EXPECT_NEAR(hit.Parameter[1], hit.Point.GetZ() / 2.0, 1E-9);
+    }
+
+    LNLibEx::LNSurfaceHit hit;
+    EXPECT_FALSE(caster.Intersect(origins[0], directions[0], hit, 1.5));
+    EXPECT_TRUE(caster.Intersect(origins[0], -directions[0], hit) == false);
+
+    // A far camera aimed just beside dyadic parameters, which lie on the seams between subdivision leaves.
+    const LNLib::XYZ camera(3170, 2120, 10);
+    std::vector<LNLib::XYZ> targets;
+    origins.clear();
+    directions.clear();
+    for (int i = 1; i < 48; i++) {
+        for (int j = 0; j <= 16; j++) {
+            for (double offset : { -1E-5, -1E-7, 0.0, 1E-7, 1E-5 }) {
+                targets.emplace_back(LNLib::NurbsSurface::GetPointOnSurface(surface, LNLib::UV(i / 96.0 + offset, j / 16.0)));
+                origins.emplace_back(camera);
+                directions.emplace_back(targets.back() - camera);
+            }
+        }
+    }
+    caster.Intersect(origins, directions, hits);
+    int missCount = 0;
+    for (size_t i = 0; i < hits.size(); i++) {
+        missCount += hits[i].IsHit && hits[i].Point.Distance(targets[i]) < 1E-9 ? 0 : 1;
+    }
+    EXPECT_TRUE(missCount == 0);
+
+    surface.KnotVectorU.pop_back();
+    EXPECT_FALSE(caster.Build(surface));
+    EXPECT_TRUE(caster.IsEmpty());
+}
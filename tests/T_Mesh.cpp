@@ -1,8 +1,17 @@
 #include "gtest/gtest.h"
 #include "T_Utils.h"
 #include "LNMesh.h"
+#include "LNMeshTopology.h"
+#include "LNMeshBVH.h"
+#include "LNMeshLOD.h"
+#include "LNVertexArray.h"
+#include "LNMeshCodec.h"
 #include "LNObject.h"
 #include <string>
+#include <cstring>
+#include <map>
+#include <algorithm>
+#include <cmath>
 
 //#include "LNMeshEx.h"
 
@@ -22,4 +31,450 @@ TEST(Test_LNMesh, ImportSTL)
     LNLibEx::LNMesh::FromSTLFile(stlTestFile, mesh);
     EXPECT_TRUE(mesh.Faces.size() == 12);
     EXPECT_TRUE(mesh.Vertices.size() == 36);
+}
+
+TEST(Test_LNMesh, BinaryRoundTrip)
+{
+    std::string stlTestFile = LNTest::GetTestDir() + "cube.stl";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromSTLFile(stlTestFile, mesh);
+
+    std::string cachePath = LNTest::GetProgramDir() + "\\cube.lnm";
+    EXPECT_TRUE(LNLibEx::LNMesh::ToBinaryFile(mesh, cachePath));
+
+    LNLib::LN_Mesh cached;
+    EXPECT_TRUE(LNLibEx::LNMesh::FromBinaryFile(cachePath, cached));
+    EXPECT_TRUE(cached.Faces == mesh.Faces);
+    EXPECT_TRUE(cached.Vertices.size() == mesh.Vertices.size());
+    EXPECT_TRUE(cached.NormalIndices == mesh.NormalIndices);
+    EXPECT_TRUE(cached.Vertices[5].IsAlmostEqualTo(mesh.Vertices[5]));
+}
+
+TEST(Test_LNMesh, ComputeVertexNormals)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+
+    EXPECT_TRUE(LNLibEx::LNMesh::ComputeVertexNormals(mesh));
+    EXPECT_TRUE(mesh.Normals.size() == 8);
+    EXPECT_TRUE(mesh.NormalIndices.size() == 36);
+
+    EXPECT_TRUE(LNLibEx::LNMesh::ComputeVertexNormals(mesh, LNLibEx::NormalWeighting::Area, LNLib::Constants::Pi / 4));
+    EXPECT_TRUE(mesh.Normals.size() == 24);
+    EXPECT_TRUE(mesh.NormalIndices.size() == 36);
+}
+
+TEST(Test_LNMesh, Topology)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+
+    LNLibEx::LNMeshTopology topology;
+    EXPECT_TRUE(topology.Build(mesh));
+    EXPECT_TRUE(topology.GetHalfEdgeCount() == 36);
+    EXPECT_TRUE(topology.GetEdgeCount() == 18);
+    EXPECT_TRUE(topology.IsClosed());
+    int twin = topology.GetTwin(0);
+    EXPECT_TRUE(topology.GetTwin(twin) == 0);
+    EXPECT_TRUE(topology.GetOrigin(twin) == topology.GetTarget(0));
+
+    std::string stlTestFile = LNTest::GetTestDir() + "cube.stl";
+    LNLib::LN_Mesh soup;
+    LNLibEx::LNMesh::FromSTLFile(stlTestFile, soup);
+    EXPECT_TRUE(topology.Build(soup));
+    EXPECT_TRUE(topology.GetBoundaryEdges().size() == 36);
+}
+
+TEST(Test_LNMesh, BVH)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+
+    LNLibEx::LNMeshBVH bvh;
+    EXPECT_TRUE(bvh.Build(mesh));
+
+    LNLibEx::LNMeshHit hit;
+    EXPECT_TRUE(bvh.Intersect(LNLib::XYZ(0.5, 0.5, 3.0), LNLib::XYZ(0, 0, -1), hit));
+    EXPECT_NEAR(hit.Distance, 2.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_FALSE(bvh.Intersect(LNLib::XYZ(2.0, 2.0, 3.0), LNLib::XYZ(0, 0, -1), hit));
+
+    std::vector<LNLib::XYZ> points = { LNLib::XYZ(0.5, 0.5, 2.0), LNLib::XYZ(2.0, 0.5, 0.5), LNLib::XYZ(0.5, 0.5, 0.4) };
+    std::vector<LNLibEx::LNMeshHit> hits;
+    bvh.GetClosestPoints(points, hits);
+    EXPECT_NEAR(hits[0].Distance, 1.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_NEAR(hits[1].Distance, 1.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_NEAR(hits[2].Distance, 0.4, LNLib::Constants::DoubleEpsilon);
+
+    // Rays from a far camera aimed just beside the grid lines must find the same hit as brute force.
+    LNLib::LN_Mesh field;
+    int size = 65;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            double x = i / 64.0;
+            double y = j / 64.0;
+            field.Vertices.emplace_back(x, y, 0.05 * std::sin(6.0 * x) * std::cos(5.0 * y));
+        }
+    }
+    for (int i = 0; i + 1 < size; i++) {
+        for (int j = 0; j + 1 < size; j++) {
+            int index = i * size + j;
+            field.Faces.push_back({ index, index + size, index + size + 1 });
+            field.Faces.push_back({ index, index + size + 1, index + 1 });
+        }
+    }
+    EXPECT_TRUE(bvh.Build(field));
+
+    LNLib::XYZ camera(3170.3, 2120.7, 1000.1);
+    std::vector<LNLib::XYZ> origins;
+    std::vector<LNLib::XYZ> directions;
+    const double offsets[] = { -1E-7, 1E-7 };
+    for (int i = 1; i < size - 1; i++) {
+        for (int j = 1; j < size - 1; j += 3) {
+            for (double offset : offsets) {
+                double seam = i / 64.0 + offset;
+                double across = j / 64.0 + 0.3 / 64.0;
+                LNLib::XYZ targets[2] = { LNLib::XYZ(seam, across, 0.05 * std::sin(6.0 * seam) * std::cos(5.0 * across)),
+                                          LNLib::XYZ(across, seam, 0.05 * std::sin(6.0 * across) * std::cos(5.0 * seam)) };
+                for (const LNLib::XYZ& target : targets) {
+                    origins.emplace_back(camera);
+                    directions.emplace_back(target - camera);
+                }
+            }
+        }
+    }
+    bvh.Intersect(origins, directions, hits);
+
+    auto bruteForce = [&](const LNLib::XYZ& origin, const LNLib::XYZ& direction) {
+        double best = -1.0;
+        for (const std::vector<int>& face : field.Faces) {
+            LNLib::XYZ a = field.Vertices[face[0]];
+            LNLib::XYZ e1 = field.Vertices[face[1]] - a;
+            LNLib::XYZ e2 = field.Vertices[face[2]] - a;
+            LNLib::XYZ p = direction.CrossProduct(e2);
+            double determinant = e1.DotProduct(p);
+            if (determinant == 0.0) {
+                continue;
+            }
+            LNLib::XYZ s = origin - a;
+            double u = s.DotProduct(p) / determinant;
+            LNLib::XYZ q = s.CrossProduct(e1);
+            double v = direction.DotProduct(q) / determinant;
+            double t = e2.DotProduct(q) / determinant;
+            if (u >= 0.0 && v >= 0.0 && u + v <= 1.0 && t >= 0.0 && (best < 0.0 || t < best)) {
+                best = t;
+            }
+        }
+        return best;
+    };
+    int mismatchCount = 0;
+    for (size_t i = 0; i < origins.size(); i++) {
+        double expected = bruteForce(origins[i], directions[i]);
+        bool isSame = expected < 0.0 ? hits[i].Face < 0 : hits[i].Face >= 0 && std::fabs(hits[i].Distance - expected) < 1E-9;
+        mismatchCount += isSame ? 0 : 1;
+    }
+    EXPECT_TRUE(mismatchCount == 0);
+}
+
+
+TEST(Test_LNMesh, Simplify)
+{
+    LNLib::LN_Mesh grid;
+    int size = 20;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            grid.Vertices.emplace_back(i, j, 0);
+        }
+    }
+    for (int i = 0; i + 1 < size; i++) {
+        for (int j = 0; j + 1 < size; j++) {
+            int index = i * size + j;
+            grid.Faces.push_back({ index, index + size, index + size + 1, index + 1 });
+        }
+    }
+
+    LNLib::LN_Mesh result;
+    std::vector<int> vertexMap;
+    EXPECT_TRUE(LNLibEx::LNMesh::Simplify(grid, 100, result, vertexMap));
+    EXPECT_TRUE(result.Faces.size() <= 100);
+    EXPECT_TRUE(vertexMap.size() == grid.Vertices.size());
+
+    LNLibEx::LNMeshTopology topology;
+    EXPECT_TRUE(topology.Build(result));
+    EXPECT_TRUE(topology.IsManifold());
+    EXPECT_TRUE(topology.GetMisorientedEdges().empty());
+
+    // Heavy reduction keeps the open border a single loop of edges with exactly one face each.
+    EXPECT_TRUE(LNLibEx::LNMesh::Simplify(grid, 8, result, vertexMap));
+    std::map<std::pair<int, int>, int> edgeFaces;
+    for (const std::vector<int>& face : result.Faces) {
+        for (size_t i = 0; i < face.size(); i++) {
+            int a = face[i];
+            int b = face[(i + 1) % face.size()];
+            edgeFaces[{ std::min(a, b), std::max(a, b) }]++;
+        }
+    }
+    std::vector<int> boundaryDegrees(result.Vertices.size(), 0);
+    int boundaryEdges = 0;
+    for (const auto& edge : edgeFaces) {
+        EXPECT_TRUE(edge.second <= 2);
+        if (edge.second == 1) {
+            boundaryDegrees[edge.first.first]++;
+            boundaryDegrees[edge.first.second]++;
+            boundaryEdges++;
+        }
+    }
+    EXPECT_TRUE(boundaryEdges >= 4);
+    for (int degree : boundaryDegrees) {
+        EXPECT_TRUE(degree == 0 || degree == 2);
+    }
+}
+
+TEST(Test_LNMesh, LOD)
+{
+    LNLib::LN_Mesh grid;
+    int size = 20;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            grid.Vertices.emplace_back(i, j, 0.1 * (i % 3) * (j % 2));
+        }
+    }
+    for (int i = 0; i + 1 < size; i++) {
+        for (int j = 0; j + 1 < size; j++) {
+            int index = i * size + j;
+            grid.Faces.push_back({ index, index + size, index + size + 1, index + 1 });
+        }
+    }
+
+    LNLibEx::LNMeshLOD lod;
+    EXPECT_TRUE(lod.Build(grid, 3));
+    EXPECT_TRUE(lod.GetLevelCount() == 3);
+    EXPECT_TRUE(lod.GetLevelFaceCount(0) == 2 * 19 * 19);
+    EXPECT_TRUE(lod.GetLevelFaceCount(2) < lod.GetLevelFaceCount(1));
+    EXPECT_TRUE(lod.GetLevelVertexCount(2) <= lod.GetLevelVertexCount(1));
+    EXPECT_TRUE(lod.GetVertexRemap(2)[0] < lod.GetLevelVertexCount(2));
+
+    std::string exportPath = LNTest::GetProgramDir() + "\\LODTest.lnl";
+    EXPECT_TRUE(lod.Write(exportPath));
+    LNLibEx::LNMeshLOD loaded;
+    EXPECT_TRUE(loaded.Read(exportPath));
+    EXPECT_TRUE(loaded.GetLevelFaceCount(2) == lod.GetLevelFaceCount(2));
+
+    LNLib::LN_Mesh coarse;
+    EXPECT_TRUE(loaded.GetLevel(2, coarse));
+    EXPECT_TRUE(coarse.Vertices.size() == static_cast<size_t>(lod.GetLevelVertexCount(2)));
+}
+
+TEST(Test_LNMesh, OptimizeVertexCache)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+    LNLib::LN_Mesh original = mesh;
+
+    EXPECT_TRUE(LNLibEx::LNMesh::OptimizeVertexCache(mesh));
+    EXPECT_TRUE(mesh.Faces.size() == original.Faces.size());
+    EXPECT_TRUE(mesh.Vertices.size() == original.Vertices.size());
+    EXPECT_TRUE(mesh.Faces[0][0] == 0);
+    EXPECT_TRUE(mesh.UVIndices.size() == original.UVIndices.size());
+    EXPECT_TRUE(mesh.NormalIndices.size() == original.NormalIndices.size());
+
+    // Faces listing a vertex twice are kept and ordered like any other.
+    LNLib::LN_Mesh degenerate;
+    for (int i = 0; i < 6; i++) {
+        degenerate.Vertices.emplace_back(i, i % 2, 0);
+    }
+    degenerate.Faces = { { 0, 1, 1 }, { 1, 2, 3 }, { 2, 2, 2 }, { 3, 4, 5 }, { 0, 1, 2, 1 } };
+    LNLib::LN_Mesh optimized = degenerate;
+    EXPECT_TRUE(LNLibEx::LNMesh::OptimizeVertexCache(optimized));
+    EXPECT_TRUE(optimized.Faces.size() == 5 && optimized.Vertices.size() == 6);
+    EXPECT_TRUE(optimized.Faces[0][0] == 0);
+    auto getCorners = [](const LNLib::LN_Mesh& source) {
+        std::vector<std::vector<double>> corners;
+        for (const std::vector<int>& face : source.Faces) {
+            std::vector<double> coordinates;
+            for (int v : face) {
+                coordinates.insert(coordinates.end(), { source.Vertices[v].GetX(), source.Vertices[v].GetY() });
+            }
+            corners.emplace_back(coordinates);
+        }
+        std::sort(corners.begin(), corners.end());
+        return corners;
+    };
+    EXPECT_TRUE(getCorners(optimized) == getCorners(degenerate));
+}
+
+TEST(Test_LNMesh, SortSpatially)
+{
+    std::string stlTestFile = LNTest::GetTestDir() + "cube.stl";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromSTLFile(stlTestFile, mesh);
+    LNLib::LN_Mesh original = mesh;
+
+    EXPECT_TRUE(LNLibEx::LNMesh::SortSpatially(mesh, LNLibEx::SpaceFillingCurve::Hilbert));
+    EXPECT_TRUE(mesh.Faces.size() == original.Faces.size());
+    EXPECT_TRUE(mesh.Vertices.size() == original.Vertices.size());
+    EXPECT_NEAR(mesh.Vertices[0].GetX(), 0.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_NEAR(mesh.Vertices[0].GetY(), 0.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_NEAR(mesh.Vertices[0].GetZ(), 0.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_TRUE(LNLibEx::LNMesh::SortSpatially(mesh, LNLibEx::SpaceFillingCurve::Morton));
+}
+
+TEST(Test_LNMesh, VertexArray)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+
+    LNLibEx::LNVertexArray vertices(mesh.Vertices);
+    EXPECT_TRUE(vertices.GetCount() == static_cast<int>(mesh.Vertices.size()));
+    vertices.Transform(LNLib::Matrix4d::CreateTranslation(LNLib::XYZ(1, 2, 3)));
+
+    LNLib::XYZ minimum, maximum;
+    EXPECT_TRUE(vertices.GetBounds(minimum, maximum));
+    EXPECT_NEAR(minimum.GetX(), 1.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_NEAR(maximum.GetZ(), 4.0, LNLib::Constants::DoubleEpsilon);
+    LNLib::XYZ centroid = vertices.GetCentroid();
+    EXPECT_NEAR(centroid.GetY(), 2.5, LNLib::Constants::DoubleEpsilon);
+
+    std::vector<LNLib::XYZ> result;
+    vertices.CopyTo(result);
+    EXPECT_NEAR(result[0].GetX(), mesh.Vertices[0].GetX() + 1.0, LNLib::Constants::DoubleEpsilon);
+}
+
+TEST(Test_LNMesh, FloatMesh)
+{
+    std::string stlTestFile = LNTest::GetTestDir() + "cube.stl";
+    LNLibEx::LNFloatMesh floatMesh;
+    EXPECT_TRUE(LNLibEx::LNMesh::FromSTLFile(stlTestFile, floatMesh));
+    EXPECT_TRUE(floatMesh.Vertices.size() == 3 * 36);
+    EXPECT_TRUE(floatMesh.FaceOffsets.size() == 13);
+
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::ToMesh(floatMesh, mesh);
+    LNLib::LN_Mesh expected;
+    LNLibEx::LNMesh::FromSTLFile(stlTestFile, expected);
+    EXPECT_TRUE(mesh.Faces == expected.Faces);
+    EXPECT_NEAR(mesh.Vertices[5].GetY(), expected.Vertices[5].GetY(), LNLib::Constants::DoubleEpsilon);
+
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    EXPECT_TRUE(LNLibEx::LNMesh::FromOBJFile(objTestFile, floatMesh));
+    EXPECT_TRUE(floatMesh.Vertices.size() == 3 * 8);
+}
+
+TEST(Test_LNMesh, Codec)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+
+    std::vector<unsigned char> data;
+    EXPECT_TRUE(LNLibEx::LNMeshCodec::Encode(mesh, data));
+    LNLib::LN_Mesh decoded;
+    EXPECT_TRUE(LNLibEx::LNMeshCodec::Decode(data.data(), data.size(), decoded));
+    EXPECT_TRUE(decoded.Faces == mesh.Faces);
+    EXPECT_TRUE(decoded.UVIndices == mesh.UVIndices);
+    EXPECT_TRUE(decoded.NormalIndices == mesh.NormalIndices);
+    for (size_t i = 0; i < mesh.Vertices.size(); i++) {
+        EXPECT_NEAR(decoded.Vertices[i].Distance(mesh.Vertices[i]), 0.0, LNLib::Constants::DoubleEpsilon);
+    }
+    std::vector<unsigned char> corrupt = data;
+    corrupt[corrupt.size() / 2] ^= 0xFF;
+    EXPECT_FALSE(LNLibEx::LNMeshCodec::Decode(corrupt.data(), corrupt.size(), decoded));
+
+    // Face and corner counts (header bytes 20 and 24) far beyond their sections are rejected without allocating.
+    corrupt = data;
+    const uint32_t counts[2] = { 0x10000000u, 0x30000000u };
+    std::memcpy(corrupt.data() + 20, counts, sizeof(counts));
+    EXPECT_FALSE(LNLibEx::LNMeshCodec::Decode(corrupt.data(), corrupt.size(), decoded));
+
+    std::string exportPath = LNTest::GetProgramDir() + "\\CompressedTest.lnc";
+    EXPECT_TRUE(LNLibEx::LNMesh::ToCompressedFile(mesh, exportPath));
+    EXPECT_TRUE(LNLibEx::LNMesh::FromCompressedFile(exportPath, decoded));
+    EXPECT_TRUE(decoded.Faces == mesh.Faces);
+}
+
+TEST(Test_LNMesh, Repair)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+    std::vector<std::vector<int>> faces = mesh.Faces;
+
+    std::reverse(mesh.Faces[0].begin(), mesh.Faces[0].end());
+    mesh.Faces.push_back(faces[1]);
+    mesh.Faces.push_back({ 0, 1, 1 });
+
+    LNLibEx::LNMeshRepairReport report;
+    EXPECT_TRUE(LNLibEx::LNMesh::Repair(mesh, report));
+    EXPECT_TRUE(report.DegenerateFaces == 1);
+    EXPECT_TRUE(report.DuplicateFaces == 1);
+    EXPECT_TRUE(report.FlippedFaces == 1);
+    EXPECT_TRUE(report.ComponentCount == 1);
+    EXPECT_TRUE(report.Holes.empty());
+    EXPECT_TRUE(mesh.Faces == faces);
+
+    mesh.Faces.pop_back();
+    EXPECT_TRUE(LNLibEx::LNMesh::Repair(mesh, report));
+    EXPECT_TRUE(report.Holes.size() == 1);
+    EXPECT_TRUE(report.Holes[0].size() == 3);
+}
+
+TEST(Test_LNMesh, SplitComponents)
+{
+    std::string stlTestFile = LNTest::GetTestDir() + "cube.stl";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromSTLFile(stlTestFile, mesh);
+    const int vertexCount = static_cast<int>(mesh.Vertices.size());
+    const int faceCount = static_cast<int>(mesh.Faces.size());
+
+    LNLib::LN_Mesh bodies = mesh;
+    for (int i = 0; i < vertexCount; i++) {
+        bodies.Vertices.emplace_back(mesh.Vertices[i] + LNLib::XYZ(5, 0, 0));
+    }
+    for (auto face : mesh.Faces) {
+        for (int& index : face) {
+            index += vertexCount;
+        }
+        bodies.Faces.emplace_back(face);
+    }
+    bodies.NormalIndices.insert(bodies.NormalIndices.end(), mesh.NormalIndices.begin(), mesh.NormalIndices.end());
+
+    std::vector<int> faceOrder;
+    std::vector<int> componentOffsets;
+    EXPECT_TRUE(LNLibEx::LNMesh::GetComponents(bodies, faceOrder, componentOffsets));
+    EXPECT_TRUE(componentOffsets.size() == 3);
+    EXPECT_TRUE(componentOffsets[1] == faceCount);
+    EXPECT_TRUE(LNLibEx::LNMesh::GetComponents(bodies, faceOrder, componentOffsets, false));
+    EXPECT_TRUE(componentOffsets.size() == 2 * mesh.Faces.size() + 1);
+
+    std::vector<LNLib::LN_Mesh> components;
+    EXPECT_TRUE(LNLibEx::LNMesh::SplitComponents(bodies, components));
+    EXPECT_TRUE(components.size() == 2);
+    EXPECT_TRUE(components[1].Faces == mesh.Faces);
+    EXPECT_NEAR(components[1].Vertices[0].GetX(), mesh.Vertices[0].GetX() + 5, LNLib::Constants::DoubleEpsilon);
+}
+
+TEST(Test_LNMesh, MassProperties)
+{
+    std::string objTestFile = LNTest::GetTestDir() + "cube.obj";
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNMesh::FromOBJFile(objTestFile, mesh);
+
+    LNLibEx::LNMassProperties properties;
+    EXPECT_TRUE(LNLibEx::LNMesh::ComputeMassProperties(mesh, properties));
+    EXPECT_NEAR(properties.Area, 6.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_NEAR(properties.Volume, 1.0, LNLib::Constants::DoubleEpsilon);
+    EXPECT_TRUE(properties.Centroid.IsAlmostEqualTo(LNLib::XYZ(0.5, 0.5, 0.5)));
+    for (int i = 0; i < 9; i++) {
+        EXPECT_NEAR(properties.Inertia[i], i % 4 == 0 ? 1.0 / 6.0 : 0.0, LNLib::Constants::DoubleEpsilon);
+    }
+
+    std::string stlTestFile = LNTest::GetTestDir() + "cube.stl";
+    LNLibEx::LNMassProperties streamed;
+    EXPECT_TRUE(LNLibEx::LNMesh::ComputeMassPropertiesFromSTLFile(stlTestFile, streamed));
+    EXPECT_NEAR(streamed.Volume, properties.Volume, LNLib::Constants::DoubleEpsilon);
+    EXPECT_TRUE(streamed.Centroid.IsAlmostEqualTo(properties.Centroid));
 }
\ No newline at end of file
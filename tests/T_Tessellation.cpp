@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include "T_Utils.h"
+#include "LNTessellation.h"
+#include "LNObject.h"
+#include "NurbsSurface.h"
+#include "XYZ.h"
+#include "UV.h"
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    LNLib::LN_NurbsSurface createBumpSurface(double offsetX)
+    {
+        LNLib::LN_NurbsSurface surface;
+        surface.DegreeU = 2;
+        surface.DegreeV = 2;
+        surface.KnotVectorU = { 0, 0, 0, 1, 1, 1 };
+        surface.KnotVectorV = { 0, 0, 0, 1, 1, 1 };
+        surface.ControlPoints = {
+            {{offsetX + 0, 0, 0, 1}, {offsetX + 1, 0, 0, 1}, {offsetX + 2, 0, 0, 1}},
+            {{offsetX + 0, 1, 0, 1}, {offsetX + 1, 1, 1, 1}, {offsetX + 2, 1, 0, 1}},
+            {{offsetX + 0, 2, 0, 1}, {offsetX + 1, 2, 0, 1}, {offsetX + 2, 2, 0, 1}}
+        };
+        return surface;
+    }
+}
+
+TEST(Test_LNTessellation, Batch)
+{
+    std::vector<LNLib::LN_NurbsSurface> surfaces;
+    for (int i = 0; i < 8; i++) {
+        surfaces.push_back(createBumpSurface(3.0 * i));
+    }
+
+    LNLibEx::LNTessellationOptions options;
+    options.ResolutionU = 8;
+    options.ResolutionV = 8;
+
+    std::vector<LNLib::LN_Mesh> meshes;
+    LNLibEx::LNTessellationReport report;
+    EXPECT_TRUE(LNLibEx::LNTessellation::Tessellate(surfaces, options, meshes, report));
+    EXPECT_TRUE(meshes.size() == surfaces.size());
+    EXPECT_TRUE(report.SurfaceSeconds.size() == surfaces.size());
+
+    LNLib::LN_Mesh mesh;
+    EXPECT_TRUE(LNLibEx::LNTessellation::Tessellate(surfaces, options, mesh, report));
+    EXPECT_TRUE(report.FailedSurfaces.empty());
+    EXPECT_TRUE(report.VertexOffsets.back() == static_cast<int>(mesh.Vertices.size()));
+    EXPECT_TRUE(report.FaceOffsets.back() == static_cast<int>(mesh.Faces.size()));
+    for (size_t i = 0; i < surfaces.size(); i++) {
+        EXPECT_TRUE(report.VertexOffsets[i + 1] - report.VertexOffsets[i] == static_cast<int>(meshes[i].Vertices.size()));
+        for (int f = report.FaceOffsets[i]; f < report.FaceOffsets[i + 1]; f++) {
+            for (int index : mesh.Faces[f]) {
+                EXPECT_TRUE(index >= report.VertexOffsets[i] && index < report.VertexOffsets[i + 1]);
+            }
+        }
+    }
+
+    surfaces[3].KnotVectorU.pop_back();
+    EXPECT_FALSE(LNLibEx::LNTessellation::Tessellate(surfaces, options, mesh, report));
+    EXPECT_TRUE(report.FailedSurfaces.size() == 1 && report.FailedSurfaces[0] == 3);
+    EXPECT_TRUE(report.VertexOffsets[4] == report.VertexOffsets[3]);
+}
+
+TEST(Test_LNTessellation, Adaptive)
+{
+    LNLibEx::LNTessellationOptions options;
+    options.Mode = LNLibEx::TessellationMode::Adaptive;
+    options.ChordalTolerance = 1E-3;
+
+    LNLib::LN_NurbsSurface plane;
+    LNLib::NurbsSurface::CreateBilinearSurface(LNLib::XYZ(0, 2, 0), LNLib::XYZ(2, 2, 0), LNLib::XYZ(0, 0, 0), LNLib::XYZ(2, 0, 0), plane);
+    LNLib::LN_Mesh mesh;
+    EXPECT_TRUE(LNLibEx::LNTessellation::Tessellate(plane, options, mesh));
+    EXPECT_TRUE(mesh.Faces.size() == 2);
+
+    LNLib::LN_NurbsSurface bump = createBumpSurface(0.0);
+    EXPECT_TRUE(LNLibEx::LNTessellation::Tessellate(bump, options, mesh));
+    EXPECT_TRUE(mesh.UVIndices.size() == 3 * mesh.Faces.size());
+    for (const auto& face : mesh.Faces) {
+        LNLib::XYZ center = (mesh.Vertices[face[0]] + mesh.Vertices[face[1]] + mesh.Vertices[face[2]]) / 3.0;
+        LNLib::UV uv = (mesh.UVs[face[0]] + mesh.UVs[face[1]] + mesh.UVs[face[2]]) / 3.0;
+        EXPECT_TRUE(center.Distance(LNLib::NurbsSurface::GetPointOnSurface(bump, uv)) < 2 * options.ChordalTolerance);
+    }
+
+    size_t coarseCount = mesh.Faces.size();
+    options.ChordalTolerance = 1E-5;
+    EXPECT_TRUE(LNLibEx::LNTessellation::Tessellate(bump, options, mesh));
+    EXPECT_TRUE(mesh.Faces.size() > coarseCount);
+}
+
+TEST(Test_LNTessellation, Watertight)
+{
+    LNLibEx::LNTessellationOptions options;
+    options.Mode = LNLibEx::TessellationMode::Adaptive;
+    options.ChordalTolerance = 1E-3;
+
+    // Neighbours with different curvature are refined differently along their shared boundaries.
+    std::vector<LNLib::LN_NurbsSurface> surfaces = { createBumpSurface(0.0), createBumpSurface(2.0), createBumpSurface(4.0) };
+    surfaces[1].ControlPoints[1][1][2] = 4.0;
+    surfaces[2].ControlPoints[1][1][2] = 0.0;
+
+    LNLib::LN_Mesh mesh;
+    LNLibEx::LNTessellationReport report;
+    EXPECT_TRUE(LNLibEx::LNTessellation::TessellateWatertight(surfaces, options, mesh, report));
+    EXPECT_TRUE(report.FaceOffsets.back() == static_cast<int>(mesh.Faces.size()));
+    EXPECT_TRUE(mesh.UVIndices.size() == 3 * mesh.Faces.size());
+
+    std::map<std::pair<int, int>, int> edges;
+    for (const auto& face : mesh.Faces) {
+        for (int k = 0; k < 3; k++) {
+            edges[{ face[k], face[(k + 1) % 3] }]++;
+        }
+    }
+    for (const auto& edge : edges) {
+        EXPECT_TRUE(edge.second == 1);
+        if (edges.count({ edge.first.second, edge.first.first }) == 0) {
+            const LNLib::XYZ& a = mesh.Vertices[edge.first.first];
+            const LNLib::XYZ& b = mesh.Vertices[edge.first.second];
+            bool isOuter = (std::fabs(a.GetX()) < 1E-9 && std::fabs(b.GetX()) < 1E-9) ||
+                (std::fabs(a.GetX() - 6.0) < 1E-9 && std::fabs(b.GetX() - 6.0) < 1E-9) ||
+                (std::fabs(a.GetY()) < 1E-9 && std::fabs(b.GetY()) < 1E-9) ||
+                (std::fabs(a.GetY() - 2.0) < 1E-9 && std::fabs(b.GetY() - 2.0) < 1E-9);
+            EXPECT_TRUE(isOuter);
+        }
+    }
+
+    // Without tolerance only coincident corners weld, the shared corners of the neighbours still are.
+    options.WeldTolerance = 0.0;
+    LNLib::LN_Mesh exact;
+    EXPECT_TRUE(LNLibEx::LNTessellation::TessellateWatertight(surfaces, options, exact, report));
+    EXPECT_TRUE(exact.Vertices.size() == mesh.Vertices.size() && exact.Faces.size() == mesh.Faces.size());
+}